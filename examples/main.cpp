@@ -371,8 +371,17 @@ namespace plume {
 }
 
 std::unique_ptr<plume::RenderInterface> CreateRenderInterface(std::string &apiName) {
+#if defined(PLUME_SINGLE_BACKEND_VULKAN)
+    apiName = "Vulkan";
+    return plume::CreateVulkanInterface();
+#elif defined(PLUME_SINGLE_BACKEND_D3D12)
+    apiName = "D3D12";
+    return plume::CreateD3D12Interface();
+#elif defined(PLUME_SINGLE_BACKEND_METAL)
+    apiName = "Metal";
+    return plume::CreateMetalInterface();
+#elif defined(_WIN32)
     const bool useVulkan = false;
-#if defined(_WIN32)
     if (useVulkan) {
         apiName = "Vulkan";
         return plume::CreateVulkanInterface();
@@ -382,6 +391,7 @@ std::unique_ptr<plume::RenderInterface> CreateRenderInterface(std::string &apiNa
         return plume::CreateD3D12Interface();
     }
 #elif defined(__APPLE__)
+    const bool useVulkan = false;
     if (useVulkan) {
         apiName = "Vulkan";
         return plume::CreateVulkanInterface();
@@ -0,0 +1,302 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace plume {
+    // Interface for the memory used internally by plume. Only the scratch memory used while translating commands goes through it.
+    struct RenderAllocator {
+        virtual ~RenderAllocator() { }
+        virtual void *allocate(size_t size, size_t alignment) = 0;
+        virtual void free(void *ptr, size_t size, size_t alignment) = 0;
+    };
+
+    struct RenderDefaultAllocator : RenderAllocator {
+        void *allocate(size_t size, size_t alignment) override {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+
+        void free(void *ptr, size_t, size_t alignment) override {
+            ::operator delete(ptr, std::align_val_t(alignment));
+        }
+    };
+
+    struct RenderAllocatorStats {
+        uint64_t allocationCount = 0;
+        uint64_t freeCount = 0;
+        uint64_t allocatedBytes = 0;
+    };
+
+    struct RenderAllocatorState {
+        RenderDefaultAllocator defaultAllocator;
+        std::atomic<RenderAllocator *> allocator = &defaultAllocator;
+        std::atomic<uint64_t> allocationCount = 0;
+        std::atomic<uint64_t> freeCount = 0;
+        std::atomic<uint64_t> allocatedBytes = 0;
+
+        static RenderAllocatorState &get() {
+            static RenderAllocatorState state;
+            return state;
+        }
+    };
+
+    // Must be set before any device is created and the allocator must outlive every thread that records commands. Null restores the default allocator.
+    inline void RenderSetAllocator(RenderAllocator *allocator) {
+        RenderAllocatorState &state = RenderAllocatorState::get();
+        state.allocator = (allocator != nullptr) ? allocator : &state.defaultAllocator;
+    }
+
+    // Counts every allocation made through the allocator. Steady state frames shouldn't change the allocation count once the scratch arenas have grown to their working size.
+    inline RenderAllocatorStats RenderGetAllocatorStats() {
+        RenderAllocatorState &state = RenderAllocatorState::get();
+        RenderAllocatorStats stats;
+        stats.allocationCount = state.allocationCount.load();
+        stats.freeCount = state.freeCount.load();
+        stats.allocatedBytes = state.allocatedBytes.load();
+        return stats;
+    }
+
+    inline void *RenderAllocate(size_t size, size_t alignment) {
+        RenderAllocatorState &state = RenderAllocatorState::get();
+        state.allocationCount++;
+        state.allocatedBytes += size;
+        return state.allocator.load()->allocate(size, alignment);
+    }
+
+    inline void RenderFree(void *ptr, size_t size, size_t alignment) {
+        RenderAllocatorState &state = RenderAllocatorState::get();
+        state.freeCount++;
+        state.allocatedBytes -= size;
+        state.allocator.load()->free(ptr, size, alignment);
+    }
+
+    // Per-thread linear arena for the temporary arrays built while translating commands. Memory is released in the reverse order it
+    // was allocated by RenderScratchScope, so nested translations on the same thread don't overwrite each other. The blocks are kept
+    // until the thread exits or trim() is called, so a thread stops allocating once the arena has grown to the size a frame requires.
+    // Once every block is in use, allocations fall back to the allocator and are released when the scope that made them ends.
+    struct RenderScratchArena {
+        static constexpr size_t DefaultBlockSize = 64 * 1024;
+        static constexpr size_t BlockAlignment = 16;
+        static constexpr uint32_t MaxBlocks = 32;
+
+        struct Block {
+            uint8_t *data = nullptr;
+            size_t capacity = 0;
+        };
+
+        Block blocks[MaxBlocks];
+        uint32_t blockCount = 0;
+        uint32_t blockIndex = 0;
+        size_t blockOffset = 0;
+        std::vector<Block> overflowBlocks;
+
+        ~RenderScratchArena() {
+            releaseOverflow(0);
+            trim();
+            if (blockCount > 0) {
+                RenderFree(blocks[0].data, blocks[0].capacity, BlockAlignment);
+            }
+        }
+
+        static RenderScratchArena &get() {
+            thread_local RenderScratchArena arena;
+            return arena;
+        }
+
+        void *allocate(size_t size, size_t alignment) {
+            assert((alignment <= BlockAlignment) && "Alignment is not supported.");
+
+            while (true) {
+                if (blockIndex < blockCount) {
+                    const Block &block = blocks[blockIndex];
+                    const size_t alignedOffset = (blockOffset + alignment - 1) & ~(alignment - 1);
+                    if ((alignedOffset + size) <= block.capacity) {
+                        blockOffset = alignedOffset + size;
+                        return block.data + alignedOffset;
+                    }
+
+                    // Move on to the next block or allocate a new one if there's no block left.
+                    if ((blockIndex + 1) < blockCount) {
+                        blockIndex++;
+                        blockOffset = 0;
+                        continue;
+                    }
+                }
+
+                if (blockCount == MaxBlocks) {
+                    Block overflowBlock;
+                    overflowBlock.data = reinterpret_cast<uint8_t *>(RenderAllocate(size, BlockAlignment));
+                    overflowBlock.capacity = size;
+                    overflowBlocks.emplace_back(overflowBlock);
+                    return overflowBlock.data;
+                }
+
+                const size_t capacity = std::max(DefaultBlockSize, size);
+                Block &block = blocks[blockCount];
+                block.data = reinterpret_cast<uint8_t *>(RenderAllocate(capacity, BlockAlignment));
+                block.capacity = capacity;
+                blockIndex = blockCount;
+                blockOffset = 0;
+                blockCount++;
+            }
+        }
+
+        // Releases the overflow allocations made after the first ones specified by the count.
+        void releaseOverflow(size_t count) {
+            while (overflowBlocks.size() > count) {
+                const Block &block = overflowBlocks.back();
+                RenderFree(block.data, block.capacity, BlockAlignment);
+                overflowBlocks.pop_back();
+            }
+        }
+
+        // Releases every block except for the first one. Only valid when no scope is active on the thread.
+        void trim() {
+            assert((blockIndex == 0) && (blockOffset == 0) && "Arena can't be trimmed while it's in use.");
+            for (uint32_t i = 1; i < blockCount; i++) {
+                RenderFree(blocks[i].data, blocks[i].capacity, BlockAlignment);
+                blocks[i] = Block();
+            }
+
+            blockCount = std::min(blockCount, 1U);
+        }
+    };
+
+    // Releases all the scratch memory allocated on the thread since the scope was created.
+    struct RenderScratchScope {
+        RenderScratchArena &arena;
+        uint32_t blockIndex;
+        size_t blockOffset;
+        size_t overflowCount;
+
+        RenderScratchScope() : arena(RenderScratchArena::get()) {
+            blockIndex = arena.blockIndex;
+            blockOffset = arena.blockOffset;
+            overflowCount = arena.overflowBlocks.size();
+        }
+
+        ~RenderScratchScope() {
+            arena.releaseOverflow(overflowCount);
+            arena.blockIndex = blockIndex;
+            arena.blockOffset = blockOffset;
+        }
+
+        RenderScratchScope(const RenderScratchScope &) = delete;
+        RenderScratchScope &operator=(const RenderScratchScope &) = delete;
+    };
+
+    // Growable array allocated from the scratch arena of the thread. It must not outlive the innermost RenderScratchScope that was active when it allocated.
+    template<typename T>
+    struct RenderScratchArray {
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value, "Scratch arrays only support trivial types.");
+
+        T *values = nullptr;
+        uint32_t count = 0;
+        uint32_t capacity = 0;
+
+        RenderScratchArray() = default;
+
+        RenderScratchArray(uint32_t capacity) {
+            reserve(capacity);
+        }
+
+        RenderScratchArray(const RenderScratchArray &) = delete;
+        RenderScratchArray &operator=(const RenderScratchArray &) = delete;
+
+        void reserve(uint32_t newCapacity) {
+            if (newCapacity <= capacity) {
+                return;
+            }
+
+            // The previous storage is only released when the scope ends.
+            T *newValues = reinterpret_cast<T *>(RenderScratchArena::get().allocate(sizeof(T) * newCapacity, alignof(T)));
+            if (count > 0) {
+                memcpy(newValues, values, sizeof(T) * count);
+            }
+
+            values = newValues;
+            capacity = newCapacity;
+        }
+
+        T &emplace_back(const T &value) {
+            if (count == capacity) {
+                reserve(std::max(capacity * 2, 16U));
+            }
+
+            values[count] = value;
+            return values[count++];
+        }
+
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+
+        void resize(uint32_t newCount) {
+            reserve(newCount);
+            for (uint32_t i = count; i < newCount; i++) {
+                values[i] = T{};
+            }
+
+            count = newCount;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        T *data() {
+            return values;
+        }
+
+        const T *data() const {
+            return values;
+        }
+
+        uint32_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        T *begin() {
+            return values;
+        }
+
+        T *end() {
+            return values + count;
+        }
+
+        const T *begin() const {
+            return values;
+        }
+
+        const T *end() const {
+            return values + count;
+        }
+
+        T &operator[](uint32_t index) {
+            assert(index < count);
+            return values[index];
+        }
+
+        const T &operator[](uint32_t index) const {
+            assert(index < count);
+            return values[index];
+        }
+    };
+};
@@ -0,0 +1,553 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#include "plume_bc_encoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define PLUME_BC_ENCODER_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#   define PLUME_BC_ENCODER_NEON
+#   include <arm_neon.h>
+#endif
+
+namespace plume {
+    // Blocks smaller than this amount are not worth the cost of spawning threads.
+    static const uint32_t MinBlocksPerThread = 256;
+
+    // Nearest BC7 4-bit index for every interpolation weight between 0 and 64.
+    static const uint8_t BC7WeightIndexTable[65] = {
+        0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 6, 7, 7, 7, 7,
+        8, 8, 8, 8, 9, 9, 9, 9, 10, 10, 10, 10, 10, 11, 11, 11, 11, 12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 14, 15, 15
+    };
+
+    struct BlockBitWriter {
+        uint64_t bits[2] = {};
+        uint32_t position = 0;
+
+        void write(uint32_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; i++) {
+                const uint32_t bitPosition = position + i;
+                bits[bitPosition >> 6] |= uint64_t((value >> i) & 1U) << (bitPosition & 63U);
+            }
+
+            position += count;
+        }
+
+        void store(uint8_t *dst) const {
+            for (uint32_t i = 0; i < 16; i++) {
+                dst[i] = uint8_t(bits[i >> 3] >> ((i & 7U) * 8U));
+            }
+        }
+    };
+
+    static void loadBlock(const uint8_t *srcData, uint32_t srcRowPitch, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t pixels[64]) {
+        // Edge blocks replicate the last row and column so the padding doesn't affect the endpoints.
+        const uint32_t x = blockX * 4;
+        for (uint32_t i = 0; i < 4; i++) {
+            const uint32_t y = std::min(blockY * 4 + i, height - 1);
+            const uint8_t *srcRow = srcData + uint64_t(y) * srcRowPitch;
+            if ((x + 4) <= width) {
+                memcpy(&pixels[i * 16], &srcRow[x * 4], 16);
+            }
+            else {
+                for (uint32_t j = 0; j < 4; j++) {
+                    memcpy(&pixels[i * 16 + j * 4], &srcRow[std::min(x + j, width - 1) * 4], 4);
+                }
+            }
+        }
+    }
+
+    static void blockMinMax(const uint8_t pixels[64], uint8_t minColor[4], uint8_t maxColor[4]) {
+#   if defined(PLUME_BC_ENCODER_SSE2)
+        const __m128i *rows = reinterpret_cast<const __m128i *>(pixels);
+        const __m128i row0 = _mm_loadu_si128(rows + 0);
+        const __m128i row1 = _mm_loadu_si128(rows + 1);
+        const __m128i row2 = _mm_loadu_si128(rows + 2);
+        const __m128i row3 = _mm_loadu_si128(rows + 3);
+        __m128i minVector = _mm_min_epu8(_mm_min_epu8(row0, row1), _mm_min_epu8(row2, row3));
+        __m128i maxVector = _mm_max_epu8(_mm_max_epu8(row0, row1), _mm_max_epu8(row2, row3));
+
+        // Reduce the four pixels left in each register.
+        minVector = _mm_min_epu8(minVector, _mm_shuffle_epi32(minVector, _MM_SHUFFLE(1, 0, 3, 2)));
+        minVector = _mm_min_epu8(minVector, _mm_shuffle_epi32(minVector, _MM_SHUFFLE(2, 3, 0, 1)));
+        maxVector = _mm_max_epu8(maxVector, _mm_shuffle_epi32(maxVector, _MM_SHUFFLE(1, 0, 3, 2)));
+        maxVector = _mm_max_epu8(maxVector, _mm_shuffle_epi32(maxVector, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        const uint32_t minPacked = uint32_t(_mm_cvtsi128_si32(minVector));
+        const uint32_t maxPacked = uint32_t(_mm_cvtsi128_si32(maxVector));
+        memcpy(minColor, &minPacked, 4);
+        memcpy(maxColor, &maxPacked, 4);
+#   elif defined(PLUME_BC_ENCODER_NEON)
+        const uint8x16_t row0 = vld1q_u8(pixels + 0);
+        const uint8x16_t row1 = vld1q_u8(pixels + 16);
+        const uint8x16_t row2 = vld1q_u8(pixels + 32);
+        const uint8x16_t row3 = vld1q_u8(pixels + 48);
+        uint8x16_t minVector = vminq_u8(vminq_u8(row0, row1), vminq_u8(row2, row3));
+        uint8x16_t maxVector = vmaxq_u8(vmaxq_u8(row0, row1), vmaxq_u8(row2, row3));
+
+        // Reduce the four pixels left in each register.
+        uint32x4_t minWords = vreinterpretq_u32_u8(minVector);
+        uint32x4_t maxWords = vreinterpretq_u32_u8(maxVector);
+        minVector = vminq_u8(minVector, vreinterpretq_u8_u32(vextq_u32(minWords, minWords, 2)));
+        maxVector = vmaxq_u8(maxVector, vreinterpretq_u8_u32(vextq_u32(maxWords, maxWords, 2)));
+        minWords = vreinterpretq_u32_u8(minVector);
+        maxWords = vreinterpretq_u32_u8(maxVector);
+        minVector = vminq_u8(minVector, vreinterpretq_u8_u32(vextq_u32(minWords, minWords, 1)));
+        maxVector = vmaxq_u8(maxVector, vreinterpretq_u8_u32(vextq_u32(maxWords, maxWords, 1)));
+
+        const uint32_t minPacked = vgetq_lane_u32(vreinterpretq_u32_u8(minVector), 0);
+        const uint32_t maxPacked = vgetq_lane_u32(vreinterpretq_u32_u8(maxVector), 0);
+        memcpy(minColor, &minPacked, 4);
+        memcpy(maxColor, &maxPacked, 4);
+#   else
+        for (uint32_t c = 0; c < 4; c++) {
+            minColor[c] = 255;
+            maxColor[c] = 0;
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            for (uint32_t c = 0; c < 4; c++) {
+                minColor[c] = std::min(minColor[c], pixels[i * 4 + c]);
+                maxColor[c] = std::max(maxColor[c], pixels[i * 4 + c]);
+            }
+        }
+#   endif
+    }
+
+    // Computes the dot product between every pixel and the direction.
+    static void blockDots(const uint8_t pixels[64], const int16_t direction[4], int32_t dots[16]) {
+#   if defined(PLUME_BC_ENCODER_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i directionVector = _mm_set_epi16(direction[3], direction[2], direction[1], direction[0], direction[3], direction[2], direction[1], direction[0]);
+        const __m128i *rows = reinterpret_cast<const __m128i *>(pixels);
+        for (uint32_t i = 0; i < 4; i++) {
+            const __m128i row = _mm_loadu_si128(rows + i);
+            const __m128i productsLow = _mm_madd_epi16(_mm_unpacklo_epi8(row, zero), directionVector);
+            const __m128i productsHigh = _mm_madd_epi16(_mm_unpackhi_epi8(row, zero), directionVector);
+            const __m128 productsLowFloat = _mm_castsi128_ps(productsLow);
+            const __m128 productsHighFloat = _mm_castsi128_ps(productsHigh);
+            const __m128i sumsRG = _mm_castps_si128(_mm_shuffle_ps(productsLowFloat, productsHighFloat, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128i sumsBA = _mm_castps_si128(_mm_shuffle_ps(productsLowFloat, productsHighFloat, _MM_SHUFFLE(3, 1, 3, 1)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dots + i * 4), _mm_add_epi32(sumsRG, sumsBA));
+        }
+#   elif defined(PLUME_BC_ENCODER_NEON)
+        const int16x4_t directionVector = vld1_s16(direction);
+        for (uint32_t i = 0; i < 4; i++) {
+            const uint8x16_t row = vld1q_u8(pixels + i * 16);
+            const int16x8_t pixelsLow = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(row)));
+            const int16x8_t pixelsHigh = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(row)));
+            const int32x4_t products0 = vmull_s16(vget_low_s16(pixelsLow), directionVector);
+            const int32x4_t products1 = vmull_s16(vget_high_s16(pixelsLow), directionVector);
+            const int32x4_t products2 = vmull_s16(vget_low_s16(pixelsHigh), directionVector);
+            const int32x4_t products3 = vmull_s16(vget_high_s16(pixelsHigh), directionVector);
+            const int32x2_t sums01 = vpadd_s32(vpadd_s32(vget_low_s32(products0), vget_high_s32(products0)), vpadd_s32(vget_low_s32(products1), vget_high_s32(products1)));
+            const int32x2_t sums23 = vpadd_s32(vpadd_s32(vget_low_s32(products2), vget_high_s32(products2)), vpadd_s32(vget_low_s32(products3), vget_high_s32(products3)));
+            vst1q_s32(dots + i * 4, vcombine_s32(sums01, sums23));
+        }
+#   else
+        for (uint32_t i = 0; i < 16; i++) {
+            const uint8_t *pixel = &pixels[i * 4];
+            dots[i] = pixel[0] * direction[0] + pixel[1] * direction[1] + pixel[2] * direction[2] + pixel[3] * direction[3];
+        }
+#   endif
+    }
+
+    // Picks the diagonal of the bounding box that follows the distribution of the pixels by flipping the channels that are
+    // negatively correlated with the channel of the largest range. The bounds are inset to reduce the error on the extremes.
+    static void selectEndpoints(const uint8_t pixels[64], uint32_t channelCount, const uint8_t minColor[4], const uint8_t maxColor[4], int32_t insetShift, int32_t endpoint0[4], int32_t endpoint1[4]) {
+        int32_t center[4] = {};
+        uint32_t majorChannel = 0;
+        for (uint32_t c = 0; c < channelCount; c++) {
+            const int32_t inset = (maxColor[c] - minColor[c]) >> insetShift;
+            endpoint0[c] = minColor[c] + inset;
+            endpoint1[c] = maxColor[c] - inset;
+            center[c] = (minColor[c] + maxColor[c] + 1) >> 1;
+            if ((maxColor[c] - minColor[c]) > (maxColor[majorChannel] - minColor[majorChannel])) {
+                majorChannel = c;
+            }
+        }
+
+        for (uint32_t c = 0; c < channelCount; c++) {
+            if (c == majorChannel) {
+                continue;
+            }
+
+            int32_t covariance = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                covariance += (pixels[i * 4 + majorChannel] - center[majorChannel]) * (pixels[i * 4 + c] - center[c]);
+            }
+
+            if (covariance < 0) {
+                std::swap(endpoint0[c], endpoint1[c]);
+            }
+        }
+    }
+
+    static uint16_t packRGB565(const int32_t color[3]) {
+        const uint32_t r = uint32_t(std::clamp(color[0], 0, 255) * 31 + 127) / 255;
+        const uint32_t g = uint32_t(std::clamp(color[1], 0, 255) * 63 + 127) / 255;
+        const uint32_t b = uint32_t(std::clamp(color[2], 0, 255) * 31 + 127) / 255;
+        return uint16_t((r << 11) | (g << 5) | b);
+    }
+
+    static void unpackRGB565(uint16_t packed, int16_t color[4]) {
+        const uint32_t r = (packed >> 11) & 0x1FU;
+        const uint32_t g = (packed >> 5) & 0x3FU;
+        const uint32_t b = packed & 0x1FU;
+        color[0] = int16_t((r << 3) | (r >> 2));
+        color[1] = int16_t((g << 2) | (g >> 4));
+        color[2] = int16_t((b << 3) | (b >> 2));
+        color[3] = 0;
+    }
+
+    // Quantizes the position of every pixel along the segment into the amount of steps specified.
+    static void projectIndices(const uint8_t pixels[64], const int16_t color0[4], const int16_t color1[4], int32_t steps, int32_t levels[16]) {
+        const int16_t direction[4] = { int16_t(color1[0] - color0[0]), int16_t(color1[1] - color0[1]), int16_t(color1[2] - color0[2]), int16_t(color1[3] - color0[3]) };
+        const int32_t start = color0[0] * direction[0] + color0[1] * direction[1] + color0[2] * direction[2] + color0[3] * direction[3];
+        const int32_t length = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2] + direction[3] * direction[3];
+        if (length <= 0) {
+            for (uint32_t i = 0; i < 16; i++) {
+                levels[i] = 0;
+            }
+
+            return;
+        }
+
+        int32_t dots[16];
+        blockDots(pixels, direction, dots);
+        for (uint32_t i = 0; i < 16; i++) {
+            const int64_t offset = std::max(int64_t(dots[i]) - start, int64_t(0));
+            levels[i] = int32_t(std::min((offset * steps * 2 + length) / (int64_t(length) * 2), int64_t(steps)));
+        }
+    }
+
+    static void encodeColorBlock(const uint8_t pixels[64], const uint8_t minColor[4], const uint8_t maxColor[4], bool allowTransparency, uint8_t *dst) {
+        bool transparent = false;
+        if (allowTransparency) {
+            for (uint32_t i = 0; (i < 16) && !transparent; i++) {
+                transparent = (pixels[i * 4 + 3] < 128);
+            }
+        }
+
+        int32_t endpoint0[4];
+        int32_t endpoint1[4];
+        uint8_t opaqueMin[4] = { 255, 255, 255, 255 };
+        uint8_t opaqueMax[4] = { 0, 0, 0, 0 };
+        bool anyOpaque = !transparent;
+        if (transparent) {
+            // Only the opaque pixels contribute to the endpoints when punch-through alpha is used.
+            for (uint32_t i = 0; i < 16; i++) {
+                if (pixels[i * 4 + 3] >= 128) {
+                    for (uint32_t c = 0; c < 3; c++) {
+                        opaqueMin[c] = std::min(opaqueMin[c], pixels[i * 4 + c]);
+                        opaqueMax[c] = std::max(opaqueMax[c], pixels[i * 4 + c]);
+                    }
+
+                    anyOpaque = true;
+                }
+            }
+
+            if (anyOpaque) {
+                selectEndpoints(pixels, 3, opaqueMin, opaqueMax, 4, endpoint0, endpoint1);
+            }
+        }
+        else {
+            selectEndpoints(pixels, 3, minColor, maxColor, 4, endpoint0, endpoint1);
+        }
+
+        uint16_t packed0 = anyOpaque ? packRGB565(endpoint0) : 0;
+        uint16_t packed1 = anyOpaque ? packRGB565(endpoint1) : 0;
+
+        // Four color blocks require the first endpoint to be greater, while three color blocks with transparency require the opposite.
+        if (transparent ? (packed0 > packed1) : (packed0 < packed1)) {
+            std::swap(packed0, packed1);
+        }
+
+        int16_t color0[4];
+        int16_t color1[4];
+        unpackRGB565(packed0, color0);
+        unpackRGB565(packed1, color1);
+
+        int32_t levels[16];
+        uint32_t indices = 0;
+        if (transparent) {
+            const uint32_t levelIndices[3] = { 0, 2, 1 };
+            projectIndices(pixels, color0, color1, 2, levels);
+            for (uint32_t i = 0; i < 16; i++) {
+                const uint32_t index = (pixels[i * 4 + 3] < 128) ? 3 : levelIndices[levels[i]];
+                indices |= index << (i * 2);
+            }
+        }
+        else if (packed0 != packed1) {
+            const uint32_t levelIndices[4] = { 0, 2, 3, 1 };
+            projectIndices(pixels, color0, color1, 3, levels);
+            for (uint32_t i = 0; i < 16; i++) {
+                indices |= levelIndices[levels[i]] << (i * 2);
+            }
+        }
+
+        dst[0] = uint8_t(packed0);
+        dst[1] = uint8_t(packed0 >> 8);
+        dst[2] = uint8_t(packed1);
+        dst[3] = uint8_t(packed1 >> 8);
+        dst[4] = uint8_t(indices);
+        dst[5] = uint8_t(indices >> 8);
+        dst[6] = uint8_t(indices >> 16);
+        dst[7] = uint8_t(indices >> 24);
+    }
+
+    static void encodeChannelBlock(const uint8_t pixels[64], uint32_t channel, uint8_t minValue, uint8_t maxValue, uint8_t *dst) {
+        // Uses the eight value interpolation mode, which requires the first endpoint to be greater.
+        uint64_t indices = 0;
+        const int32_t range = maxValue - minValue;
+        if (range > 0) {
+            for (uint32_t i = 0; i < 16; i++) {
+                const int32_t level = ((pixels[i * 4 + channel] - minValue) * 14 + range) / (range * 2);
+                const uint64_t index = (level == 7) ? 0 : ((level == 0) ? 1 : (8 - level));
+                indices |= index << (i * 3);
+            }
+        }
+
+        dst[0] = maxValue;
+        dst[1] = minValue;
+        for (uint32_t i = 0; i < 6; i++) {
+            dst[2 + i] = uint8_t(indices >> (i * 8));
+        }
+    }
+
+    static void quantizeBC7Endpoint(const int32_t endpoint[4], uint32_t quantized[4], uint32_t &pBit) {
+        // Pick the parity bit shared by all the channels that results in the least amount of error.
+        uint32_t bestError = UINT32_MAX;
+        for (uint32_t p = 0; p < 2; p++) {
+            uint32_t error = 0;
+            uint32_t candidate[4];
+            for (uint32_t c = 0; c < 4; c++) {
+                candidate[c] = uint32_t(std::clamp((endpoint[c] - int32_t(p) + 1) >> 1, 0, 127));
+                error += uint32_t(std::abs(int32_t((candidate[c] << 1) | p) - endpoint[c]));
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                pBit = p;
+                memcpy(quantized, candidate, sizeof(candidate));
+            }
+        }
+    }
+
+    static void encodeBC7Block(const uint8_t pixels[64], const uint8_t minColor[4], const uint8_t maxColor[4], uint8_t *dst) {
+        // Mode 6 only: a single subset with RGBA endpoints of seven bits plus a parity bit and four bit indices.
+        int32_t endpoint0[4];
+        int32_t endpoint1[4];
+        selectEndpoints(pixels, 4, minColor, maxColor, 5, endpoint0, endpoint1);
+
+        uint32_t quantized0[4];
+        uint32_t quantized1[4];
+        uint32_t pBit0 = 0;
+        uint32_t pBit1 = 0;
+        quantizeBC7Endpoint(endpoint0, quantized0, pBit0);
+        quantizeBC7Endpoint(endpoint1, quantized1, pBit1);
+
+        int16_t color0[4];
+        int16_t color1[4];
+        for (uint32_t c = 0; c < 4; c++) {
+            color0[c] = int16_t((quantized0[c] << 1) | pBit0);
+            color1[c] = int16_t((quantized1[c] << 1) | pBit1);
+        }
+
+        int32_t levels[16];
+        uint32_t indices[16];
+        projectIndices(pixels, color0, color1, 64, levels);
+        for (uint32_t i = 0; i < 16; i++) {
+            indices[i] = BC7WeightIndexTable[levels[i]];
+        }
+
+        // The most significant bit of the anchor index is implicit, so swap the endpoints if it's set.
+        if (indices[0] & 0x8U) {
+            std::swap(quantized0, quantized1);
+            std::swap(pBit0, pBit1);
+            for (uint32_t i = 0; i < 16; i++) {
+                indices[i] = 15U - indices[i];
+            }
+        }
+
+        BlockBitWriter writer;
+        writer.write(1U << 6U, 7);
+        for (uint32_t c = 0; c < 4; c++) {
+            writer.write(quantized0[c], 7);
+            writer.write(quantized1[c], 7);
+        }
+
+        writer.write(pBit0, 1);
+        writer.write(pBit1, 1);
+        writer.write(indices[0], 3);
+        for (uint32_t i = 1; i < 16; i++) {
+            writer.write(indices[i], 4);
+        }
+
+        writer.store(dst);
+    }
+
+    static void encodeBlock(RenderFormat format, const uint8_t pixels[64], uint8_t *dst) {
+        uint8_t minColor[4];
+        uint8_t maxColor[4];
+        blockMinMax(pixels, minColor, maxColor);
+
+        switch (format) {
+        case RenderFormat::BC1_TYPELESS:
+        case RenderFormat::BC1_UNORM:
+        case RenderFormat::BC1_UNORM_SRGB:
+            encodeColorBlock(pixels, minColor, maxColor, true, dst);
+            break;
+        case RenderFormat::BC3_TYPELESS:
+        case RenderFormat::BC3_UNORM:
+        case RenderFormat::BC3_UNORM_SRGB:
+            encodeChannelBlock(pixels, 3, minColor[3], maxColor[3], dst);
+            encodeColorBlock(pixels, minColor, maxColor, false, dst + 8);
+            break;
+        case RenderFormat::BC4_TYPELESS:
+        case RenderFormat::BC4_UNORM:
+            encodeChannelBlock(pixels, 0, minColor[0], maxColor[0], dst);
+            break;
+        case RenderFormat::BC5_TYPELESS:
+        case RenderFormat::BC5_UNORM:
+            encodeChannelBlock(pixels, 0, minColor[0], maxColor[0], dst);
+            encodeChannelBlock(pixels, 1, minColor[1], maxColor[1], dst + 8);
+            break;
+        case RenderFormat::BC7_TYPELESS:
+        case RenderFormat::BC7_UNORM:
+        case RenderFormat::BC7_UNORM_SRGB:
+            encodeBC7Block(pixels, minColor, maxColor, dst);
+            break;
+        default:
+            assert(false && "Unsupported block compression format.");
+            break;
+        }
+    }
+
+    static uint32_t toBlockSize(RenderFormat format) {
+        switch (format) {
+        case RenderFormat::BC1_TYPELESS:
+        case RenderFormat::BC1_UNORM:
+        case RenderFormat::BC1_UNORM_SRGB:
+        case RenderFormat::BC4_TYPELESS:
+        case RenderFormat::BC4_UNORM:
+            return 8;
+        case RenderFormat::BC3_TYPELESS:
+        case RenderFormat::BC3_UNORM:
+        case RenderFormat::BC3_UNORM_SRGB:
+        case RenderFormat::BC5_TYPELESS:
+        case RenderFormat::BC5_UNORM:
+        case RenderFormat::BC7_TYPELESS:
+        case RenderFormat::BC7_UNORM:
+        case RenderFormat::BC7_UNORM_SRGB:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    // Global functions.
+
+    bool RenderBlockCompressionSupported(RenderFormat format) {
+        return toBlockSize(format) > 0;
+    }
+
+    RenderBlockCompressionFootprint RenderBlockCompressionGetFootprint(RenderFormat format, uint32_t width, uint32_t height, uint32_t rowPitchAlignment) {
+        assert(RenderBlockCompressionSupported(format) && "Unsupported block compression format.");
+        assert((rowPitchAlignment > 0) && ((rowPitchAlignment & (rowPitchAlignment - 1)) == 0) && "Row pitch alignment must be a power of two.");
+
+        const uint32_t blockSize = toBlockSize(format);
+        const uint32_t horizontalBlocks = (width + 3) / 4;
+        RenderBlockCompressionFootprint footprint;
+        footprint.rowPitch = ((horizontalBlocks * blockSize) + rowPitchAlignment - 1) & ~(rowPitchAlignment - 1);
+        footprint.rowWidth = (footprint.rowPitch / blockSize) * 4;
+        footprint.rowCount = (height + 3) / 4;
+        footprint.size = uint64_t(footprint.rowPitch) * footprint.rowCount;
+        return footprint;
+    }
+
+    void RenderBlockCompress(const RenderBlockCompressionDesc &desc) {
+        assert(RenderBlockCompressionSupported(desc.format) && "Unsupported block compression format.");
+        assert(desc.srcData != nullptr);
+        assert(desc.dstData != nullptr);
+        assert((desc.width > 0) && (desc.height > 0));
+
+        const uint32_t blockSize = toBlockSize(desc.format);
+        const uint32_t horizontalBlocks = (desc.width + 3) / 4;
+        const uint32_t verticalBlocks = (desc.height + 3) / 4;
+        assert((desc.srcRowPitch >= (desc.width * 4)) && "Source row pitch is too small.");
+        assert((desc.dstRowPitch >= (horizontalBlocks * blockSize)) && "Destination row pitch is too small.");
+
+        const uint8_t *srcData = reinterpret_cast<const uint8_t *>(desc.srcData);
+        uint8_t *dstData = reinterpret_cast<uint8_t *>(desc.dstData);
+        auto encodeRows = [&](uint32_t rowBegin, uint32_t rowEnd) {
+            uint8_t pixels[64];
+            for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                uint8_t *dstRow = dstData + uint64_t(y) * desc.dstRowPitch;
+                for (uint32_t x = 0; x < horizontalBlocks; x++) {
+                    loadBlock(srcData, desc.srcRowPitch, desc.width, desc.height, x, y, pixels);
+                    encodeBlock(desc.format, pixels, dstRow + x * blockSize);
+                }
+            }
+        };
+
+        uint32_t threadCount = (desc.threadCount > 0) ? desc.threadCount : std::thread::hardware_concurrency();
+        threadCount = std::min(threadCount, (horizontalBlocks * verticalBlocks + MinBlocksPerThread - 1) / MinBlocksPerThread);
+        threadCount = std::clamp(threadCount, 1U, verticalBlocks);
+        if (threadCount == 1) {
+            encodeRows(0, verticalBlocks);
+            return;
+        }
+
+        // The calling thread encodes the last range of rows.
+        const uint32_t rowsPerThread = (verticalBlocks + threadCount - 1) / threadCount;
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        uint32_t rowBegin = 0;
+        for (uint32_t i = 0; (i < (threadCount - 1)) && ((rowBegin + rowsPerThread) < verticalBlocks); i++) {
+            threads.emplace_back(encodeRows, rowBegin, rowBegin + rowsPerThread);
+            rowBegin += rowsPerThread;
+        }
+
+        encodeRows(rowBegin, verticalBlocks);
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    RenderTextureCopyLocation RenderBlockCompressToBuffer(RenderBuffer *uploadBuffer, uint64_t offset, RenderFormat format, const void *srcData, uint32_t srcRowPitch, uint32_t width, uint32_t height, uint32_t threadCount) {
+        assert(uploadBuffer != nullptr);
+        assert(((offset % 512) == 0) && "Offset must be aligned to 512 bytes.");
+
+        const RenderBlockCompressionFootprint footprint = RenderBlockCompressionGetFootprint(format, width, height);
+        uint8_t *mappedData = reinterpret_cast<uint8_t *>(uploadBuffer->map());
+        assert(mappedData != nullptr);
+
+        RenderBlockCompressionDesc desc;
+        desc.format = format;
+        desc.srcData = srcData;
+        desc.srcRowPitch = srcRowPitch;
+        desc.width = width;
+        desc.height = height;
+        desc.dstData = mappedData + offset;
+        desc.dstRowPitch = footprint.rowPitch;
+        desc.threadCount = threadCount;
+        RenderBlockCompress(desc);
+
+        const RenderRange writtenRange(offset, offset + footprint.size);
+        uploadBuffer->unmap(0, &writtenRange);
+
+        return RenderTextureCopyLocation::PlacedFootprint(uploadBuffer, format, width, height, 1, footprint.rowWidth, offset);
+    }
+};
@@ -0,0 +1,50 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    struct RenderBlockCompressionFootprint {
+        // Width of a row in texels as expected by RenderTextureCopyLocation::PlacedFootprint.
+        uint32_t rowWidth = 0;
+        uint32_t rowPitch = 0;
+        uint32_t rowCount = 0;
+        uint64_t size = 0;
+    };
+
+    struct RenderBlockCompressionDesc {
+        RenderFormat format = RenderFormat::UNKNOWN;
+
+        // Source pixels must use four 8-bit channels in RGBA order. BC4 only reads the red channel and BC5 only reads the red and green channels.
+        const void *srcData = nullptr;
+        uint32_t srcRowPitch = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        // Each row of blocks is written at the specified pitch.
+        void *dstData = nullptr;
+        uint32_t dstRowPitch = 0;
+
+        // Rows of blocks are distributed across the threads. Zero uses all the hardware threads available.
+        uint32_t threadCount = 0;
+
+        RenderBlockCompressionDesc() = default;
+    };
+
+    // Supports BC1, BC3, BC4, BC5 and BC7. BC7 is only encoded with its single subset RGBA mode to favor speed over quality.
+    extern bool RenderBlockCompressionSupported(RenderFormat format);
+
+    // The default row pitch alignment satisfies the placed footprint requirements of all backends.
+    extern RenderBlockCompressionFootprint RenderBlockCompressionGetFootprint(RenderFormat format, uint32_t width, uint32_t height, uint32_t rowPitchAlignment = 256);
+    extern void RenderBlockCompress(const RenderBlockCompressionDesc &desc);
+
+    // Compresses directly into an upload buffer at the specified offset and returns the location to use as the source of copyTextureRegion.
+    // The offset must be aligned to 512 bytes and the buffer must have enough space for the footprint.
+    extern RenderTextureCopyLocation RenderBlockCompressToBuffer(RenderBuffer *uploadBuffer, uint64_t offset, RenderFormat format, const void *srcData, uint32_t srcRowPitch, uint32_t width, uint32_t height, uint32_t threadCount = 0);
+};
@@ -0,0 +1,343 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <mutex>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    // Descriptors of a single type stored in their own descriptor set as one boundless range at binding zero.
+    // Slots are handed out from a free list, and removed slots only become available again once the frame
+    // they were removed on comes around again, so descriptors still being read by the GPU are never overwritten.
+    // Writes are queued and applied in one pass on flush(), with repeated writes to the same slot collapsed.
+    struct RenderBindlessTable {
+        static constexpr uint32_t InvalidSlot = 0xFFFFFFFFU;
+
+        struct PendingWrite {
+            uint32_t slot = InvalidSlot;
+            const RenderBuffer *buffer = nullptr;
+            uint64_t bufferSize = 0;
+            RenderBufferStructuredView bufferStructuredView;
+            bool bufferStructuredViewSet = false;
+            const RenderBufferFormattedView *bufferFormattedView = nullptr;
+            const RenderTexture *texture = nullptr;
+            RenderTextureLayout textureLayout = RenderTextureLayout::UNKNOWN;
+            const RenderTextureView *textureView = nullptr;
+            const RenderSampler *sampler = nullptr;
+        };
+
+        RenderDescriptorRangeType type = RenderDescriptorRangeType::UNKNOWN;
+        uint32_t capacity = 0;
+        RenderDescriptorSetBuilder builder;
+        std::unique_ptr<RenderDescriptorSet> descriptorSet;
+        std::vector<uint32_t> freeSlots;
+        uint32_t usedSlotCount = 0;
+        std::vector<std::vector<uint32_t>> removedSlots;
+        std::vector<PendingWrite> pendingWrites;
+        std::vector<uint32_t> pendingWriteIndices;
+
+        RenderBindlessTable() = default;
+
+        void create(RenderDevice *device, RenderDescriptorRangeType type, uint32_t capacity, uint32_t frameCount) {
+            assert(device != nullptr);
+            assert(capacity > 0);
+            assert(frameCount > 0);
+
+            this->type = type;
+            this->capacity = capacity;
+            builder.begin();
+            builder.addRange(RenderDescriptorRange(type, 0, capacity));
+            builder.end(true, capacity);
+            descriptorSet = builder.create(device);
+            freeSlots.clear();
+            freeSlots.reserve(capacity);
+            usedSlotCount = 0;
+            removedSlots.clear();
+            removedSlots.resize(frameCount);
+            pendingWrites.clear();
+            pendingWriteIndices.assign(capacity, InvalidSlot);
+        }
+
+        void release() {
+            descriptorSet.reset();
+            freeSlots.clear();
+            usedSlotCount = 0;
+            removedSlots.clear();
+            pendingWrites.clear();
+            pendingWriteIndices.clear();
+            capacity = 0;
+        }
+
+        // Returns InvalidSlot when the table is full.
+        uint32_t allocate() {
+            if (!freeSlots.empty()) {
+                uint32_t slot = freeSlots.back();
+                freeSlots.pop_back();
+                return slot;
+            }
+            else if (usedSlotCount < capacity) {
+                return usedSlotCount++;
+            }
+            else {
+                return InvalidSlot;
+            }
+        }
+
+        void remove(uint32_t slot, uint32_t frameIndex) {
+            assert((slot < usedSlotCount) && "Unknown bindless slot.");
+
+            // Drop the write if it was never applied.
+            uint32_t &writeIndex = pendingWriteIndices[slot];
+            if (writeIndex != InvalidSlot) {
+                pendingWrites[writeIndex].slot = InvalidSlot;
+                writeIndex = InvalidSlot;
+            }
+
+            removedSlots[frameIndex].emplace_back(slot);
+        }
+
+        void recycle(uint32_t frameIndex) {
+            std::vector<uint32_t> &slots = removedSlots[frameIndex];
+            freeSlots.insert(freeSlots.end(), slots.begin(), slots.end());
+            slots.clear();
+        }
+
+        PendingWrite &queueWrite(uint32_t slot) {
+            assert((slot < usedSlotCount) && "Unknown bindless slot.");
+
+            uint32_t &writeIndex = pendingWriteIndices[slot];
+            if (writeIndex == InvalidSlot) {
+                writeIndex = uint32_t(pendingWrites.size());
+                pendingWrites.emplace_back();
+            }
+
+            PendingWrite &write = pendingWrites[writeIndex];
+            write = PendingWrite();
+            write.slot = slot;
+            return write;
+        }
+
+        void flush() {
+            for (const PendingWrite &write : pendingWrites) {
+                if (write.slot == InvalidSlot) {
+                    continue;
+                }
+
+                pendingWriteIndices[write.slot] = InvalidSlot;
+
+                if (write.sampler != nullptr) {
+                    descriptorSet->setSampler(write.slot, write.sampler);
+                }
+                else if (write.texture != nullptr) {
+                    descriptorSet->setTexture(write.slot, write.texture, write.textureLayout, write.textureView);
+                }
+                else {
+                    descriptorSet->setBuffer(write.slot, write.buffer, write.bufferSize, write.bufferStructuredViewSet ? &write.bufferStructuredView : nullptr, write.bufferFormattedView);
+                }
+            }
+
+            pendingWrites.clear();
+        }
+    };
+
+    struct RenderBindlessHeapDesc {
+        uint32_t textureCount = 0;
+        uint32_t bufferCount = 0;
+        uint32_t samplerCount = 0;
+
+        // Type of the descriptors in the buffer table.
+        RenderDescriptorRangeType bufferType = RenderDescriptorRangeType::STRUCTURED_BUFFER;
+
+        // Number of frames that can be in flight. Removed slots are reused after this many frames.
+        uint32_t frameCount = 2;
+
+        RenderBindlessHeapDesc() = default;
+
+        RenderBindlessHeapDesc(uint32_t textureCount, uint32_t bufferCount, uint32_t samplerCount, uint32_t frameCount = 2) {
+            this->textureCount = textureCount;
+            this->bufferCount = bufferCount;
+            this->samplerCount = samplerCount;
+            this->frameCount = frameCount;
+        }
+    };
+
+    // Global tables of textures, buffers and samplers that shaders index directly, so a whole scene can be drawn with the
+    // tables bound once and the per-draw indices passed in push constants or buffers. Each table is its own descriptor set:
+    // add them to the pipeline layout with RenderPipelineLayoutBuilder::addDescriptorSet(heap.textures.builder) and so on.
+    // Tables with a count of zero aren't created.
+    //
+    // Slots can be added and removed from any thread. flush() must be called before submitting the command lists that read the
+    // slots added or changed since the last flush, and beginFrame() must only be called after waiting on the fence of that frame.
+    // Changing the descriptor of a slot the GPU might still be reading is only valid if the new descriptor is compatible with every
+    // use of it in flight. Prefer adding a new slot and removing the old one instead.
+    struct RenderBindlessHeap {
+        RenderBindlessTable textures;
+        RenderBindlessTable buffers;
+        RenderBindlessTable samplers;
+        uint32_t frameIndex = 0;
+        uint32_t frameCount = 0;
+        std::mutex heapMutex;
+
+        RenderBindlessHeap() = default;
+
+        RenderBindlessHeap(RenderDevice *device, const RenderBindlessHeapDesc &desc) {
+            create(device, desc);
+        }
+
+        void create(RenderDevice *device, const RenderBindlessHeapDesc &desc) {
+            assert(device != nullptr);
+            assert(device->getCapabilities().descriptorIndexing && "Bindless heaps are unsupported on this device.");
+            assert(desc.frameCount > 0);
+
+            const std::scoped_lock lock(heapMutex);
+            frameIndex = 0;
+            frameCount = desc.frameCount;
+
+            if (desc.textureCount > 0) {
+                textures.create(device, RenderDescriptorRangeType::TEXTURE, desc.textureCount, desc.frameCount);
+            }
+
+            if (desc.bufferCount > 0) {
+                buffers.create(device, desc.bufferType, desc.bufferCount, desc.frameCount);
+            }
+
+            if (desc.samplerCount > 0) {
+                samplers.create(device, RenderDescriptorRangeType::SAMPLER, desc.samplerCount, desc.frameCount);
+            }
+        }
+
+        // The GPU must no longer be using the heap.
+        void release() {
+            const std::scoped_lock lock(heapMutex);
+            textures.release();
+            buffers.release();
+            samplers.release();
+        }
+
+        // Returns the slot the shaders must index the table with or InvalidSlot if the table is full.
+        uint32_t addTexture(const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView = nullptr) {
+            const std::scoped_lock lock(heapMutex);
+            uint32_t slot = textures.allocate();
+            if (slot != RenderBindlessTable::InvalidSlot) {
+                queueTexture(slot, texture, textureLayout, textureView);
+            }
+
+            return slot;
+        }
+
+        void setTexture(uint32_t slot, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView = nullptr) {
+            const std::scoped_lock lock(heapMutex);
+            queueTexture(slot, texture, textureLayout, textureView);
+        }
+
+        void removeTexture(uint32_t slot) {
+            const std::scoped_lock lock(heapMutex);
+            textures.remove(slot, frameIndex);
+        }
+
+        uint32_t addBuffer(const RenderBuffer *buffer, uint64_t bufferSize = 0, const RenderBufferStructuredView *bufferStructuredView = nullptr, const RenderBufferFormattedView *bufferFormattedView = nullptr) {
+            const std::scoped_lock lock(heapMutex);
+            uint32_t slot = buffers.allocate();
+            if (slot != RenderBindlessTable::InvalidSlot) {
+                queueBuffer(slot, buffer, bufferSize, bufferStructuredView, bufferFormattedView);
+            }
+
+            return slot;
+        }
+
+        void setBuffer(uint32_t slot, const RenderBuffer *buffer, uint64_t bufferSize = 0, const RenderBufferStructuredView *bufferStructuredView = nullptr, const RenderBufferFormattedView *bufferFormattedView = nullptr) {
+            const std::scoped_lock lock(heapMutex);
+            queueBuffer(slot, buffer, bufferSize, bufferStructuredView, bufferFormattedView);
+        }
+
+        void removeBuffer(uint32_t slot) {
+            const std::scoped_lock lock(heapMutex);
+            buffers.remove(slot, frameIndex);
+        }
+
+        uint32_t addSampler(const RenderSampler *sampler) {
+            const std::scoped_lock lock(heapMutex);
+            uint32_t slot = samplers.allocate();
+            if (slot != RenderBindlessTable::InvalidSlot) {
+                queueSampler(slot, sampler);
+            }
+
+            return slot;
+        }
+
+        void setSampler(uint32_t slot, const RenderSampler *sampler) {
+            const std::scoped_lock lock(heapMutex);
+            queueSampler(slot, sampler);
+        }
+
+        void removeSampler(uint32_t slot) {
+            const std::scoped_lock lock(heapMutex);
+            samplers.remove(slot, frameIndex);
+        }
+
+        // Makes the slots removed the last time this frame was used available again.
+        void beginFrame(uint32_t frameIndex) {
+            assert(frameIndex < frameCount);
+
+            const std::scoped_lock lock(heapMutex);
+            this->frameIndex = frameIndex;
+            if (textures.descriptorSet != nullptr) {
+                textures.recycle(frameIndex);
+            }
+
+            if (buffers.descriptorSet != nullptr) {
+                buffers.recycle(frameIndex);
+            }
+
+            if (samplers.descriptorSet != nullptr) {
+                samplers.recycle(frameIndex);
+            }
+        }
+
+        // Writes all the queued descriptors to the tables.
+        void flush() {
+            const std::scoped_lock lock(heapMutex);
+            textures.flush();
+            buffers.flush();
+            samplers.flush();
+        }
+
+        // Must be called with the mutex locked.
+        void queueTexture(uint32_t slot, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView) {
+            assert(texture != nullptr);
+
+            RenderBindlessTable::PendingWrite &write = textures.queueWrite(slot);
+            write.texture = texture;
+            write.textureLayout = textureLayout;
+            write.textureView = textureView;
+        }
+
+        // Must be called with the mutex locked.
+        void queueBuffer(uint32_t slot, const RenderBuffer *buffer, uint64_t bufferSize, const RenderBufferStructuredView *bufferStructuredView, const RenderBufferFormattedView *bufferFormattedView) {
+            assert(buffer != nullptr);
+
+            RenderBindlessTable::PendingWrite &write = buffers.queueWrite(slot);
+            write.buffer = buffer;
+            write.bufferSize = bufferSize;
+            write.bufferFormattedView = bufferFormattedView;
+            if (bufferStructuredView != nullptr) {
+                write.bufferStructuredView = *bufferStructuredView;
+                write.bufferStructuredViewSet = true;
+            }
+        }
+
+        // Must be called with the mutex locked.
+        void queueSampler(uint32_t slot, const RenderSampler *sampler) {
+            assert(sampler != nullptr);
+
+            RenderBindlessTable::PendingWrite &write = samplers.queueWrite(slot);
+            write.sampler = sampler;
+        }
+    };
+};
@@ -0,0 +1,439 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    // Two-level segregated fit allocator that hands out ranges of a fixed capacity. Free ranges are bucketed by size class
+    // so finding one that fits and returning one are both constant time, and freed ranges are merged with their free neighbors.
+    // Only offsets are tracked, so it can manage the memory of any resource.
+    struct RenderOffsetAllocator {
+        static constexpr uint32_t SecondLevelBits = 4;
+        static constexpr uint32_t SecondLevelCount = 1U << SecondLevelBits;
+        static constexpr uint32_t FirstLevelCount = 64 - SecondLevelBits + 1;
+        static constexpr uint32_t InvalidNode = 0xFFFFFFFFU;
+
+        struct Node {
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            uint32_t prevPhysical = InvalidNode;
+            uint32_t nextPhysical = InvalidNode;
+            uint32_t prevFree = InvalidNode;
+            uint32_t nextFree = InvalidNode;
+            bool free = false;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<uint32_t> unusedNodes;
+        uint64_t firstLevelBitmap = 0;
+        uint32_t secondLevelBitmaps[FirstLevelCount] = {};
+        uint32_t freeHeads[FirstLevelCount][SecondLevelCount];
+        uint64_t capacity = 0;
+        uint64_t freeSize = 0;
+
+        RenderOffsetAllocator() {
+            clearFreeLists();
+        }
+
+        RenderOffsetAllocator(uint64_t capacity) {
+            create(capacity);
+        }
+
+        void create(uint64_t capacity) {
+            assert(capacity > 0);
+
+            this->capacity = capacity;
+            nodes.clear();
+            unusedNodes.clear();
+            clearFreeLists();
+
+            const uint32_t nodeIndex = createNode();
+            nodes[nodeIndex].offset = 0;
+            nodes[nodeIndex].size = capacity;
+            insertFree(nodeIndex);
+            freeSize = capacity;
+        }
+
+        // Returns InvalidNode if no free range is large enough. The alignment must be a power of two.
+        uint32_t allocate(uint64_t size, uint64_t alignment, uint64_t &offset) {
+            assert(size > 0);
+            assert(((alignment & (alignment - 1)) == 0) && "Alignment must be a power of two.");
+
+            // Search for enough space to align the start of the range within any block of the size class.
+            const uint64_t searchSize = size + ((alignment > 1) ? (alignment - 1) : 0);
+            uint32_t nodeIndex = findFree(searchSize);
+            if (nodeIndex == InvalidNode) {
+                return InvalidNode;
+            }
+
+            removeFree(nodeIndex);
+
+            // Return the padding at the start to the free lists.
+            const uint64_t alignedOffset = (nodes[nodeIndex].offset + alignment - 1) & ~(alignment - 1);
+            const uint64_t padding = alignedOffset - nodes[nodeIndex].offset;
+            if (padding > 0) {
+                const uint32_t alignedIndex = splitNode(nodeIndex, padding);
+                insertFree(nodeIndex);
+                nodeIndex = alignedIndex;
+            }
+
+            // Return the remainder at the end to the free lists.
+            if (nodes[nodeIndex].size > size) {
+                const uint32_t remainderIndex = splitNode(nodeIndex, size);
+                insertFree(remainderIndex);
+            }
+
+            Node &node = nodes[nodeIndex];
+            node.free = false;
+            freeSize -= node.size;
+            offset = node.offset;
+            return nodeIndex;
+        }
+
+        void free(uint32_t nodeIndex) {
+            assert((nodeIndex < nodes.size()) && !nodes[nodeIndex].free && "Range was already freed.");
+
+            freeSize += nodes[nodeIndex].size;
+
+            // Merge with the next range.
+            const uint32_t nextIndex = nodes[nodeIndex].nextPhysical;
+            if ((nextIndex != InvalidNode) && nodes[nextIndex].free) {
+                removeFree(nextIndex);
+                mergeNext(nodeIndex);
+            }
+
+            // Merge into the previous range.
+            const uint32_t prevIndex = nodes[nodeIndex].prevPhysical;
+            if ((prevIndex != InvalidNode) && nodes[prevIndex].free) {
+                removeFree(prevIndex);
+                mergeNext(prevIndex);
+                nodeIndex = prevIndex;
+            }
+
+            insertFree(nodeIndex);
+        }
+
+        uint64_t getSize(uint32_t nodeIndex) const {
+            return nodes[nodeIndex].size;
+        }
+
+        bool empty() const {
+            return freeSize == capacity;
+        }
+
+        static uint32_t log2(uint64_t value) {
+            uint32_t result = 0;
+            while (value >>= 1) {
+                result++;
+            }
+
+            return result;
+        }
+
+        static uint32_t lowestBit(uint64_t value) {
+            uint32_t result = 0;
+            while ((value & 1) == 0) {
+                value >>= 1;
+                result++;
+            }
+
+            return result;
+        }
+
+        static void mapping(uint64_t size, uint32_t &firstLevel, uint32_t &secondLevel) {
+            // Sizes smaller than the second level count are all stored in the first level linearly.
+            if (size < SecondLevelCount) {
+                firstLevel = 0;
+                secondLevel = uint32_t(size);
+            }
+            else {
+                const uint32_t highestBit = log2(size);
+                firstLevel = highestBit - SecondLevelBits + 1;
+                secondLevel = uint32_t(size >> (highestBit - SecondLevelBits)) - SecondLevelCount;
+            }
+        }
+
+        void clearFreeLists() {
+            firstLevelBitmap = 0;
+            for (uint32_t i = 0; i < FirstLevelCount; i++) {
+                secondLevelBitmaps[i] = 0;
+                for (uint32_t j = 0; j < SecondLevelCount; j++) {
+                    freeHeads[i][j] = InvalidNode;
+                }
+            }
+        }
+
+        uint32_t createNode() {
+            if (!unusedNodes.empty()) {
+                const uint32_t nodeIndex = unusedNodes.back();
+                unusedNodes.pop_back();
+                nodes[nodeIndex] = Node();
+                return nodeIndex;
+            }
+
+            nodes.emplace_back();
+            return uint32_t(nodes.size() - 1);
+        }
+
+        uint32_t findFree(uint64_t size) const {
+            // Round up to the next size class so any range in the class found is large enough.
+            uint64_t roundedSize = size;
+            if (size >= SecondLevelCount) {
+                roundedSize += (1ULL << (log2(size) - SecondLevelBits)) - 1;
+            }
+
+            uint32_t firstLevel, secondLevel;
+            mapping(roundedSize, firstLevel, secondLevel);
+            if (firstLevel < FirstLevelCount) {
+                uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0U << secondLevel);
+                if (secondLevelMap == 0) {
+                    const uint64_t firstLevelMap = ((firstLevel + 1) < FirstLevelCount) ? (firstLevelBitmap & (~0ULL << (firstLevel + 1))) : 0;
+                    if (firstLevelMap != 0) {
+                        firstLevel = lowestBit(firstLevelMap);
+                        secondLevelMap = secondLevelBitmaps[firstLevel];
+                    }
+                }
+
+                if (secondLevelMap != 0) {
+                    return freeHeads[firstLevel][lowestBit(secondLevelMap)];
+                }
+            }
+
+            // The class the size belongs to can still hold a range that is large enough.
+            mapping(size, firstLevel, secondLevel);
+            for (uint32_t nodeIndex = freeHeads[firstLevel][secondLevel]; nodeIndex != InvalidNode; nodeIndex = nodes[nodeIndex].nextFree) {
+                if (nodes[nodeIndex].size >= size) {
+                    return nodeIndex;
+                }
+            }
+
+            return InvalidNode;
+        }
+
+        void insertFree(uint32_t nodeIndex) {
+            Node &node = nodes[nodeIndex];
+            uint32_t firstLevel, secondLevel;
+            mapping(node.size, firstLevel, secondLevel);
+
+            const uint32_t headIndex = freeHeads[firstLevel][secondLevel];
+            node.free = true;
+            node.prevFree = InvalidNode;
+            node.nextFree = headIndex;
+            if (headIndex != InvalidNode) {
+                nodes[headIndex].prevFree = nodeIndex;
+            }
+
+            freeHeads[firstLevel][secondLevel] = nodeIndex;
+            firstLevelBitmap |= (1ULL << firstLevel);
+            secondLevelBitmaps[firstLevel] |= (1U << secondLevel);
+        }
+
+        void removeFree(uint32_t nodeIndex) {
+            Node &node = nodes[nodeIndex];
+            uint32_t firstLevel, secondLevel;
+            mapping(node.size, firstLevel, secondLevel);
+
+            if (node.prevFree != InvalidNode) {
+                nodes[node.prevFree].nextFree = node.nextFree;
+            }
+            else {
+                freeHeads[firstLevel][secondLevel] = node.nextFree;
+            }
+
+            if (node.nextFree != InvalidNode) {
+                nodes[node.nextFree].prevFree = node.prevFree;
+            }
+
+            if (freeHeads[firstLevel][secondLevel] == InvalidNode) {
+                secondLevelBitmaps[firstLevel] &= ~(1U << secondLevel);
+                if (secondLevelBitmaps[firstLevel] == 0) {
+                    firstLevelBitmap &= ~(1ULL << firstLevel);
+                }
+            }
+
+            node.free = false;
+            node.prevFree = InvalidNode;
+            node.nextFree = InvalidNode;
+        }
+
+        // Splits the range after the size and returns the index of the new range that follows it.
+        uint32_t splitNode(uint32_t nodeIndex, uint64_t size) {
+            const uint32_t newIndex = createNode();
+            Node &node = nodes[nodeIndex];
+            Node &newNode = nodes[newIndex];
+            newNode.offset = node.offset + size;
+            newNode.size = node.size - size;
+            newNode.prevPhysical = nodeIndex;
+            newNode.nextPhysical = node.nextPhysical;
+            if (node.nextPhysical != InvalidNode) {
+                nodes[node.nextPhysical].prevPhysical = newIndex;
+            }
+
+            node.size = size;
+            node.nextPhysical = newIndex;
+            return newIndex;
+        }
+
+        // Absorbs the range that follows the node.
+        void mergeNext(uint32_t nodeIndex) {
+            Node &node = nodes[nodeIndex];
+            const uint32_t nextIndex = node.nextPhysical;
+            const Node &nextNode = nodes[nextIndex];
+            node.size += nextNode.size;
+            node.nextPhysical = nextNode.nextPhysical;
+            if (nextNode.nextPhysical != InvalidNode) {
+                nodes[nextNode.nextPhysical].prevPhysical = nodeIndex;
+            }
+
+            unusedNodes.emplace_back(nextIndex);
+        }
+    };
+
+    // Range of one of the buffers of a sub-allocator. The reference can be used anywhere a buffer and an offset are expected.
+    struct RenderBufferSlice {
+        RenderBufferReference reference;
+        uint64_t size = 0;
+        uint32_t pageIndex = 0;
+        uint32_t nodeIndex = RenderOffsetAllocator::InvalidNode;
+
+        bool isNull() const {
+            return nodeIndex == RenderOffsetAllocator::InvalidNode;
+        }
+    };
+
+    // Carves many small buffers out of a few large ones, so meshes and constant blocks don't each need their own buffer and
+    // memory allocation, and draws using different slices of the same page can share the same bind. Pages are created with the
+    // description given at creation when no existing page has enough space, and larger pages are created for slices that don't
+    // fit in one. Every slice is aligned to the granularity, which defaults to the constant buffer alignment required by D3D12.
+    //
+    // Slices can be allocated and freed from any thread. A slice must not be freed while the GPU might still be using it.
+    struct RenderBufferSubAllocator {
+        struct Page {
+            std::unique_ptr<RenderBuffer> buffer;
+            RenderOffsetAllocator allocator;
+        };
+
+        RenderDevice *device = nullptr;
+        RenderBufferDesc pageDesc;
+        uint64_t granularity = 256;
+        std::vector<std::unique_ptr<Page>> pages;
+        std::mutex allocatorMutex;
+
+        RenderBufferSubAllocator() = default;
+
+        RenderBufferSubAllocator(RenderDevice *device, const RenderBufferDesc &pageDesc, uint64_t granularity = 256) {
+            create(device, pageDesc, granularity);
+        }
+
+        void create(RenderDevice *device, const RenderBufferDesc &pageDesc, uint64_t granularity = 256) {
+            assert(device != nullptr);
+            assert(pageDesc.size > 0);
+            assert(((granularity & (granularity - 1)) == 0) && "Granularity must be a power of two.");
+            assert(pages.empty() && "Sub-allocator must be released before being created again.");
+
+            this->device = device;
+            this->pageDesc = pageDesc;
+            this->granularity = granularity;
+        }
+
+        // The GPU must no longer be using any of the slices.
+        void release() {
+            const std::scoped_lock lock(allocatorMutex);
+            pages.clear();
+        }
+
+        // Returns a null slice if the buffer for a new page couldn't be created.
+        RenderBufferSlice allocate(uint64_t size, uint64_t alignment = 1) {
+            assert(size > 0);
+
+            alignment = std::max(alignment, granularity);
+            size = (size + granularity - 1) & ~(granularity - 1);
+
+            const std::scoped_lock lock(allocatorMutex);
+            RenderBufferSlice slice;
+            for (uint32_t i = 0; i < pages.size(); i++) {
+                if ((pages[i] != nullptr) && allocateFromPage(i, size, alignment, slice)) {
+                    return slice;
+                }
+            }
+
+            // Reuse the index of a page that was trimmed if possible.
+            uint32_t pageIndex = uint32_t(pages.size());
+            for (uint32_t i = 0; i < pages.size(); i++) {
+                if (pages[i] == nullptr) {
+                    pageIndex = i;
+                    break;
+                }
+            }
+
+            RenderBufferDesc desc = pageDesc;
+            desc.size = std::max(desc.size, size + alignment - 1);
+
+            std::unique_ptr<Page> page = std::make_unique<Page>();
+            page->buffer = device->createBuffer(desc);
+            if (page->buffer == nullptr) {
+                return slice;
+            }
+
+            page->allocator.create(desc.size);
+            if (pageIndex == pages.size()) {
+                pages.emplace_back(std::move(page));
+            }
+            else {
+                pages[pageIndex] = std::move(page);
+            }
+
+            allocateFromPage(pageIndex, size, alignment, slice);
+            return slice;
+        }
+
+        void free(const RenderBufferSlice &slice) {
+            if (slice.isNull()) {
+                return;
+            }
+
+            const std::scoped_lock lock(allocatorMutex);
+            assert((slice.pageIndex < pages.size()) && (pages[slice.pageIndex] != nullptr) && "Unknown buffer slice.");
+            pages[slice.pageIndex]->allocator.free(slice.nodeIndex);
+        }
+
+        // Destroys the pages that have no slices allocated. The indices of the remaining pages don't change.
+        void trim() {
+            const std::scoped_lock lock(allocatorMutex);
+            for (std::unique_ptr<Page> &page : pages) {
+                if ((page != nullptr) && page->allocator.empty()) {
+                    page.reset();
+                }
+            }
+
+            while (!pages.empty() && (pages.back() == nullptr)) {
+                pages.pop_back();
+            }
+        }
+
+        // Must be called with the mutex locked.
+        bool allocateFromPage(uint32_t pageIndex, uint64_t size, uint64_t alignment, RenderBufferSlice &slice) {
+            Page &page = *pages[pageIndex];
+            uint64_t offset = 0;
+            const uint32_t nodeIndex = page.allocator.allocate(size, alignment, offset);
+            if (nodeIndex == RenderOffsetAllocator::InvalidNode) {
+                return false;
+            }
+
+            slice.reference = RenderBufferReference(page.buffer.get(), offset);
+            slice.size = size;
+            slice.pageIndex = pageIndex;
+            slice.nodeIndex = nodeIndex;
+            return true;
+        }
+    };
+};
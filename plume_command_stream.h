@@ -0,0 +1,862 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    enum class RenderCommandType : uint32_t {
+        BARRIERS,
+        DISPATCH,
+        DRAW_INSTANCED,
+        DRAW_INDEXED_INSTANCED,
+        DRAW_MESH_TASKS,
+        DRAW_MESH_TASKS_INDIRECT,
+        SET_PIPELINE,
+        SET_COMPUTE_PIPELINE_LAYOUT,
+        SET_COMPUTE_PUSH_CONSTANTS,
+        SET_COMPUTE_DESCRIPTOR_SET,
+        SET_GRAPHICS_PIPELINE_LAYOUT,
+        SET_GRAPHICS_PUSH_CONSTANTS,
+        SET_GRAPHICS_DESCRIPTOR_SET,
+        SET_GRAPHICS_ROOT_DESCRIPTOR,
+        SET_RAYTRACING_PIPELINE_LAYOUT,
+        SET_RAYTRACING_PUSH_CONSTANTS,
+        SET_RAYTRACING_DESCRIPTOR_SET,
+        SET_INDEX_BUFFER,
+        SET_VERTEX_BUFFERS,
+        SET_VIEWPORTS,
+        SET_SCISSORS,
+        SET_FRAMEBUFFER,
+        SET_DEPTH_BIAS,
+        SET_CULL_MODE,
+        SET_FRONT_FACE,
+        SET_PRIMITIVE_TOPOLOGY,
+        SET_DEPTH_ENABLED,
+        SET_DEPTH_WRITE_ENABLED,
+        SET_DEPTH_FUNCTION,
+        SET_STENCIL_ENABLED,
+        SET_STENCIL_FACES,
+        SET_STENCIL_REFERENCE,
+        SET_DEPTH_BIAS_ENABLED,
+        SET_DEPTH_CLIP_ENABLED,
+        CLEAR_COLOR,
+        CLEAR_DEPTH_STENCIL,
+        COPY_BUFFER_REGION,
+        COPY_TEXTURE_REGION,
+        COPY_BUFFER,
+        COPY_TEXTURE,
+        RESOLVE_TEXTURE,
+        RESOLVE_TEXTURE_REGION,
+        DISCARD_TEXTURE,
+        RESET_QUERY_POOL,
+        WRITE_TIMESTAMP
+    };
+
+    // Backend-agnostic list of commands that can be recorded at the cost of copying the arguments and translated into a
+    // command list later, possibly on a different thread. Commands are stored as tagged packets in linear blocks that are
+    // kept across resets, so a stream that is recorded every frame stops allocating once it has grown to its working size.
+    //
+    // Arrays and push constant data are copied into the stream, but the objects being referenced must remain alive until the
+    // stream is translated. Push constants must specify their size explicitly as the stream doesn't know the pipeline layout.
+    // Raytracing, acceleration structure builds, dynamic vertex input and shader objects must be recorded on the command list directly.
+    struct RenderCommandStream {
+        static constexpr size_t DefaultBlockSize = 64 * 1024;
+        static constexpr size_t PacketAlignment = 8;
+
+        struct PacketHeader {
+            RenderCommandType type;
+
+            // Size of the packet in bytes including the header.
+            uint32_t size;
+        };
+
+        struct Block {
+            std::unique_ptr<uint8_t[]> data;
+            size_t capacity = 0;
+            size_t size = 0;
+        };
+
+        struct Reader {
+            const uint8_t *cursor = nullptr;
+
+            template<typename T>
+            const T &read() {
+                cursor = alignPointer(cursor, alignof(T));
+                const T *value = reinterpret_cast<const T *>(cursor);
+                cursor += sizeof(T);
+                return *value;
+            }
+
+            template<typename T>
+            const T *readArray(uint32_t &count) {
+                count = read<uint32_t>();
+                if (count == 0) {
+                    return nullptr;
+                }
+
+                cursor = alignPointer(cursor, alignof(T));
+                const T *values = reinterpret_cast<const T *>(cursor);
+                cursor += sizeof(T) * count;
+                return values;
+            }
+
+            static const uint8_t *alignPointer(const uint8_t *pointer, size_t alignment) {
+                return reinterpret_cast<const uint8_t *>((reinterpret_cast<uintptr_t>(pointer) + alignment - 1) & ~uintptr_t(alignment - 1));
+            }
+        };
+
+        std::vector<Block> blocks;
+        uint32_t blockIndex = 0;
+        size_t blockSize = DefaultBlockSize;
+        size_t packetOffset = 0;
+        uint32_t commandCount = 0;
+
+        RenderCommandStream() = default;
+
+        RenderCommandStream(size_t blockSize) {
+            assert(blockSize > 0);
+            this->blockSize = blockSize;
+        }
+
+        // Discards all commands while keeping the memory of the blocks.
+        void reset() {
+            for (Block &block : blocks) {
+                block.size = 0;
+            }
+
+            blockIndex = 0;
+            packetOffset = 0;
+            commandCount = 0;
+        }
+
+        bool empty() const {
+            return commandCount == 0;
+        }
+
+        uint32_t getCommandCount() const {
+            return commandCount;
+        }
+
+        void barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
+            beginPacket(RenderCommandType::BARRIERS);
+            write(stages);
+            writeArray(bufferBarriers, bufferBarriersCount);
+            writeArray(textureBarriers, textureBarriersCount);
+            endPacket();
+        }
+
+        void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) {
+            beginPacket(RenderCommandType::DISPATCH);
+            write(threadGroupCountX);
+            write(threadGroupCountY);
+            write(threadGroupCountZ);
+            endPacket();
+        }
+
+        void drawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) {
+            beginPacket(RenderCommandType::DRAW_INSTANCED);
+            write(vertexCountPerInstance);
+            write(instanceCount);
+            write(startVertexLocation);
+            write(startInstanceLocation);
+            endPacket();
+        }
+
+        void drawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) {
+            beginPacket(RenderCommandType::DRAW_INDEXED_INSTANCED);
+            write(indexCountPerInstance);
+            write(instanceCount);
+            write(startIndexLocation);
+            write(baseVertexLocation);
+            write(startInstanceLocation);
+            endPacket();
+        }
+
+        void drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+            beginPacket(RenderCommandType::DRAW_MESH_TASKS);
+            write(groupCountX);
+            write(groupCountY);
+            write(groupCountZ);
+            endPacket();
+        }
+
+        void drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount = 1, uint32_t stride = 12) {
+            beginPacket(RenderCommandType::DRAW_MESH_TASKS_INDIRECT);
+            write(argumentBuffer);
+            write(drawCount);
+            write(stride);
+            endPacket();
+        }
+
+        void setPipeline(const RenderPipeline *pipeline) {
+            writePointerPacket(RenderCommandType::SET_PIPELINE, pipeline);
+        }
+
+        void setComputePipelineLayout(const RenderPipelineLayout *pipelineLayout) {
+            writePointerPacket(RenderCommandType::SET_COMPUTE_PIPELINE_LAYOUT, pipelineLayout);
+        }
+
+        void setComputePushConstants(uint32_t rangeIndex, const void *data, uint32_t offset, uint32_t size) {
+            writePushConstantsPacket(RenderCommandType::SET_COMPUTE_PUSH_CONSTANTS, rangeIndex, data, offset, size);
+        }
+
+        void setComputeDescriptorSet(RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
+            writeDescriptorSetPacket(RenderCommandType::SET_COMPUTE_DESCRIPTOR_SET, descriptorSet, setIndex);
+        }
+
+        void setGraphicsPipelineLayout(const RenderPipelineLayout *pipelineLayout) {
+            writePointerPacket(RenderCommandType::SET_GRAPHICS_PIPELINE_LAYOUT, pipelineLayout);
+        }
+
+        void setGraphicsPushConstants(uint32_t rangeIndex, const void *data, uint32_t offset, uint32_t size) {
+            writePushConstantsPacket(RenderCommandType::SET_GRAPHICS_PUSH_CONSTANTS, rangeIndex, data, offset, size);
+        }
+
+        void setGraphicsDescriptorSet(RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
+            writeDescriptorSetPacket(RenderCommandType::SET_GRAPHICS_DESCRIPTOR_SET, descriptorSet, setIndex);
+        }
+
+        void setGraphicsRootDescriptor(RenderBufferReference bufferReference, uint32_t rootDescriptorIndex) {
+            beginPacket(RenderCommandType::SET_GRAPHICS_ROOT_DESCRIPTOR);
+            write(bufferReference);
+            write(rootDescriptorIndex);
+            endPacket();
+        }
+
+        void setRaytracingPipelineLayout(const RenderPipelineLayout *pipelineLayout) {
+            writePointerPacket(RenderCommandType::SET_RAYTRACING_PIPELINE_LAYOUT, pipelineLayout);
+        }
+
+        void setRaytracingPushConstants(uint32_t rangeIndex, const void *data, uint32_t offset, uint32_t size) {
+            writePushConstantsPacket(RenderCommandType::SET_RAYTRACING_PUSH_CONSTANTS, rangeIndex, data, offset, size);
+        }
+
+        void setRaytracingDescriptorSet(RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
+            writeDescriptorSetPacket(RenderCommandType::SET_RAYTRACING_DESCRIPTOR_SET, descriptorSet, setIndex);
+        }
+
+        void setIndexBuffer(const RenderIndexBufferView *view) {
+            beginPacket(RenderCommandType::SET_INDEX_BUFFER);
+            writeArray(view, (view != nullptr) ? 1 : 0);
+            endPacket();
+        }
+
+        void setVertexBuffers(uint32_t startSlot, const RenderVertexBufferView *views, uint32_t viewCount, const RenderInputSlot *inputSlots) {
+            beginPacket(RenderCommandType::SET_VERTEX_BUFFERS);
+            write(startSlot);
+            writeArray(views, viewCount);
+            writeArray(inputSlots, (inputSlots != nullptr) ? viewCount : 0);
+            endPacket();
+        }
+
+        void setViewports(const RenderViewport *viewports, uint32_t count) {
+            beginPacket(RenderCommandType::SET_VIEWPORTS);
+            writeArray(viewports, count);
+            endPacket();
+        }
+
+        void setViewports(const RenderViewport &viewport) {
+            setViewports(&viewport, 1);
+        }
+
+        void setScissors(const RenderRect *scissorRects, uint32_t count) {
+            beginPacket(RenderCommandType::SET_SCISSORS);
+            writeArray(scissorRects, count);
+            endPacket();
+        }
+
+        void setScissors(const RenderRect &scissorRect) {
+            setScissors(&scissorRect, 1);
+        }
+
+        void setFramebuffer(const RenderFramebuffer *framebuffer) {
+            writePointerPacket(RenderCommandType::SET_FRAMEBUFFER, framebuffer);
+        }
+
+        void setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) {
+            beginPacket(RenderCommandType::SET_DEPTH_BIAS);
+            write(depthBias);
+            write(depthBiasClamp);
+            write(slopeScaledDepthBias);
+            endPacket();
+        }
+
+        void setCullMode(RenderCullMode cullMode) {
+            writeValuePacket(RenderCommandType::SET_CULL_MODE, cullMode);
+        }
+
+        void setFrontFace(RenderFrontFace frontFace) {
+            writeValuePacket(RenderCommandType::SET_FRONT_FACE, frontFace);
+        }
+
+        void setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) {
+            writeValuePacket(RenderCommandType::SET_PRIMITIVE_TOPOLOGY, primitiveTopology);
+        }
+
+        void setDepthEnabled(bool depthEnabled) {
+            writeValuePacket(RenderCommandType::SET_DEPTH_ENABLED, depthEnabled);
+        }
+
+        void setDepthWriteEnabled(bool depthWriteEnabled) {
+            writeValuePacket(RenderCommandType::SET_DEPTH_WRITE_ENABLED, depthWriteEnabled);
+        }
+
+        void setDepthFunction(RenderComparisonFunction depthFunction) {
+            writeValuePacket(RenderCommandType::SET_DEPTH_FUNCTION, depthFunction);
+        }
+
+        void setStencilEnabled(bool stencilEnabled) {
+            writeValuePacket(RenderCommandType::SET_STENCIL_ENABLED, stencilEnabled);
+        }
+
+        void setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) {
+            beginPacket(RenderCommandType::SET_STENCIL_FACES);
+            write(stencilFrontFace);
+            write(stencilBackFace);
+            endPacket();
+        }
+
+        void setStencilReference(uint32_t stencilReference) {
+            writeValuePacket(RenderCommandType::SET_STENCIL_REFERENCE, stencilReference);
+        }
+
+        void setDepthBiasEnabled(bool depthBiasEnabled) {
+            writeValuePacket(RenderCommandType::SET_DEPTH_BIAS_ENABLED, depthBiasEnabled);
+        }
+
+        void setDepthClipEnabled(bool depthClipEnabled) {
+            writeValuePacket(RenderCommandType::SET_DEPTH_CLIP_ENABLED, depthClipEnabled);
+        }
+
+        void clearColor(uint32_t attachmentIndex = 0, RenderColor colorValue = RenderColor(), const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) {
+            beginPacket(RenderCommandType::CLEAR_COLOR);
+            write(attachmentIndex);
+            write(colorValue);
+            writeArray(clearRects, clearRectsCount);
+            endPacket();
+        }
+
+        void clearDepthStencil(bool clearDepth = true, bool clearStencil = true, float depthValue = 1.0f, uint32_t stencilValue = 0, const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) {
+            beginPacket(RenderCommandType::CLEAR_DEPTH_STENCIL);
+            write(clearDepth);
+            write(clearStencil);
+            write(depthValue);
+            write(stencilValue);
+            writeArray(clearRects, clearRectsCount);
+            endPacket();
+        }
+
+        void copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) {
+            beginPacket(RenderCommandType::COPY_BUFFER_REGION);
+            write(dstBuffer);
+            write(srcBuffer);
+            write(size);
+            endPacket();
+        }
+
+        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX = 0, uint32_t dstY = 0, uint32_t dstZ = 0, const RenderBox *srcBox = nullptr) {
+            beginPacket(RenderCommandType::COPY_TEXTURE_REGION);
+            write(dstLocation);
+            write(srcLocation);
+            write(dstX);
+            write(dstY);
+            write(dstZ);
+            writeArray(srcBox, (srcBox != nullptr) ? 1 : 0);
+            endPacket();
+        }
+
+        void copyBuffer(const RenderBuffer *dstBuffer, const RenderBuffer *srcBuffer) {
+            beginPacket(RenderCommandType::COPY_BUFFER);
+            write(dstBuffer);
+            write(srcBuffer);
+            endPacket();
+        }
+
+        void copyTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) {
+            beginPacket(RenderCommandType::COPY_TEXTURE);
+            write(dstTexture);
+            write(srcTexture);
+            endPacket();
+        }
+
+        void resolveTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) {
+            beginPacket(RenderCommandType::RESOLVE_TEXTURE);
+            write(dstTexture);
+            write(srcTexture);
+            endPacket();
+        }
+
+        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect = nullptr, RenderResolveMode resolveMode = RenderResolveMode::AVERAGE) {
+            beginPacket(RenderCommandType::RESOLVE_TEXTURE_REGION);
+            write(dstTexture);
+            write(dstX);
+            write(dstY);
+            write(srcTexture);
+            writeArray(srcRect, (srcRect != nullptr) ? 1 : 0);
+            write(resolveMode);
+            endPacket();
+        }
+
+        void discardTexture(const RenderTexture *texture) {
+            writePointerPacket(RenderCommandType::DISCARD_TEXTURE, texture);
+        }
+
+        void resetQueryPool(const RenderQueryPool *queryPool, uint32_t queryFirstIndex, uint32_t queryCount) {
+            beginPacket(RenderCommandType::RESET_QUERY_POOL);
+            write(queryPool);
+            write(queryFirstIndex);
+            write(queryCount);
+            endPacket();
+        }
+
+        void writeTimestamp(const RenderQueryPool *queryPool, uint32_t queryIndex) {
+            beginPacket(RenderCommandType::WRITE_TIMESTAMP);
+            write(queryPool);
+            write(queryIndex);
+            endPacket();
+        }
+
+        // Records the commands of the stream into the command list. The command list must be open and the stream can be translated any number of times.
+        void translate(RenderCommandList *commandList) const {
+            assert(commandList != nullptr);
+
+            const uint32_t blockCount = std::min(blockIndex + 1, uint32_t(blocks.size()));
+            for (uint32_t i = 0; i < blockCount; i++) {
+                const Block &block = blocks[i];
+                size_t offset = 0;
+                while (offset < block.size) {
+                    const PacketHeader &header = *reinterpret_cast<const PacketHeader *>(&block.data[offset]);
+                    Reader reader;
+                    reader.cursor = &block.data[offset + sizeof(PacketHeader)];
+                    translatePacket(commandList, header.type, reader);
+                    offset = roundUp(offset + header.size, PacketAlignment);
+                }
+            }
+        }
+
+        static void translatePacket(RenderCommandList *commandList, RenderCommandType type, Reader &reader) {
+            switch (type) {
+            case RenderCommandType::BARRIERS: {
+                const RenderBarrierStages stages = reader.read<RenderBarrierStages>();
+                uint32_t bufferBarriersCount, textureBarriersCount;
+                const RenderBufferBarrier *bufferBarriers = reader.readArray<RenderBufferBarrier>(bufferBarriersCount);
+                const RenderTextureBarrier *textureBarriers = reader.readArray<RenderTextureBarrier>(textureBarriersCount);
+                commandList->barriers(stages, bufferBarriers, bufferBarriersCount, textureBarriers, textureBarriersCount);
+                break;
+            }
+            case RenderCommandType::DISPATCH: {
+                const uint32_t x = reader.read<uint32_t>();
+                const uint32_t y = reader.read<uint32_t>();
+                const uint32_t z = reader.read<uint32_t>();
+                commandList->dispatch(x, y, z);
+                break;
+            }
+            case RenderCommandType::DRAW_INSTANCED: {
+                const uint32_t vertexCountPerInstance = reader.read<uint32_t>();
+                const uint32_t instanceCount = reader.read<uint32_t>();
+                const uint32_t startVertexLocation = reader.read<uint32_t>();
+                const uint32_t startInstanceLocation = reader.read<uint32_t>();
+                commandList->drawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+                break;
+            }
+            case RenderCommandType::DRAW_INDEXED_INSTANCED: {
+                const uint32_t indexCountPerInstance = reader.read<uint32_t>();
+                const uint32_t instanceCount = reader.read<uint32_t>();
+                const uint32_t startIndexLocation = reader.read<uint32_t>();
+                const int32_t baseVertexLocation = reader.read<int32_t>();
+                const uint32_t startInstanceLocation = reader.read<uint32_t>();
+                commandList->drawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+                break;
+            }
+            case RenderCommandType::DRAW_MESH_TASKS: {
+                const uint32_t x = reader.read<uint32_t>();
+                const uint32_t y = reader.read<uint32_t>();
+                const uint32_t z = reader.read<uint32_t>();
+                commandList->drawMeshTasks(x, y, z);
+                break;
+            }
+            case RenderCommandType::DRAW_MESH_TASKS_INDIRECT: {
+                const RenderBufferReference argumentBuffer = reader.read<RenderBufferReference>();
+                const uint32_t drawCount = reader.read<uint32_t>();
+                const uint32_t stride = reader.read<uint32_t>();
+                commandList->drawMeshTasksIndirect(argumentBuffer, drawCount, stride);
+                break;
+            }
+            case RenderCommandType::SET_PIPELINE:
+                commandList->setPipeline(reader.read<const RenderPipeline *>());
+                break;
+            case RenderCommandType::SET_COMPUTE_PIPELINE_LAYOUT:
+                commandList->setComputePipelineLayout(reader.read<const RenderPipelineLayout *>());
+                break;
+            case RenderCommandType::SET_GRAPHICS_PIPELINE_LAYOUT:
+                commandList->setGraphicsPipelineLayout(reader.read<const RenderPipelineLayout *>());
+                break;
+            case RenderCommandType::SET_RAYTRACING_PIPELINE_LAYOUT:
+                commandList->setRaytracingPipelineLayout(reader.read<const RenderPipelineLayout *>());
+                break;
+            case RenderCommandType::SET_COMPUTE_PUSH_CONSTANTS:
+            case RenderCommandType::SET_GRAPHICS_PUSH_CONSTANTS:
+            case RenderCommandType::SET_RAYTRACING_PUSH_CONSTANTS: {
+                const uint32_t rangeIndex = reader.read<uint32_t>();
+                const uint32_t offset = reader.read<uint32_t>();
+                uint32_t size;
+                const uint8_t *data = reader.readArray<uint8_t>(size);
+                if (type == RenderCommandType::SET_COMPUTE_PUSH_CONSTANTS) {
+                    commandList->setComputePushConstants(rangeIndex, data, offset, size);
+                }
+                else if (type == RenderCommandType::SET_GRAPHICS_PUSH_CONSTANTS) {
+                    commandList->setGraphicsPushConstants(rangeIndex, data, offset, size);
+                }
+                else {
+                    commandList->setRaytracingPushConstants(rangeIndex, data, offset, size);
+                }
+
+                break;
+            }
+            case RenderCommandType::SET_COMPUTE_DESCRIPTOR_SET:
+            case RenderCommandType::SET_GRAPHICS_DESCRIPTOR_SET:
+            case RenderCommandType::SET_RAYTRACING_DESCRIPTOR_SET: {
+                RenderDescriptorSet *descriptorSet = reader.read<RenderDescriptorSet *>();
+                const uint32_t setIndex = reader.read<uint32_t>();
+                if (type == RenderCommandType::SET_COMPUTE_DESCRIPTOR_SET) {
+                    commandList->setComputeDescriptorSet(descriptorSet, setIndex);
+                }
+                else if (type == RenderCommandType::SET_GRAPHICS_DESCRIPTOR_SET) {
+                    commandList->setGraphicsDescriptorSet(descriptorSet, setIndex);
+                }
+                else {
+                    commandList->setRaytracingDescriptorSet(descriptorSet, setIndex);
+                }
+
+                break;
+            }
+            case RenderCommandType::SET_GRAPHICS_ROOT_DESCRIPTOR: {
+                const RenderBufferReference bufferReference = reader.read<RenderBufferReference>();
+                const uint32_t rootDescriptorIndex = reader.read<uint32_t>();
+                commandList->setGraphicsRootDescriptor(bufferReference, rootDescriptorIndex);
+                break;
+            }
+            case RenderCommandType::SET_INDEX_BUFFER: {
+                uint32_t viewCount;
+                commandList->setIndexBuffer(reader.readArray<RenderIndexBufferView>(viewCount));
+                break;
+            }
+            case RenderCommandType::SET_VERTEX_BUFFERS: {
+                const uint32_t startSlot = reader.read<uint32_t>();
+                uint32_t viewCount, inputSlotsCount;
+                const RenderVertexBufferView *views = reader.readArray<RenderVertexBufferView>(viewCount);
+                const RenderInputSlot *inputSlots = reader.readArray<RenderInputSlot>(inputSlotsCount);
+                commandList->setVertexBuffers(startSlot, views, viewCount, inputSlots);
+                break;
+            }
+            case RenderCommandType::SET_VIEWPORTS: {
+                uint32_t count;
+                const RenderViewport *viewports = reader.readArray<RenderViewport>(count);
+                commandList->setViewports(viewports, count);
+                break;
+            }
+            case RenderCommandType::SET_SCISSORS: {
+                uint32_t count;
+                const RenderRect *scissorRects = reader.readArray<RenderRect>(count);
+                commandList->setScissors(scissorRects, count);
+                break;
+            }
+            case RenderCommandType::SET_FRAMEBUFFER:
+                commandList->setFramebuffer(reader.read<const RenderFramebuffer *>());
+                break;
+            case RenderCommandType::SET_DEPTH_BIAS: {
+                const float depthBias = reader.read<float>();
+                const float depthBiasClamp = reader.read<float>();
+                const float slopeScaledDepthBias = reader.read<float>();
+                commandList->setDepthBias(depthBias, depthBiasClamp, slopeScaledDepthBias);
+                break;
+            }
+            case RenderCommandType::SET_CULL_MODE:
+                commandList->setCullMode(reader.read<RenderCullMode>());
+                break;
+            case RenderCommandType::SET_FRONT_FACE:
+                commandList->setFrontFace(reader.read<RenderFrontFace>());
+                break;
+            case RenderCommandType::SET_PRIMITIVE_TOPOLOGY:
+                commandList->setPrimitiveTopology(reader.read<RenderPrimitiveTopology>());
+                break;
+            case RenderCommandType::SET_DEPTH_ENABLED:
+                commandList->setDepthEnabled(reader.read<bool>());
+                break;
+            case RenderCommandType::SET_DEPTH_WRITE_ENABLED:
+                commandList->setDepthWriteEnabled(reader.read<bool>());
+                break;
+            case RenderCommandType::SET_DEPTH_FUNCTION:
+                commandList->setDepthFunction(reader.read<RenderComparisonFunction>());
+                break;
+            case RenderCommandType::SET_STENCIL_ENABLED:
+                commandList->setStencilEnabled(reader.read<bool>());
+                break;
+            case RenderCommandType::SET_STENCIL_FACES: {
+                const RenderStencilFaceDesc &stencilFrontFace = reader.read<RenderStencilFaceDesc>();
+                const RenderStencilFaceDesc &stencilBackFace = reader.read<RenderStencilFaceDesc>();
+                commandList->setStencilFaces(stencilFrontFace, stencilBackFace);
+                break;
+            }
+            case RenderCommandType::SET_STENCIL_REFERENCE:
+                commandList->setStencilReference(reader.read<uint32_t>());
+                break;
+            case RenderCommandType::SET_DEPTH_BIAS_ENABLED:
+                commandList->setDepthBiasEnabled(reader.read<bool>());
+                break;
+            case RenderCommandType::SET_DEPTH_CLIP_ENABLED:
+                commandList->setDepthClipEnabled(reader.read<bool>());
+                break;
+            case RenderCommandType::CLEAR_COLOR: {
+                const uint32_t attachmentIndex = reader.read<uint32_t>();
+                const RenderColor colorValue = reader.read<RenderColor>();
+                uint32_t clearRectsCount;
+                const RenderRect *clearRects = reader.readArray<RenderRect>(clearRectsCount);
+                commandList->clearColor(attachmentIndex, colorValue, clearRects, clearRectsCount);
+                break;
+            }
+            case RenderCommandType::CLEAR_DEPTH_STENCIL: {
+                const bool clearDepth = reader.read<bool>();
+                const bool clearStencil = reader.read<bool>();
+                const float depthValue = reader.read<float>();
+                const uint32_t stencilValue = reader.read<uint32_t>();
+                uint32_t clearRectsCount;
+                const RenderRect *clearRects = reader.readArray<RenderRect>(clearRectsCount);
+                commandList->clearDepthStencil(clearDepth, clearStencil, depthValue, stencilValue, clearRects, clearRectsCount);
+                break;
+            }
+            case RenderCommandType::COPY_BUFFER_REGION: {
+                const RenderBufferReference dstBuffer = reader.read<RenderBufferReference>();
+                const RenderBufferReference srcBuffer = reader.read<RenderBufferReference>();
+                const uint64_t size = reader.read<uint64_t>();
+                commandList->copyBufferRegion(dstBuffer, srcBuffer, size);
+                break;
+            }
+            case RenderCommandType::COPY_TEXTURE_REGION: {
+                const RenderTextureCopyLocation &dstLocation = reader.read<RenderTextureCopyLocation>();
+                const RenderTextureCopyLocation &srcLocation = reader.read<RenderTextureCopyLocation>();
+                const uint32_t dstX = reader.read<uint32_t>();
+                const uint32_t dstY = reader.read<uint32_t>();
+                const uint32_t dstZ = reader.read<uint32_t>();
+                uint32_t srcBoxCount;
+                const RenderBox *srcBox = reader.readArray<RenderBox>(srcBoxCount);
+                commandList->copyTextureRegion(dstLocation, srcLocation, dstX, dstY, dstZ, srcBox);
+                break;
+            }
+            case RenderCommandType::COPY_BUFFER: {
+                const RenderBuffer *dstBuffer = reader.read<const RenderBuffer *>();
+                const RenderBuffer *srcBuffer = reader.read<const RenderBuffer *>();
+                commandList->copyBuffer(dstBuffer, srcBuffer);
+                break;
+            }
+            case RenderCommandType::COPY_TEXTURE: {
+                const RenderTexture *dstTexture = reader.read<const RenderTexture *>();
+                const RenderTexture *srcTexture = reader.read<const RenderTexture *>();
+                commandList->copyTexture(dstTexture, srcTexture);
+                break;
+            }
+            case RenderCommandType::RESOLVE_TEXTURE: {
+                const RenderTexture *dstTexture = reader.read<const RenderTexture *>();
+                const RenderTexture *srcTexture = reader.read<const RenderTexture *>();
+                commandList->resolveTexture(dstTexture, srcTexture);
+                break;
+            }
+            case RenderCommandType::RESOLVE_TEXTURE_REGION: {
+                const RenderTexture *dstTexture = reader.read<const RenderTexture *>();
+                const uint32_t dstX = reader.read<uint32_t>();
+                const uint32_t dstY = reader.read<uint32_t>();
+                const RenderTexture *srcTexture = reader.read<const RenderTexture *>();
+                uint32_t srcRectCount;
+                const RenderRect *srcRect = reader.readArray<RenderRect>(srcRectCount);
+                const RenderResolveMode resolveMode = reader.read<RenderResolveMode>();
+                commandList->resolveTextureRegion(dstTexture, dstX, dstY, srcTexture, srcRect, resolveMode);
+                break;
+            }
+            case RenderCommandType::DISCARD_TEXTURE:
+                commandList->discardTexture(reader.read<const RenderTexture *>());
+                break;
+            case RenderCommandType::RESET_QUERY_POOL: {
+                const RenderQueryPool *queryPool = reader.read<const RenderQueryPool *>();
+                const uint32_t queryFirstIndex = reader.read<uint32_t>();
+                const uint32_t queryCount = reader.read<uint32_t>();
+                commandList->resetQueryPool(queryPool, queryFirstIndex, queryCount);
+                break;
+            }
+            case RenderCommandType::WRITE_TIMESTAMP: {
+                const RenderQueryPool *queryPool = reader.read<const RenderQueryPool *>();
+                const uint32_t queryIndex = reader.read<uint32_t>();
+                commandList->writeTimestamp(queryPool, queryIndex);
+                break;
+            }
+            default:
+                assert(false && "Unknown command type.");
+                break;
+            }
+        }
+
+        void beginPacket(RenderCommandType type) {
+            if (blocks.empty()) {
+                allocateBlock(0, blockSize);
+            }
+
+            // Packets always start aligned so they can be moved to a new block without changing the alignment of their contents.
+            Block &block = blocks[blockIndex];
+            block.size = roundUp(block.size, PacketAlignment);
+            packetOffset = block.size;
+
+            const PacketHeader header = { type, 0 };
+            writeBytes(&header, sizeof(header), alignof(PacketHeader));
+        }
+
+        void endPacket() {
+            Block &block = blocks[blockIndex];
+            PacketHeader &header = *reinterpret_cast<PacketHeader *>(&block.data[packetOffset]);
+            header.size = uint32_t(block.size - packetOffset);
+            commandCount++;
+        }
+
+        template<typename T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Command arguments must be trivially copyable.");
+            writeBytes(&value, sizeof(T), alignof(T));
+        }
+
+        template<typename T>
+        void writeArray(const T *values, uint32_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "Command arguments must be trivially copyable.");
+            assert((values != nullptr) || (count == 0));
+            write(count);
+            if (count > 0) {
+                writeBytes(values, sizeof(T) * count, alignof(T));
+            }
+        }
+
+        void writeBytes(const void *data, size_t size, size_t alignment) {
+            assert((alignment <= PacketAlignment) && "Alignment is not supported.");
+
+            Block *block = &blocks[blockIndex];
+            size_t alignedSize = roundUp(block->size, alignment);
+            if ((alignedSize + size) > block->capacity) {
+                // Move the packet being written to the start of the next block. Its contents are aligned relative to the start of the packet.
+                const size_t packetSize = block->size - packetOffset;
+                allocateBlock(blockIndex + 1, roundUp(packetSize, alignment) + size);
+
+                // The blocks might've been reallocated.
+                block = &blocks[blockIndex];
+                Block &nextBlock = blocks[blockIndex + 1];
+                memcpy(nextBlock.data.get(), &block->data[packetOffset], packetSize);
+                nextBlock.size = packetSize;
+                block->size = packetOffset;
+                blockIndex++;
+                packetOffset = 0;
+                block = &nextBlock;
+                alignedSize = roundUp(block->size, alignment);
+            }
+
+            memcpy(&block->data[alignedSize], data, size);
+            block->size = alignedSize + size;
+        }
+
+        // Reuses the block at the index if it's big enough or replaces it otherwise.
+        void allocateBlock(uint32_t index, size_t minimumCapacity) {
+            const size_t capacity = std::max(blockSize, minimumCapacity);
+            if (index >= blocks.size()) {
+                blocks.resize(index + 1);
+            }
+
+            Block &block = blocks[index];
+            if (block.capacity < capacity) {
+                block.data = std::make_unique<uint8_t[]>(capacity);
+                block.capacity = capacity;
+            }
+
+            block.size = 0;
+        }
+
+        template<typename T>
+        void writePointerPacket(RenderCommandType type, const T *pointer) {
+            beginPacket(type);
+            write(pointer);
+            endPacket();
+        }
+
+        template<typename T>
+        void writeValuePacket(RenderCommandType type, T value) {
+            beginPacket(type);
+            write(value);
+            endPacket();
+        }
+
+        void writeDescriptorSetPacket(RenderCommandType type, RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
+            beginPacket(type);
+            write(descriptorSet);
+            write(setIndex);
+            endPacket();
+        }
+
+        void writePushConstantsPacket(RenderCommandType type, uint32_t rangeIndex, const void *data, uint32_t offset, uint32_t size) {
+            assert((size > 0) && "The size of the push constants must be specified when recording into a stream.");
+            beginPacket(type);
+            write(rangeIndex);
+            write(offset);
+            writeArray(reinterpret_cast<const uint8_t *>(data), size);
+            endPacket();
+        }
+
+        static size_t roundUp(size_t value, size_t powerOf2Alignment) {
+            return (value + powerOf2Alignment - 1) & ~(powerOf2Alignment - 1);
+        }
+    };
+
+    // Translates each stream into the command list at the same position, which is opened and closed by the translation.
+    // The streams are distributed across the threads. Zero uses all the hardware threads available.
+    inline void RenderCommandStreamTranslate(const RenderCommandStream *const *streams, RenderCommandList *const *commandLists, uint32_t count, uint32_t threadCount = 0) {
+        auto translateStream = [&](uint32_t index) {
+            commandLists[index]->begin();
+            streams[index]->translate(commandLists[index]);
+            commandLists[index]->end();
+        };
+
+        threadCount = (threadCount > 0) ? threadCount : std::thread::hardware_concurrency();
+        threadCount = std::clamp(threadCount, 1U, std::max(count, 1U));
+        if (threadCount == 1) {
+            for (uint32_t i = 0; i < count; i++) {
+                translateStream(i);
+            }
+
+            return;
+        }
+
+        // The calling thread also translates streams.
+        std::atomic<uint32_t> nextIndex(0);
+        auto translateStreams = [&]() {
+            uint32_t index;
+            while ((index = nextIndex.fetch_add(1)) < count) {
+                translateStream(index);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (uint32_t i = 0; i < (threadCount - 1); i++) {
+            threads.emplace_back(translateStreams);
+        }
+
+        translateStreams();
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+};
@@ -6,7 +6,9 @@
 //
 
 #include "plume_d3d12.h"
+#include "plume_allocator.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 #ifdef __clang__
@@ -70,6 +72,11 @@ namespace plume {
         return (value + powerOf2Alignment - 1) & ~(powerOf2Alignment - 1);
     }
 
+    // External handles are NT handles, so a null handle can't be imported either.
+    static bool isImportableHandle(RenderExternalHandle handle) {
+        return (handle != 0) && (handle != RenderExternalHandleInvalid);
+    }
+
     static DXGI_FORMAT toDXGI(RenderFormat format) {
         switch (format) {
         case RenderFormat::UNKNOWN:
@@ -224,6 +231,60 @@ namespace plume {
             return DXGI_FORMAT_BC7_UNORM;
         case RenderFormat::BC7_UNORM_SRGB:
             return DXGI_FORMAT_BC7_UNORM_SRGB;
+        // ETC2, EAC and ASTC have no DXGI equivalent and are reported as unsupported.
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+        case RenderFormat::EAC_R11_UNORM:
+        case RenderFormat::EAC_R11_SNORM:
+        case RenderFormat::EAC_R11G11_UNORM:
+        case RenderFormat::EAC_R11G11_SNORM:
+        case RenderFormat::ASTC_4X4_UNORM:
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+        case RenderFormat::ASTC_4X4_FLOAT:
+        case RenderFormat::ASTC_5X4_UNORM:
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X4_FLOAT:
+        case RenderFormat::ASTC_5X5_UNORM:
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+        case RenderFormat::ASTC_5X5_FLOAT:
+        case RenderFormat::ASTC_6X5_UNORM:
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X5_FLOAT:
+        case RenderFormat::ASTC_6X6_UNORM:
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+        case RenderFormat::ASTC_6X6_FLOAT:
+        case RenderFormat::ASTC_8X5_UNORM:
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+        case RenderFormat::ASTC_8X5_FLOAT:
+        case RenderFormat::ASTC_8X6_UNORM:
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X6_FLOAT:
+        case RenderFormat::ASTC_8X8_UNORM:
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+        case RenderFormat::ASTC_8X8_FLOAT:
+        case RenderFormat::ASTC_10X5_UNORM:
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+        case RenderFormat::ASTC_10X5_FLOAT:
+        case RenderFormat::ASTC_10X6_UNORM:
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+        case RenderFormat::ASTC_10X6_FLOAT:
+        case RenderFormat::ASTC_10X8_UNORM:
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X8_FLOAT:
+        case RenderFormat::ASTC_10X10_UNORM:
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+        case RenderFormat::ASTC_10X10_FLOAT:
+        case RenderFormat::ASTC_12X10_UNORM:
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X10_FLOAT:
+        case RenderFormat::ASTC_12X12_UNORM:
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+        case RenderFormat::ASTC_12X12_FLOAT:
+            return DXGI_FORMAT_UNKNOWN;
         default:
             assert(false && "Unknown format.");
             return DXGI_FORMAT_FORCE_UINT;
@@ -615,10 +676,13 @@ namespace plume {
             return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
         }
 
+        // Indirect argument buffers can also be read with the rest of the read states they support.
+        const D3D12_RESOURCE_STATES indirectState = (bufferFlags & RenderBufferFlag::INDIRECT) ? D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT : D3D12_RESOURCE_STATE_COMMON;
+
         // If both stages are required and the buffer is read-only, use the all shader resource state.
         if (stages == (RenderBarrierStage::GRAPHICS | RenderBarrierStage::COMPUTE)) {
             if (accessBits == RenderBufferAccess::READ) {
-                return D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+                return D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE | indirectState;
             }
         }
 
@@ -626,14 +690,14 @@ namespace plume {
         if (stages == RenderBarrierStage::GRAPHICS) {
             if (accessBits == RenderBufferAccess::READ) {
                 if (bufferFlags & (RenderBufferFlag::VERTEX | RenderBufferFlag::CONSTANT)) {
-                    return D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+                    return D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | indirectState;
                 }
 
                 if (bufferFlags & RenderBufferFlag::INDEX) {
-                    return D3D12_RESOURCE_STATE_INDEX_BUFFER;
+                    return D3D12_RESOURCE_STATE_INDEX_BUFFER | indirectState;
                 }
 
-                return D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+                return D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | indirectState;
             }
         }
 
@@ -690,13 +754,14 @@ namespace plume {
         case RenderTextureCopyType::PLACED_FOOTPRINT: {
             const D3D12Buffer *interfaceBuffer = static_cast<const D3D12Buffer *>(location.buffer);
             const uint32_t blockWidth = RenderFormatBlockWidth(location.placedFootprint.format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(location.placedFootprint.format);
             const uint32_t blockCount = (location.placedFootprint.rowWidth + blockWidth - 1) / blockWidth;
             loc.pResource = (interfaceBuffer != nullptr) ? interfaceBuffer->d3d : nullptr;
             loc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
             loc.PlacedFootprint.Offset = location.placedFootprint.offset;
             loc.PlacedFootprint.Footprint.Format = toDXGI(location.placedFootprint.format);
             loc.PlacedFootprint.Footprint.Width = ((location.placedFootprint.width + blockWidth - 1) / blockWidth) * blockWidth;
-            loc.PlacedFootprint.Footprint.Height = ((location.placedFootprint.height + blockWidth - 1) / blockWidth) * blockWidth;
+            loc.PlacedFootprint.Footprint.Height = ((location.placedFootprint.height + blockHeight - 1) / blockHeight) * blockHeight;
             loc.PlacedFootprint.Footprint.Depth = location.placedFootprint.depth;
             loc.PlacedFootprint.Footprint.RowPitch = blockCount * RenderFormatSize(location.placedFootprint.format);
 
@@ -766,6 +831,25 @@ namespace plume {
         }
     }
 
+    static RenderFormatSupportFlags toFormatSupportFlags(const D3D12_FEATURE_DATA_FORMAT_SUPPORT &formatSupport) {
+        const D3D12_FORMAT_SUPPORT1 support1 = formatSupport.Support1;
+        const D3D12_FORMAT_SUPPORT2 support2 = formatSupport.Support2;
+        const bool typedUnorderedAccess = (support1 & D3D12_FORMAT_SUPPORT1_TYPED_UNORDERED_ACCESS_VIEW);
+        RenderFormatSupportFlags flags = RenderFormatSupportFlag::NONE;
+        // Integer formats can be loaded from shaders but never sampled, so sampling only decides whether the format can be filtered.
+        flags |= ((support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D) && (support1 & D3D12_FORMAT_SUPPORT1_SHADER_LOAD)) ? RenderFormatSupportFlag::TEXTURE : RenderFormatSupportFlag::NONE;
+        flags |= (support1 & D3D12_FORMAT_SUPPORT1_SHADER_SAMPLE) ? RenderFormatSupportFlag::LINEAR_FILTER : RenderFormatSupportFlag::NONE;
+        flags |= (typedUnorderedAccess && (support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D)) ? RenderFormatSupportFlag::READ_WRITE_TEXTURE : RenderFormatSupportFlag::NONE;
+        flags |= (support2 & D3D12_FORMAT_SUPPORT2_UAV_ATOMIC_ADD) ? RenderFormatSupportFlag::READ_WRITE_TEXTURE_ATOMIC : RenderFormatSupportFlag::NONE;
+        flags |= (support1 & D3D12_FORMAT_SUPPORT1_RENDER_TARGET) ? RenderFormatSupportFlag::RENDER_TARGET : RenderFormatSupportFlag::NONE;
+        flags |= (support1 & D3D12_FORMAT_SUPPORT1_BLENDABLE) ? RenderFormatSupportFlag::BLEND : RenderFormatSupportFlag::NONE;
+        flags |= (support1 & D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL) ? RenderFormatSupportFlag::DEPTH_TARGET : RenderFormatSupportFlag::NONE;
+        flags |= (support1 & D3D12_FORMAT_SUPPORT1_IA_VERTEX_BUFFER) ? RenderFormatSupportFlag::VERTEX_BUFFER : RenderFormatSupportFlag::NONE;
+        flags |= ((support1 & D3D12_FORMAT_SUPPORT1_BUFFER) && (support1 & D3D12_FORMAT_SUPPORT1_SHADER_LOAD)) ? RenderFormatSupportFlag::FORMATTED_BUFFER : RenderFormatSupportFlag::NONE;
+        flags |= (typedUnorderedAccess && (support1 & D3D12_FORMAT_SUPPORT1_BUFFER)) ? RenderFormatSupportFlag::READ_WRITE_FORMATTED_BUFFER : RenderFormatSupportFlag::NONE;
+        return flags;
+    }
+
     static void setObjectName(ID3D12Object *object, const std::string &name) {
         const std::wstring wideCharName = Utf8ToUtf16(name);
         object->SetName(wideCharName.c_str());
@@ -1492,8 +1576,12 @@ namespace plume {
     
     D3D12Framebuffer::D3D12Framebuffer(D3D12Device *device, const RenderFramebufferDesc &desc) {
         assert(device != nullptr);
+        assert(((desc.viewMask == 0) || device->capabilities.multiview) && "Multiview is unsupported on this device.");
+        assert((desc.layerCount > 0) && "Framebuffers must have at least one layer.");
+        assert(((desc.viewMask == 0) || (desc.layerCount == 1)) && "Layered framebuffers can't use multiview.");
 
         this->device = device;
+        this->layerCount = desc.layerCount;
         
         if (desc.colorAttachmentsCount > 0) {
             for (uint32_t i = 0; i < desc.colorAttachmentsCount; i++) {
@@ -1586,7 +1674,7 @@ namespace plume {
                 rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE3D;
                 rtvDesc.Texture3D.MipSlice = textureView->desc.mipSlice;
                 rtvDesc.Texture3D.FirstWSlice = 0;
-                rtvDesc.Texture3D.WSize = 1;
+                rtvDesc.Texture3D.WSize = layerCount;
                 break;
             default:
                 assert(false && "Unsupported texture dimension for render target.");
@@ -1633,7 +1721,7 @@ namespace plume {
                 rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE3D;
                 rtvDesc.Texture3D.MipSlice = 0;
                 rtvDesc.Texture3D.FirstWSlice = 0;
-                rtvDesc.Texture3D.WSize = 1;
+                rtvDesc.Texture3D.WSize = layerCount;
                 break;
             default:
                 assert(false && "Unsupported texture dimension for render target.");
@@ -1813,10 +1901,11 @@ namespace plume {
 
     // D3D12CommandList
 
-    D3D12CommandList::D3D12CommandList(D3D12CommandQueue *queue) {
+    D3D12CommandList::D3D12CommandList(D3D12CommandQueue *queue, const RenderCommandListDesc &desc) {
         assert(queue != nullptr);
 
         this->queue = queue;
+        this->desc = desc;
 
         D3D12_COMMAND_LIST_TYPE commandListType;
         switch (queue->type) {
@@ -1865,10 +1954,12 @@ namespace plume {
         commandAllocator->Reset();
         d3d->Reset(commandAllocator, nullptr);
         open = true;
+        splitBarrierCount = 0;
     }
 
     void D3D12CommandList::end() {
         assert(open);
+        assert(std::none_of(splitBarriers.begin(), splitBarriers.end(), [](const SplitBarrier &splitBarrier) { return splitBarrier.active; }) && "Split barriers must end before the command list.");
 
         // It's required to reset the sample positions before the command list ends.
         resetSamplePositions();
@@ -1882,38 +1973,39 @@ namespace plume {
         activeGraphicsPipeline = nullptr;
         activeTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
         activeStencilRef = 0;
+        dynamicTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        dynamicStencilRef = 0;
         descriptorHeapsSet = false;
     }
     
-    void D3D12CommandList::barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
-        thread_local std::vector<D3D12_RESOURCE_BARRIER> barrierVector;
-        barrierVector.clear();
-        
-        auto makeBarrier = [&](ID3D12Resource *resource, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter, bool supportsUAV, D3D12_RESOURCE_BARRIER &resourceBarrier) {
-            resourceBarrier = {};
+    static bool makeResourceBarrier(RenderCommandListType queueType, ID3D12Resource *resource, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter, bool supportsUAV, D3D12_RESOURCE_BARRIER &resourceBarrier) {
+        resourceBarrier = {};
 
-            if (queue->type == RenderCommandListType::COPY) {
-                return false;
-            }
+        if (queueType == RenderCommandListType::COPY) {
+            return false;
+        }
 
-            if (stateBefore != stateAfter) {
-                resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-                resourceBarrier.Transition.StateBefore = stateBefore;
-                resourceBarrier.Transition.StateAfter = stateAfter;
-                resourceBarrier.Transition.pResource = resource;
-                resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-                return true;
-            }
-            else if (supportsUAV) {
-                resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-                resourceBarrier.UAV.pResource = resource;
-                return true;
-            }
-            else {
-                return false;
-            }
-        };
+        if (stateBefore != stateAfter) {
+            resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            resourceBarrier.Transition.StateBefore = stateBefore;
+            resourceBarrier.Transition.StateAfter = stateAfter;
+            resourceBarrier.Transition.pResource = resource;
+            resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            return true;
+        }
+        else if (supportsUAV) {
+            resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+            resourceBarrier.UAV.pResource = resource;
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
 
+    void D3D12CommandList::barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
+        RenderScratchScope scratchScope;
+        RenderScratchArray<D3D12_RESOURCE_BARRIER> barrierVector;
         D3D12_RESOURCE_BARRIER resourceBarrier;
         const RenderBufferFlags bufferUAVMask = RenderBufferFlag::UNORDERED_ACCESS | RenderBufferFlag::ACCELERATION_STRUCTURE;
         for (uint32_t i = 0; i < bufferBarriersCount; i++) {
@@ -1921,7 +2013,7 @@ namespace plume {
             D3D12Buffer *interfaceBuffer = static_cast<D3D12Buffer *>(bufferBarrier.buffer);
             D3D12_RESOURCE_STATES stateBefore = interfaceBuffer->resourceStates;
             D3D12_RESOURCE_STATES stateAfter = toBufferState(stages, bufferBarrier.accessBits, interfaceBuffer->desc.flags);
-            if (makeBarrier(interfaceBuffer->d3d, stateBefore, stateAfter, interfaceBuffer->desc.flags & bufferUAVMask, resourceBarrier)) {
+            if (makeResourceBarrier(queue->type, interfaceBuffer->d3d, stateBefore, stateAfter, interfaceBuffer->desc.flags & bufferUAVMask, resourceBarrier)) {
                 barrierVector.emplace_back(resourceBarrier);
             }
 
@@ -1934,7 +2026,7 @@ namespace plume {
             D3D12Texture *interfaceTexture = static_cast<D3D12Texture *>(textureBarrier.texture);
             D3D12_RESOURCE_STATES stateBefore = interfaceTexture->resourceStates;
             D3D12_RESOURCE_STATES stateAfter = toTextureState(stages, textureBarrier.layout, interfaceTexture->desc.flags);
-            bool madeBarrier = makeBarrier(interfaceTexture->d3d, stateBefore, stateAfter, interfaceTexture->desc.flags & RenderTextureFlag::UNORDERED_ACCESS, resourceBarrier);
+            bool madeBarrier = makeResourceBarrier(queue->type, interfaceTexture->d3d, stateBefore, stateAfter, interfaceTexture->desc.flags & RenderTextureFlag::UNORDERED_ACCESS, resourceBarrier);
             interfaceTexture->resourceStates = stateAfter;
             interfaceTexture->layout = textureBarrier.layout;
             if (!madeBarrier) {
@@ -1962,6 +2054,86 @@ namespace plume {
         }
     }
 
+    uint32_t D3D12CommandList::beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
+        if (splitBarrierCount == splitBarriers.size()) {
+            splitBarriers.emplace_back();
+        }
+
+        const uint32_t splitIndex = splitBarrierCount++;
+        SplitBarrier &splitBarrier = splitBarriers[splitIndex];
+        splitBarrier.endBarriers.clear();
+        splitBarrier.active = true;
+
+        RenderScratchScope scratchScope;
+        RenderScratchArray<D3D12_RESOURCE_BARRIER> beginBarriers;
+
+        // Transitions are split in two halves, while UAV barriers can't be split and are only issued when the split ends.
+        auto splitBarrierFrom = [&](const D3D12_RESOURCE_BARRIER &resourceBarrier) {
+            if (resourceBarrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION) {
+                D3D12_RESOURCE_BARRIER &beginBarrier = beginBarriers.emplace_back(resourceBarrier);
+                beginBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+
+                D3D12_RESOURCE_BARRIER &endBarrier = splitBarrier.endBarriers.emplace_back(resourceBarrier);
+                endBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+            }
+            else {
+                splitBarrier.endBarriers.emplace_back(resourceBarrier);
+            }
+        };
+
+        D3D12_RESOURCE_BARRIER resourceBarrier;
+        const RenderBufferFlags bufferUAVMask = RenderBufferFlag::UNORDERED_ACCESS | RenderBufferFlag::ACCELERATION_STRUCTURE;
+        for (uint32_t i = 0; i < bufferBarriersCount; i++) {
+            const RenderBufferBarrier &bufferBarrier = bufferBarriers[i];
+            D3D12Buffer *interfaceBuffer = static_cast<D3D12Buffer *>(bufferBarrier.buffer);
+            D3D12_RESOURCE_STATES stateBefore = interfaceBuffer->resourceStates;
+            D3D12_RESOURCE_STATES stateAfter = toBufferState(stages, bufferBarrier.accessBits, interfaceBuffer->desc.flags);
+            if (makeResourceBarrier(queue->type, interfaceBuffer->d3d, stateBefore, stateAfter, interfaceBuffer->desc.flags & bufferUAVMask, resourceBarrier)) {
+                splitBarrierFrom(resourceBarrier);
+            }
+
+            interfaceBuffer->resourceStates = stateAfter;
+        }
+
+        for (uint32_t i = 0; i < textureBarriersCount; i++) {
+            const RenderTextureBarrier &textureBarrier = textureBarriers[i];
+            D3D12Texture *interfaceTexture = static_cast<D3D12Texture *>(textureBarrier.texture);
+
+            // MSAA depth targets with programmable sample positions need the positions set during the transition, so they're not split.
+            const bool msaaDepthTarget = (interfaceTexture->desc.flags & RenderTextureFlag::DEPTH_TARGET) && (interfaceTexture->desc.multisampling.sampleCount > 1);
+            if (msaaDepthTarget && interfaceTexture->desc.multisampling.sampleLocationsEnabled) {
+                barriers(stages, nullptr, 0, &textureBarrier, 1);
+                continue;
+            }
+
+            D3D12_RESOURCE_STATES stateBefore = interfaceTexture->resourceStates;
+            D3D12_RESOURCE_STATES stateAfter = toTextureState(stages, textureBarrier.layout, interfaceTexture->desc.flags);
+            if (makeResourceBarrier(queue->type, interfaceTexture->d3d, stateBefore, stateAfter, interfaceTexture->desc.flags & RenderTextureFlag::UNORDERED_ACCESS, resourceBarrier)) {
+                splitBarrierFrom(resourceBarrier);
+            }
+
+            interfaceTexture->resourceStates = stateAfter;
+            interfaceTexture->layout = textureBarrier.layout;
+        }
+
+        if (!beginBarriers.empty()) {
+            d3d->ResourceBarrier(UINT(beginBarriers.size()), beginBarriers.data());
+        }
+
+        return splitIndex;
+    }
+
+    void D3D12CommandList::endSplitBarriers(uint32_t splitIndex) {
+        assert((splitIndex < splitBarrierCount) && splitBarriers[splitIndex].active && "Split barriers must have begun in the same command list.");
+
+        SplitBarrier &splitBarrier = splitBarriers[splitIndex];
+        if (!splitBarrier.endBarriers.empty()) {
+            d3d->ResourceBarrier(UINT(splitBarrier.endBarriers.size()), splitBarrier.endBarriers.data());
+        }
+
+        splitBarrier.active = false;
+    }
+
     void D3D12CommandList::dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) {
         assert(activeComputePipelineLayout != nullptr);
 
@@ -2015,6 +2187,28 @@ namespace plume {
         d3d->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
     }
 
+    void D3D12CommandList::drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        assert(queue->device->capabilities.meshShader && "Mesh shaders are unsupported on this device.");
+        assert(activeGraphicsPipelineLayout != nullptr);
+        checkStencilRef();
+        checkFramebufferSamplePositions();
+
+        d3d->DispatchMesh(groupCountX, groupCountY, groupCountZ);
+    }
+
+    void D3D12CommandList::drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount, uint32_t stride) {
+        const D3D12Buffer *interfaceBuffer = static_cast<const D3D12Buffer *>(argumentBuffer.ref);
+        assert(queue->device->capabilities.meshShader && "Mesh shaders are unsupported on this device.");
+        assert(interfaceBuffer != nullptr);
+        assert((interfaceBuffer->desc.flags & RenderBufferFlag::INDIRECT) && "Buffer must allow being used as an indirect argument buffer.");
+        assert(activeGraphicsPipelineLayout != nullptr);
+        checkStencilRef();
+        checkFramebufferSamplePositions();
+
+        ID3D12CommandSignature *commandSignature = queue->device->getDispatchMeshSignature(stride);
+        d3d->ExecuteIndirect(commandSignature, drawCount, interfaceBuffer->d3d, argumentBuffer.offset, nullptr, 0);
+    }
+
     void D3D12CommandList::setPipeline(const RenderPipeline *pipeline) {
         assert(pipeline != nullptr);
 
@@ -2029,6 +2223,11 @@ namespace plume {
             const D3D12GraphicsPipeline *graphicsPipeline = static_cast<const D3D12GraphicsPipeline *>(interfacePipeline);
             d3d->SetPipelineState(graphicsPipeline->d3d);
             activeGraphicsPipeline = graphicsPipeline;
+
+            // The view instances are remapped to the layers of the view mask by the pipeline, so all of them are enabled.
+            if (graphicsPipeline->viewInstanceCount > 0) {
+                d3d->SetViewInstanceMask((1U << graphicsPipeline->viewInstanceCount) - 1U);
+            }
             break;
         }
         case D3D12Pipeline::Type::Raytracing: {
@@ -2128,8 +2327,9 @@ namespace plume {
         if (views != nullptr) {
             assert(inputSlots != nullptr);
 
-            thread_local std::vector<D3D12_VERTEX_BUFFER_VIEW> bufferViewVector;
-            bufferViewVector.resize(viewCount, {});
+            RenderScratchScope scratchScope;
+            RenderScratchArray<D3D12_VERTEX_BUFFER_VIEW> bufferViewVector;
+            bufferViewVector.resize(viewCount);
             for (uint32_t i = 0; i < viewCount; i++) {
                 const RenderVertexBufferView &renderView = views[i];
                 const D3D12Buffer *interfaceBuffer = static_cast<const D3D12Buffer *>(renderView.buffer.ref);
@@ -2157,8 +2357,8 @@ namespace plume {
 
     void D3D12CommandList::setViewports(const RenderViewport *viewports, uint32_t count) {
         if (count > 1) {
-            thread_local std::vector<D3D12_VIEWPORT> viewportVector;
-            viewportVector.clear();
+            RenderScratchScope scratchScope;
+            RenderScratchArray<D3D12_VIEWPORT> viewportVector;
             for (uint32_t i = 0; i < count; i++) {
                 viewportVector.emplace_back(D3D12_VIEWPORT{ viewports[i].x, viewports[i].y, viewports[i].width, viewports[i].height, viewports[i].minDepth, viewports[i].maxDepth });
             }
@@ -2176,8 +2376,8 @@ namespace plume {
 
     void D3D12CommandList::setScissors(const RenderRect *scissorRects, uint32_t count) {
         if (count > 1) {
-            thread_local std::vector<D3D12_RECT> rectVector;
-            rectVector.clear();
+            RenderScratchScope scratchScope;
+            RenderScratchArray<D3D12_RECT> rectVector;
             for (uint32_t i = 0; i < count; i++) {
                 rectVector.emplace_back(D3D12_RECT{ scissorRects[i].left, scissorRects[i].top, scissorRects[i].right, scissorRects[i].bottom });
             }
@@ -2227,6 +2427,68 @@ namespace plume {
 #   endif
     }
 
+    void D3D12CommandList::setCullMode(RenderCullMode cullMode) {
+        assert(false && "Dynamic cull mode is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setFrontFace(RenderFrontFace frontFace) {
+        assert(false && "Dynamic front face is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) {
+        // Applied along with the pipeline's state on the next draw call, which also filters out redundant changes.
+        dynamicTopology = toD3D12(primitiveTopology);
+    }
+
+    void D3D12CommandList::setDepthEnabled(bool depthEnabled) {
+        assert(false && "Dynamic depth test is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setDepthWriteEnabled(bool depthWriteEnabled) {
+        assert(false && "Dynamic depth write is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setDepthFunction(RenderComparisonFunction depthFunction) {
+        assert(false && "Dynamic depth function is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setStencilEnabled(bool stencilEnabled) {
+        assert(false && "Dynamic stencil test is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) {
+        assert(false && "Dynamic stencil operations are unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setStencilReference(uint32_t stencilReference) {
+        dynamicStencilRef = stencilReference;
+    }
+
+    void D3D12CommandList::setDepthBiasEnabled(bool depthBiasEnabled) {
+        assert(false && "Dynamic depth bias toggling is unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setDepthClipEnabled(bool depthClipEnabled) {
+        assert(false && "Dynamic depth clip is unsupported on D3D12.");
+    }
+
+    bool D3D12CommandList::setVertexInput(const RenderInputSlot *, uint32_t, const RenderInputElement *, uint32_t) {
+        assert(false && "Dynamic vertex input is unsupported on D3D12.");
+        return false;
+    }
+
+    void D3D12CommandList::setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) {
+        assert(false && "Shader objects are unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setComputeShaderObject(const RenderShaderObject *computeShader) {
+        assert(false && "Shader objects are unsupported on D3D12.");
+    }
+
+    void D3D12CommandList::setShaderObjectState(const RenderGraphicsPipelineDesc &desc) {
+        assert(false && "Shader objects are unsupported on D3D12.");
+    }
+
     void D3D12CommandList::clearColor(uint32_t attachmentIndex, RenderColor colorValue, const RenderRect *clearRects, uint32_t clearRectsCount) {
         assert(targetFramebuffer != nullptr);
         assert(attachmentIndex < targetFramebuffer->colorTargets.size());
@@ -2234,9 +2496,9 @@ namespace plume {
 
         checkFramebufferSamplePositions();
 
-        thread_local std::vector<D3D12_RECT> rectVector;
+        RenderScratchScope scratchScope;
+        RenderScratchArray<D3D12_RECT> rectVector;
         if (clearRectsCount > 0) {
-            rectVector.clear();
             for (uint32_t i = 0; i < clearRectsCount; i++) {
                 rectVector.emplace_back(D3D12_RECT{ clearRects[i].left, clearRects[i].top, clearRects[i].right, clearRects[i].bottom });
             }
@@ -2252,9 +2514,9 @@ namespace plume {
 
         checkFramebufferSamplePositions();
 
-        thread_local std::vector<D3D12_RECT> rectVector;
+        RenderScratchScope scratchScope;
+        RenderScratchArray<D3D12_RECT> rectVector;
         if (clearRectsCount > 0) {
-            rectVector.clear();
             for (uint32_t i = 0; i < clearRectsCount; i++) {
                 rectVector.emplace_back(D3D12_RECT{ clearRects[i].left, clearRects[i].top, clearRects[i].right, clearRects[i].bottom });
             }
@@ -2430,9 +2692,10 @@ namespace plume {
         assert(activeGraphicsPipeline->type == D3D12Pipeline::Type::Graphics);
 
         const D3D12GraphicsPipeline *graphicsPipeline = static_cast<const D3D12GraphicsPipeline *>(activeGraphicsPipeline);
-        if (activeTopology != graphicsPipeline->topology) {
-            d3d->IASetPrimitiveTopology(graphicsPipeline->topology);
-            activeTopology = graphicsPipeline->topology;
+        const D3D12_PRIMITIVE_TOPOLOGY topology = (graphicsPipeline->dynamicStates & RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY) ? dynamicTopology : graphicsPipeline->topology;
+        if (activeTopology != topology) {
+            d3d->IASetPrimitiveTopology(topology);
+            activeTopology = topology;
         }
     }
 
@@ -2441,9 +2704,10 @@ namespace plume {
         assert(activeGraphicsPipeline->type == D3D12Pipeline::Type::Graphics);
 
         const D3D12GraphicsPipeline *graphicsPipeline = static_cast<const D3D12GraphicsPipeline *>(activeGraphicsPipeline);
-        if (activeStencilRef != graphicsPipeline->stencilRef) {
-            d3d->OMSetStencilRef(graphicsPipeline->stencilRef);
-            activeStencilRef = graphicsPipeline->stencilRef;
+        const uint32_t stencilRef = (graphicsPipeline->dynamicStates & RenderDynamicStateFlag::STENCIL_REFERENCE) ? dynamicStencilRef : graphicsPipeline->stencilRef;
+        if (activeStencilRef != stencilRef) {
+            d3d->OMSetStencilRef(stencilRef);
+            activeStencilRef = stencilRef;
         }
     }
     
@@ -2462,15 +2726,16 @@ namespace plume {
 
         const D3D12Texture *interfaceTexture = static_cast<const D3D12Texture *>(texture);
         if (interfaceTexture->desc.multisampling.sampleLocationsEnabled) {
-            thread_local std::vector<D3D12_SAMPLE_POSITION> samplePositions;
-            samplePositions.resize(interfaceTexture->desc.multisampling.sampleCount);
+            assert((interfaceTexture->desc.multisampling.sampleCount <= RenderMultisampling::MaxSampleLocations) && "Sample count exceeds the maximum amount of sample locations.");
+
+            D3D12_SAMPLE_POSITION samplePositions[RenderMultisampling::MaxSampleLocations];
             for (uint32_t i = 0; i < interfaceTexture->desc.multisampling.sampleCount; i++) {
                 const RenderMultisamplingLocation &location = interfaceTexture->desc.multisampling.sampleLocations[i];
                 samplePositions[i].X = location.x;
                 samplePositions[i].Y = location.y;
             }
 
-            d3d->SetSamplePositions(uint32_t(samplePositions.size()), 1, samplePositions.data());
+            d3d->SetSamplePositions(interfaceTexture->desc.multisampling.sampleCount, 1, samplePositions);
             activeSamplePositions = true;
         }
         else {
@@ -2582,12 +2847,15 @@ namespace plume {
 
     // D3D12CommandSemaphore
 
-    D3D12CommandSemaphore::D3D12CommandSemaphore(D3D12Device *device) {
+    D3D12CommandSemaphore::D3D12CommandSemaphore(D3D12Device *device, RenderExternalHandleType exportHandleType) {
         assert(device != nullptr);
+        assert(((exportHandleType == RenderExternalHandleType::NONE) || (exportHandleType == RenderExternalHandleType::OPAQUE)) && "Semaphores only support opaque handles.");
 
         this->device = device;
+        this->exportHandleType = exportHandleType;
+        this->shared = (exportHandleType != RenderExternalHandleType::NONE);
 
-        HRESULT res = device->d3d->CreateFence(1, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&d3d));
+        HRESULT res = device->d3d->CreateFence(1, shared ? D3D12_FENCE_FLAG_SHARED : D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&d3d));
         if (FAILED(res)) {
             fprintf(stderr, "CreateFence failed with error code 0x%lX.\n", res);
             return;
@@ -2596,12 +2864,42 @@ namespace plume {
         semaphoreValue = 1;
     }
 
+    D3D12CommandSemaphore::D3D12CommandSemaphore(D3D12Device *device, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(device != nullptr);
+        assert((handleType == RenderExternalHandleType::OPAQUE) && "Semaphores only support opaque handles.");
+
+        this->device = device;
+        this->shared = true;
+
+        HRESULT res = device->d3d->OpenSharedHandle(HANDLE(handle), IID_PPV_ARGS(&d3d));
+        if (FAILED(res)) {
+            fprintf(stderr, "OpenSharedHandle failed with error code 0x%lX.\n", res);
+            return;
+        }
+
+        CloseHandle(HANDLE(handle));
+        semaphoreValue = d3d->GetCompletedValue();
+    }
+
     D3D12CommandSemaphore::~D3D12CommandSemaphore() {
         if (d3d != nullptr) {
             d3d->Release();
         }
     }
 
+    RenderExternalHandle D3D12CommandSemaphore::exportHandle() {
+        assert((exportHandleType != RenderExternalHandleType::NONE) && "Semaphore must have been created with an export handle type.");
+
+        HANDLE handle = nullptr;
+        HRESULT res = device->d3d->CreateSharedHandle(d3d, nullptr, GENERIC_ALL, nullptr, &handle);
+        if (FAILED(res)) {
+            fprintf(stderr, "CreateSharedHandle failed with error code 0x%lX.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(handle);
+    }
+
     // D3D12CommandQueue
 
     D3D12CommandQueue::D3D12CommandQueue(D3D12Device *device, RenderCommandListType type) {
@@ -2643,8 +2941,8 @@ namespace plume {
         }
     }
 
-    std::unique_ptr<RenderCommandList> D3D12CommandQueue::createCommandList() {
-        return std::make_unique<D3D12CommandList>(this);
+    std::unique_ptr<RenderCommandList> D3D12CommandQueue::createCommandList(const RenderCommandListDesc &desc) {
+        return std::make_unique<D3D12CommandList>(this, desc);
     }
 
     std::unique_ptr<RenderSwapChain> D3D12CommandQueue::createSwapChain(RenderWindow renderWindow, uint32_t bufferCount, RenderFormat format, uint32_t maxFrameLatency) {
@@ -2657,11 +2955,17 @@ namespace plume {
 
         for (uint32_t i = 0; i < waitSemaphoreCount; i++) {
             D3D12CommandSemaphore *interfaceSemaphore = static_cast<D3D12CommandSemaphore *>(waitSemaphores[i]);
+
+            // The fence of a shared semaphore is signaled on the other side, so each wait must target the value of the next signal.
+            if (interfaceSemaphore->shared) {
+                interfaceSemaphore->semaphoreValue++;
+            }
+
             d3d->Wait(interfaceSemaphore->d3d, interfaceSemaphore->semaphoreValue);
         }
 
-        thread_local std::vector<ID3D12CommandList *> executionVector;
-        executionVector.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<ID3D12CommandList *> executionVector;
         for (uint32_t i = 0; i < commandListCount; i++) {
             const D3D12CommandList *interfaceCommandList = static_cast<const D3D12CommandList *>(commandLists[i]);
             executionVector.emplace_back(static_cast<ID3D12CommandList *>(interfaceCommandList->d3d));
@@ -2734,6 +3038,14 @@ namespace plume {
         allocationDesc.HeapType = toD3D12(desc.heapType);
         allocationDesc.CustomPool = (pool != nullptr) ? pool->d3d : nullptr;
 
+        // Shared resources require their own heap.
+        if (desc.exportHandleType != RenderExternalHandleType::NONE) {
+            assert((desc.exportHandleType == RenderExternalHandleType::OPAQUE) && "Buffers only support opaque handles.");
+            allocationDesc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+            allocationDesc.ExtraHeapFlags = D3D12_HEAP_FLAG_SHARED;
+            allocationDesc.CustomPool = nullptr;
+        }
+
         HRESULT res = device->allocator->CreateResource(&allocationDesc, &resourceDesc, resourceStates, nullptr, &allocation, IID_PPV_ARGS(&d3d));
         if (FAILED(res)) {
             fprintf(stderr, "CreateResource failed with error code 0x%lX.\n", res);
@@ -2741,14 +3053,88 @@ namespace plume {
         }
     }
 
+    D3D12Buffer::D3D12Buffer(D3D12Device *device, void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        assert(device != nullptr);
+        assert(hostPointer != nullptr);
+        assert(device->capabilities.hostMemoryImport && "Importing host memory is unsupported on this device.");
+
+        const uint64_t importAlignment = device->capabilities.hostMemoryImportAlignment;
+        assert((((uintptr_t(hostPointer) % importAlignment) == 0) && ((size % importAlignment) == 0)) && "Host memory must be aligned to the import alignment.");
+
+        this->device = device;
+        this->hostPointer = hostPointer;
+        desc = RenderBufferDesc::UploadBuffer(size, flags);
+
+        HRESULT res = device->d3d->OpenExistingHeapFromAddress(hostPointer, IID_PPV_ARGS(&hostHeap));
+        if (FAILED(res)) {
+            fprintf(stderr, "OpenExistingHeapFromAddress failed with error code 0x%lX.\n", res);
+            return;
+        }
+
+        D3D12_RESOURCE_DESC resourceDesc = {};
+        resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        resourceDesc.Width = size;
+        resourceDesc.Height = 1;
+        resourceDesc.DepthOrArraySize = 1;
+        resourceDesc.MipLevels = 1;
+        resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+        resourceDesc.SampleDesc.Count = 1;
+        resourceDesc.SampleDesc.Quality = 0;
+        resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+        // Heaps opened from an address are shared across adapters, which requires the resources placed in them to be as well.
+        resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER;
+        resourceDesc.Flags |= (flags & RenderBufferFlag::UNORDERED_ACCESS) ? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS : D3D12_RESOURCE_FLAG_NONE;
+
+        // Buffers are promoted implicitly from the common state to the state of their first use.
+        resourceStates = D3D12_RESOURCE_STATE_COMMON;
+
+        res = device->d3d->CreatePlacedResource(hostHeap, 0, &resourceDesc, resourceStates, nullptr, IID_PPV_ARGS(&d3d));
+        if (FAILED(res)) {
+            fprintf(stderr, "CreatePlacedResource failed with error code 0x%lX.\n", res);
+            return;
+        }
+    }
+
+    D3D12Buffer::D3D12Buffer(D3D12Device *device, const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(device != nullptr);
+        assert((handleType == RenderExternalHandleType::OPAQUE) && "Buffers only support opaque handles.");
+
+        this->device = device;
+        this->desc = desc;
+
+        HRESULT res = device->d3d->OpenSharedHandle(HANDLE(handle), IID_PPV_ARGS(&d3d));
+        if (FAILED(res)) {
+            fprintf(stderr, "OpenSharedHandle failed with error code 0x%lX.\n", res);
+            return;
+        }
+
+        CloseHandle(HANDLE(handle));
+    }
+
     D3D12Buffer::~D3D12Buffer() {
         if (allocation != nullptr) {
             d3d->Release();
             allocation->Release();
         }
+        else if (hostHeap != nullptr) {
+            if (d3d != nullptr) {
+                d3d->Release();
+            }
+
+            hostHeap->Release();
+        }
+        else if (d3d != nullptr) {
+            d3d->Release();
+        }
     }
 
     void *D3D12Buffer::map(uint32_t subresource, const RenderRange *readRange) {
+        // Imported memory is always accessible through the original pointer.
+        if (hostPointer != nullptr) {
+            return hostPointer;
+        }
+
         D3D12_RANGE range;
         if (readRange != nullptr) {
             range.Begin = readRange->begin;
@@ -2761,6 +3147,10 @@ namespace plume {
     }
 
     void D3D12Buffer::unmap(uint32_t subresource, const RenderRange *writtenRange) {
+        if (hostPointer != nullptr) {
+            return;
+        }
+
         D3D12_RANGE range;
         if (writtenRange != nullptr) {
             range.Begin = writtenRange->begin;
@@ -2783,6 +3173,19 @@ namespace plume {
         return d3d->GetGPUVirtualAddress();
     }
 
+    RenderExternalHandle D3D12Buffer::exportMemory() {
+        assert((desc.exportHandleType != RenderExternalHandleType::NONE) && "Buffer must have been created with an export handle type.");
+
+        HANDLE handle = nullptr;
+        HRESULT res = device->d3d->CreateSharedHandle(d3d, nullptr, GENERIC_ALL, nullptr, &handle);
+        if (FAILED(res)) {
+            fprintf(stderr, "CreateSharedHandle failed with error code 0x%lX.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(handle);
+    }
+
     // D3D12BufferFormattedView
 
     D3D12BufferFormattedView::D3D12BufferFormattedView(D3D12Buffer *buffer, RenderFormat format) {
@@ -2844,6 +3247,14 @@ namespace plume {
         allocationDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
         allocationDesc.CustomPool = (pool != nullptr) ? pool->d3d : nullptr;
 
+        // Shared resources require their own heap.
+        if (desc.exportHandleType != RenderExternalHandleType::NONE) {
+            assert((desc.exportHandleType == RenderExternalHandleType::OPAQUE) && "Textures only support opaque handles.");
+            allocationDesc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+            allocationDesc.ExtraHeapFlags = D3D12_HEAP_FLAG_SHARED;
+            allocationDesc.CustomPool = nullptr;
+        }
+
         D3D12_CLEAR_VALUE optimizedClearValue;
         if (desc.optimizedClearValue != nullptr) {
             optimizedClearValue.Format = toDXGI(desc.optimizedClearValue->format);
@@ -2857,11 +3268,31 @@ namespace plume {
         }
     }
 
+    D3D12Texture::D3D12Texture(D3D12Device *device, const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(device != nullptr);
+        assert((handleType == RenderExternalHandleType::OPAQUE) && "Textures only support opaque handles.");
+
+        this->device = device;
+        this->desc = desc;
+        this->imported = true;
+
+        HRESULT res = device->d3d->OpenSharedHandle(HANDLE(handle), IID_PPV_ARGS(&d3d));
+        if (FAILED(res)) {
+            fprintf(stderr, "OpenSharedHandle failed with error code 0x%lX.\n", res);
+            return;
+        }
+
+        CloseHandle(HANDLE(handle));
+    }
+
     D3D12Texture::~D3D12Texture() {
         if (allocation != nullptr) {
             d3d->Release();
             allocation->Release();
         }
+        else if (imported && (d3d != nullptr)) {
+            d3d->Release();
+        }
     }
 
     std::unique_ptr<RenderTextureView> D3D12Texture::createTextureView(const RenderTextureViewDesc &desc) const {
@@ -2872,6 +3303,19 @@ namespace plume {
         setObjectName(d3d, name);
     }
 
+    RenderExternalHandle D3D12Texture::exportMemory() {
+        assert((desc.exportHandleType != RenderExternalHandleType::NONE) && "Texture must have been created with an export handle type.");
+
+        HANDLE handle = nullptr;
+        HRESULT res = device->d3d->CreateSharedHandle(d3d, nullptr, GENERIC_ALL, nullptr, &handle);
+        if (FAILED(res)) {
+            fprintf(stderr, "CreateSharedHandle failed with error code 0x%lX.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(handle);
+    }
+
     // D3D12AccelerationStructure
 
     D3D12AccelerationStructure::D3D12AccelerationStructure(D3D12Device *device, const RenderAccelerationStructureDesc &desc) {
@@ -3048,15 +3492,54 @@ namespace plume {
 
     // D3D12GraphicsPipeline
 
+    // Mesh pipelines can only be created from a pipeline state stream. Each subobject must be aligned to the size of a pointer.
+    template<typename T, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type>
+    struct alignas(void *) D3D12PipelineStateSubobject {
+        D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type = Type;
+        T value = {};
+    };
+
+    struct D3D12GraphicsPipelineStateStream {
+        D3D12PipelineStateSubobject<ID3D12RootSignature *, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE> rootSignature;
+        D3D12PipelineStateSubobject<D3D12_SHADER_BYTECODE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VS> VS;
+        D3D12PipelineStateSubobject<D3D12_SHADER_BYTECODE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_GS> GS;
+        D3D12PipelineStateSubobject<D3D12_SHADER_BYTECODE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS> AS;
+        D3D12PipelineStateSubobject<D3D12_SHADER_BYTECODE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS> MS;
+        D3D12PipelineStateSubobject<D3D12_SHADER_BYTECODE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS> PS;
+        D3D12PipelineStateSubobject<D3D12_BLEND_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND> blendState;
+        D3D12PipelineStateSubobject<UINT, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK> sampleMask;
+        D3D12PipelineStateSubobject<D3D12_RASTERIZER_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER> rasterizerState;
+        D3D12PipelineStateSubobject<D3D12_DEPTH_STENCIL_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL> depthStencilState;
+        D3D12PipelineStateSubobject<D3D12_RT_FORMAT_ARRAY, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS> renderTargetFormats;
+        D3D12PipelineStateSubobject<DXGI_FORMAT, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT> depthStencilFormat;
+        D3D12PipelineStateSubobject<DXGI_SAMPLE_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC> sampleDesc;
+        D3D12PipelineStateSubobject<D3D12_INPUT_LAYOUT_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_INPUT_LAYOUT> inputLayout;
+        D3D12PipelineStateSubobject<D3D12_INDEX_BUFFER_STRIP_CUT_VALUE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_IB_STRIP_CUT_VALUE> IBStripCutValue;
+        D3D12PipelineStateSubobject<D3D12_PRIMITIVE_TOPOLOGY_TYPE, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY> primitiveTopologyType;
+        D3D12PipelineStateSubobject<D3D12_PIPELINE_STATE_FLAGS, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_FLAGS> flags;
+        D3D12PipelineStateSubobject<D3D12_VIEW_INSTANCING_DESC, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VIEW_INSTANCING> viewInstancing;
+    };
+
     D3D12GraphicsPipeline::D3D12GraphicsPipeline(D3D12Device *device, const RenderGraphicsPipelineDesc &desc) : D3D12Pipeline(device, Type::Graphics) {
         assert(desc.pipelineLayout != nullptr);
 
+        assert(((desc.dynamicStates & ~device->capabilities.dynamicStates) == 0) && "Dynamic states are unsupported on this device.");
+
         topology = toD3D12(desc.primitiveTopology);
+        stencilRef = desc.stencilReference;
+        dynamicStates = desc.dynamicStates;
 
         const D3D12PipelineLayout *pipelineLayout = static_cast<const D3D12PipelineLayout *>(desc.pipelineLayout);
         const D3D12Shader *vertexShader = static_cast<const D3D12Shader *>(desc.vertexShader);
         const D3D12Shader *geometryShader = static_cast<const D3D12Shader *>(desc.geometryShader);
         const D3D12Shader *pixelShader = static_cast<const D3D12Shader *>(desc.pixelShader);
+        const D3D12Shader *taskShader = static_cast<const D3D12Shader *>(desc.taskShader);
+        const D3D12Shader *meshShader = static_cast<const D3D12Shader *>(desc.meshShader);
+        assert(((meshShader == nullptr) || device->capabilities.meshShader) && "Mesh shaders are unsupported on this device.");
+        assert(((meshShader == nullptr) || ((vertexShader == nullptr) && (geometryShader == nullptr))) && "Mesh pipelines can't use vertex or geometry shaders.");
+        assert(((taskShader == nullptr) || (meshShader != nullptr)) && "Task shaders require a mesh shader.");
+        assert(((desc.viewMask == 0) || device->capabilities.multiview) && "Multiview is unsupported on this device.");
+
         D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
         psoDesc.pRootSignature = pipelineLayout->rootSignature;
         psoDesc.VS.pShaderBytecode = (vertexShader != nullptr) ? vertexShader->d3d.data() : nullptr;
@@ -3173,7 +3656,60 @@ namespace plume {
 
         psoDesc.InputLayout = { inputElements.data(), UINT(inputElements.size()) };
 
-        device->d3d->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&d3d));
+        // Each view instance is routed to the render target array slice of the corresponding bit in the view mask.
+        D3D12_VIEW_INSTANCE_LOCATION viewInstanceLocations[D3D12_MAX_VIEW_INSTANCE_COUNT] = {};
+        for (uint32_t i = 0; i < 32; i++) {
+            if (desc.viewMask & (1U << i)) {
+                if (viewInstanceCount == D3D12_MAX_VIEW_INSTANCE_COUNT) {
+                    assert(false && "View mask exceeds the amount of views supported by the device.");
+                    break;
+                }
+
+                viewInstanceLocations[viewInstanceCount].RenderTargetArrayIndex = i;
+                viewInstanceCount++;
+            }
+        }
+
+        if ((meshShader != nullptr) || (viewInstanceCount > 0)) {
+            // Reuse the state filled out for the regular description in the stream.
+            D3D12GraphicsPipelineStateStream stream;
+            stream.rootSignature.value = psoDesc.pRootSignature;
+            stream.PS.value = psoDesc.PS;
+            stream.blendState.value = psoDesc.BlendState;
+            stream.sampleMask.value = psoDesc.SampleMask;
+            stream.rasterizerState.value = psoDesc.RasterizerState;
+            stream.depthStencilState.value = psoDesc.DepthStencilState;
+            stream.renderTargetFormats.value.NumRenderTargets = psoDesc.NumRenderTargets;
+            memcpy(stream.renderTargetFormats.value.RTFormats, psoDesc.RTVFormats, sizeof(psoDesc.RTVFormats));
+            stream.depthStencilFormat.value = psoDesc.DSVFormat;
+            stream.sampleDesc.value = psoDesc.SampleDesc;
+            stream.flags.value = psoDesc.Flags;
+            stream.viewInstancing.value.ViewInstanceCount = viewInstanceCount;
+            stream.viewInstancing.value.pViewInstanceLocations = (viewInstanceCount > 0) ? viewInstanceLocations : nullptr;
+
+            // Only one of the geometry paths is filled out, as view instancing can also be used by pipelines with a vertex shader.
+            if (meshShader != nullptr) {
+                stream.AS.value.pShaderBytecode = (taskShader != nullptr) ? taskShader->d3d.data() : nullptr;
+                stream.AS.value.BytecodeLength = (taskShader != nullptr) ? taskShader->d3d.size() : 0;
+                stream.MS.value.pShaderBytecode = meshShader->d3d.data();
+                stream.MS.value.BytecodeLength = meshShader->d3d.size();
+            }
+            else {
+                stream.VS.value = psoDesc.VS;
+                stream.GS.value = psoDesc.GS;
+                stream.inputLayout.value = psoDesc.InputLayout;
+                stream.IBStripCutValue.value = psoDesc.IBStripCutValue;
+                stream.primitiveTopologyType.value = psoDesc.PrimitiveTopologyType;
+            }
+
+            D3D12_PIPELINE_STATE_STREAM_DESC streamDesc = {};
+            streamDesc.SizeInBytes = sizeof(stream);
+            streamDesc.pPipelineStateSubobjectStream = &stream;
+            device->d3d->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&d3d));
+        }
+        else {
+            device->d3d->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&d3d));
+        }
     }
 
     D3D12GraphicsPipeline::~D3D12GraphicsPipeline() {
@@ -3424,10 +3960,9 @@ namespace plume {
         this->device = device;
         this->setCount = desc.descriptorSetDescsCount;
 
-        thread_local std::vector<D3D12_ROOT_PARAMETER> rootParameters;
-        thread_local std::vector<D3D12_STATIC_SAMPLER_DESC> staticSamplers;
-        rootParameters.clear();
-        staticSamplers.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<D3D12_ROOT_PARAMETER> rootParameters;
+        RenderScratchArray<D3D12_STATIC_SAMPLER_DESC> staticSamplers;
 
         // Push constants will be the first root parameters of the signature.
         for (uint32_t i = 0; i < desc.pushConstantRangesCount; i++) {
@@ -3461,8 +3996,8 @@ namespace plume {
             }
         }
 
-        thread_local std::vector<D3D12_DESCRIPTOR_RANGE> viewRanges;
-        thread_local std::vector<D3D12_DESCRIPTOR_RANGE> samplerRanges;
+        RenderScratchArray<D3D12_DESCRIPTOR_RANGE> viewRanges;
+        RenderScratchArray<D3D12_DESCRIPTOR_RANGE> samplerRanges;
         uint32_t viewRangeIndex = 0;
         uint32_t samplerRangeIndex = 0;
         viewRanges.resize(viewRangesCount);
@@ -3679,6 +4214,22 @@ namespace plume {
                 rtStateUpdateSupportOption = d3d12Options5.RaytracingTier >= D3D12_RAYTRACING_TIER_1_1;
             }
 
+            // Determine if the device supports mesh shaders.
+            bool meshShaderOption = false;
+            D3D12_FEATURE_DATA_D3D12_OPTIONS7 d3d12Options7 = {};
+            res = deviceOption->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &d3d12Options7, sizeof(d3d12Options7));
+            if (SUCCEEDED(res)) {
+                meshShaderOption = d3d12Options7.MeshShaderTier >= D3D12_MESH_SHADER_TIER_1;
+            }
+
+            // Determine if the device supports view instancing.
+            bool viewInstancingOption = false;
+            D3D12_FEATURE_DATA_D3D12_OPTIONS3 d3d12Options3 = {};
+            res = deviceOption->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS3, &d3d12Options3, sizeof(d3d12Options3));
+            if (SUCCEEDED(res)) {
+                viewInstancingOption = d3d12Options3.ViewInstancingTier >= D3D12_VIEW_INSTANCING_TIER_1;
+            }
+
             bool triangleFanSupportOption = false;
             bool dynamicDepthBiasOption = false;
             bool gpuUploadHeapOption = false;
@@ -3700,6 +4251,14 @@ namespace plume {
             }
 #       endif
 
+            // Check if heaps can be opened from existing host memory.
+            bool existingHeapsOption = false;
+            D3D12_FEATURE_DATA_EXISTING_HEAPS existingHeaps = {};
+            res = deviceOption->CheckFeatureSupport(D3D12_FEATURE_EXISTING_HEAPS, &existingHeaps, sizeof(existingHeaps));
+            if (SUCCEEDED(res)) {
+                existingHeapsOption = existingHeaps.Supported;
+            }
+
             // Check if the architecture has UMA.
             bool uma = false;
             D3D12_FEATURE_DATA_ARCHITECTURE1 architecture1 = {};
@@ -3727,6 +4286,12 @@ namespace plume {
                 d3d = deviceOption;
                 shaderModel = dataShaderModel.HighestShaderModel;
                 capabilities.geometryShader = true;
+                capabilities.meshShader = meshShaderOption;
+                capabilities.multiview = viewInstancingOption;
+                capabilities.maxMultiviewViewCount = viewInstancingOption ? D3D12_MAX_VIEW_INSTANCE_COUNT : 0;
+                capabilities.layerOutputFromVertex = true;
+                capabilities.textureCompressionBC = true;
+                capabilities.maxFramebufferLayers = D3D12_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION;
                 capabilities.raytracing = rtSupportOption;
                 capabilities.raytracingStateUpdate = rtStateUpdateSupportOption;
                 capabilities.sampleLocations = samplePositionsOption;
@@ -3736,6 +4301,18 @@ namespace plume {
                 capabilities.dynamicDepthBias = dynamicDepthBiasOption;
                 capabilities.uma = uma;
 
+                // Closed command lists can always be executed again, including while a previous execution is in flight.
+                capabilities.reusableCommandLists = true;
+
+                // Opened heaps must start at an address aligned to the allocation granularity.
+                capabilities.hostMemoryImport = existingHeapsOption;
+                capabilities.hostMemoryImportAlignment = existingHeapsOption ? D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT : 0;
+
+                // Resources and fences can always be shared through NT handles.
+                capabilities.externalMemory = true;
+                capabilities.externalMemoryDmaBuf = false;
+                capabilities.externalSemaphore = true;
+
                 // Pretend GPU Upload heaps are supported if UMA is supported, as
                 // the backend has a workaround using a custom pool for it.
                 capabilities.gpuUploadHeap = uma || gpuUploadHeapOption;
@@ -3835,6 +4412,29 @@ namespace plume {
         capabilities.maxTextureSize = 16384;
         capabilities.preferHDR = description.dedicatedVideoMemory > (512 * 1024 * 1024);
         capabilities.samplerMirrorClampToEdge = true;
+        capabilities.dynamicStates = RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY | RenderDynamicStateFlag::STENCIL_REFERENCE | RenderDynamicStateFlag::VERTEX_BUFFER_STRIDE;
+
+        // Cache the support for all formats.
+        formatSupport.resize(size_t(RenderFormat::MAX));
+        for (uint32_t i = uint32_t(RenderFormat::UNKNOWN) + 1; i < uint32_t(RenderFormat::MAX); i++) {
+            D3D12_FEATURE_DATA_FORMAT_SUPPORT dataFormatSupport = {};
+            dataFormatSupport.Format = toDXGI(RenderFormat(i));
+            if (dataFormatSupport.Format == DXGI_FORMAT_UNKNOWN) {
+                continue;
+            }
+            res = d3d->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &dataFormatSupport, sizeof(dataFormatSupport));
+            if (FAILED(res)) {
+                continue;
+            }
+
+            RenderFormatSupport &support = formatSupport[i];
+            support.flags = toFormatSupportFlags(dataFormatSupport);
+
+            // Sample counts are only reported for formats that can be used as targets.
+            if (support.flags & (RenderFormatSupportFlag::RENDER_TARGET | RenderFormatSupportFlag::DEPTH_TARGET)) {
+                support.sampleCounts = getSampleCountsSupported(RenderFormat(i));
+            }
+        }
 
         // Create descriptor heaps allocator.
         viewHeapAllocator = std::make_unique<D3D12DescriptorHeapAllocator>(this, ShaderDescriptorHeapSize, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -3873,6 +4473,11 @@ namespace plume {
         return std::make_unique<D3D12Shader>(this, data, size, entryPointName, format);
     }
 
+    std::vector<std::unique_ptr<RenderShaderObject>> D3D12Device::createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked) {
+        assert(false && "Shader objects are unsupported on D3D12.");
+        return std::vector<std::unique_ptr<RenderShaderObject>>();
+    }
+
     std::unique_ptr<RenderSampler> D3D12Device::createSampler(const RenderSamplerDesc &desc) {
         return std::make_unique<D3D12Sampler>(this, desc);
     }
@@ -3893,6 +4498,10 @@ namespace plume {
         return std::make_unique<D3D12CommandQueue>(this, type);
     }
     
+    std::unique_ptr<RenderBuffer> D3D12Device::createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        return std::make_unique<D3D12Buffer>(this, hostPointer, size, flags);
+    }
+
     std::unique_ptr<RenderBuffer> D3D12Device::createBuffer(const RenderBufferDesc &desc) {
         if ((desc.heapType == RenderHeapType::GPU_UPLOAD) && gpuUploadHeapFallback) {
             return std::make_unique<D3D12Buffer>(this, customUploadPool.get(), desc);
@@ -3906,6 +4515,33 @@ namespace plume {
         return std::make_unique<D3D12Texture>(this, nullptr, desc);
     }
 
+    std::unique_ptr<RenderBuffer> D3D12Device::createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableHandle(handle)) {
+            fprintf(stderr, "Unable to import buffer memory from an invalid handle.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<D3D12Buffer>(this, desc, handleType, handle);
+    }
+
+    std::unique_ptr<RenderTexture> D3D12Device::createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableHandle(handle)) {
+            fprintf(stderr, "Unable to import texture memory from an invalid handle.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<D3D12Texture>(this, desc, handleType, handle);
+    }
+
+    std::unique_ptr<RenderCommandSemaphore> D3D12Device::createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableHandle(handle)) {
+            fprintf(stderr, "Unable to import semaphore from an invalid handle.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<D3D12CommandSemaphore>(this, handleType, handle);
+    }
+
     std::unique_ptr<RenderAccelerationStructure> D3D12Device::createAccelerationStructure(const RenderAccelerationStructureDesc &desc) {
         return std::make_unique<D3D12AccelerationStructure>(this, desc);
     }
@@ -3922,8 +4558,8 @@ namespace plume {
         return std::make_unique<D3D12CommandFence>(this);
     }
 
-    std::unique_ptr<RenderCommandSemaphore> D3D12Device::createCommandSemaphore() {
-        return std::make_unique<D3D12CommandSemaphore>(this);
+    std::unique_ptr<RenderCommandSemaphore> D3D12Device::createCommandSemaphore(RenderExternalHandleType exportHandleType) {
+        return std::make_unique<D3D12CommandSemaphore>(this, exportHandleType);
     }
 
     std::unique_ptr<RenderFramebuffer> D3D12Device::createFramebuffer(const RenderFramebufferDesc &desc) {
@@ -4052,9 +4688,9 @@ namespace plume {
         tableInfo.tableBufferData.clear();
         tableInfo.tableBufferData.resize(tableSize, 0);
         
-        thread_local std::vector<UINT64> descriptorHandles;
-        descriptorHandles.clear();
-        descriptorHandles.resize(raytracingPipeline->pipelineLayout->rootCount, 0);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<UINT64> descriptorHandles;
+        descriptorHandles.resize(raytracingPipeline->pipelineLayout->rootCount);
 
         for (uint32_t i = 0; i < raytracingPipeline->pipelineLayout->setCount; i++) {
             const D3D12DescriptorSet *interfaceDescriptorSet = static_cast<const D3D12DescriptorSet *>(descriptorSets[i]);
@@ -4120,7 +4756,46 @@ namespace plume {
         return countsSupported;
     }
 
+    RenderFormatSupport D3D12Device::getFormatSupport(RenderFormat format) const {
+        assert(uint32_t(format) < formatSupport.size());
+        return formatSupport[uint32_t(format)];
+    }
+
+    ID3D12CommandSignature *D3D12Device::getDispatchMeshSignature(uint32_t stride) {
+        assert((stride >= sizeof(D3D12_DISPATCH_MESH_ARGUMENTS)) && ((stride % 4) == 0));
+
+        const std::scoped_lock lock(dispatchMeshSignaturesMutex);
+        auto it = dispatchMeshSignatures.find(stride);
+        if (it != dispatchMeshSignatures.end()) {
+            return it->second;
+        }
+
+        D3D12_INDIRECT_ARGUMENT_DESC argumentDesc = {};
+        argumentDesc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH;
+
+        D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+        signatureDesc.ByteStride = stride;
+        signatureDesc.NumArgumentDescs = 1;
+        signatureDesc.pArgumentDescs = &argumentDesc;
+
+        ID3D12CommandSignature *commandSignature = nullptr;
+        HRESULT res = d3d->CreateCommandSignature(&signatureDesc, nullptr, IID_PPV_ARGS(&commandSignature));
+        if (FAILED(res)) {
+            fprintf(stderr, "CreateCommandSignature failed with error code 0x%lX.\n", res);
+            return nullptr;
+        }
+
+        dispatchMeshSignatures[stride] = commandSignature;
+        return commandSignature;
+    }
+
     void D3D12Device::release() {
+        for (auto &it : dispatchMeshSignatures) {
+            it.second->Release();
+        }
+
+        dispatchMeshSignatures.clear();
+
         if (d3d != nullptr) {
             d3d->Release();
             d3d = nullptr;
@@ -74,7 +74,7 @@ namespace plume {
         D3D12_GPU_DESCRIPTOR_HANDLE getGPUHandleAt(uint32_t index) const;
     };
 
-    struct D3D12DescriptorSet : RenderDescriptorSet {
+    struct D3D12DescriptorSet final : RenderDescriptorSet {
         D3D12Device *device = nullptr;
 
         struct HeapAllocation {
@@ -90,8 +90,8 @@ namespace plume {
 
         D3D12DescriptorSet(D3D12Device *device, const RenderDescriptorSetDesc &desc);
         ~D3D12DescriptorSet() override;
-        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize, const RenderBufferStructuredView *bufferStructuredView, const RenderBufferFormattedView *bufferFormattedView) override;
-        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView) override;
+        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize = 0, const RenderBufferStructuredView *bufferStructuredView = nullptr, const RenderBufferFormattedView *bufferFormattedView = nullptr) override;
+        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView = nullptr) override;
         void setSampler(uint32_t descriptorIndex, const RenderSampler *sampler) override;
         void setAccelerationStructure(uint32_t descriptorIndex, const RenderAccelerationStructure *accelerationStructure) override;
         void setSRV(uint32_t descriptorIndex, ID3D12Resource *resource, const D3D12_SHADER_RESOURCE_VIEW_DESC *viewDesc);
@@ -99,7 +99,7 @@ namespace plume {
         void setCBV(uint32_t descriptorIndex, ID3D12Resource *resource, uint64_t bufferSize);
     };
 
-    struct D3D12SwapChain : RenderSwapChain {
+    struct D3D12SwapChain final : RenderSwapChain {
         IDXGISwapChain3 *d3d = nullptr;
         HANDLE waitableObject = 0;
         D3D12CommandQueue *commandQueue = nullptr;
@@ -134,7 +134,7 @@ namespace plume {
         void setTextures();
     };
 
-    struct D3D12Framebuffer : RenderFramebuffer {
+    struct D3D12Framebuffer final : RenderFramebuffer {
         D3D12Device *device = nullptr;
         uint32_t width = 0;
         uint32_t height = 0;
@@ -144,6 +144,7 @@ namespace plume {
         std::vector<uint32_t> colorTargetAllocatorOffsets;
         D3D12_CPU_DESCRIPTOR_HANDLE depthHandle = {};
         uint32_t depthTargetAllocatorOffset = D3D12DescriptorHeapAllocator::INVALID_OFFSET;
+        uint32_t layerCount = 1;
 
         D3D12Framebuffer(D3D12Device *device, const RenderFramebufferDesc &desc);
         ~D3D12Framebuffer() override;
@@ -154,7 +155,7 @@ namespace plume {
         void releaseTargetHeap();
     };
 
-    struct D3D12QueryPool : RenderQueryPool {
+    struct D3D12QueryPool final : RenderQueryPool {
         D3D12Device *device = nullptr;
         ID3D12QueryHeap *d3d = nullptr;
         std::vector<uint64_t> results;
@@ -167,7 +168,11 @@ namespace plume {
         virtual uint32_t getCount() const override;
     };
 
-    struct D3D12CommandList : RenderCommandList {
+    struct D3D12CommandList final : RenderCommandList {
+        using RenderCommandList::barriers;
+        using RenderCommandList::setViewports;
+        using RenderCommandList::setScissors;
+
 #   ifdef D3D12_AGILITY_SDK_ENABLED
         ID3D12GraphicsCommandList9 *d3d = nullptr;
 #   else
@@ -175,6 +180,7 @@ namespace plume {
 #   endif
         ID3D12CommandAllocator *commandAllocator = nullptr;
         D3D12CommandQueue *queue = nullptr;
+        RenderCommandListDesc desc;
         const D3D12Framebuffer *targetFramebuffer = nullptr;
         bool targetFramebufferSamplePositionsSet = false;
         bool open = false;
@@ -184,17 +190,32 @@ namespace plume {
         bool descriptorHeapsSet = false;
         D3D12_PRIMITIVE_TOPOLOGY activeTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
         uint32_t activeStencilRef = 0;
+        D3D12_PRIMITIVE_TOPOLOGY dynamicTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        uint32_t dynamicStencilRef = 0;
         bool activeSamplePositions = false;
 
-        D3D12CommandList(D3D12CommandQueue *queue);
+        // Split barriers begun during the recording along with the barriers that end them.
+        struct SplitBarrier {
+            std::vector<D3D12_RESOURCE_BARRIER> endBarriers;
+            bool active = false;
+        };
+
+        std::vector<SplitBarrier> splitBarriers;
+        uint32_t splitBarrierCount = 0;
+
+        D3D12CommandList(D3D12CommandQueue *queue, const RenderCommandListDesc &desc);
         ~D3D12CommandList() override;
         void begin() override;
         void end() override;
         void barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        uint32_t beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        void endSplitBarriers(uint32_t splitIndex) override;
         void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) override;
         void traceRays(uint32_t width, uint32_t height, uint32_t depth, RenderBufferReference shaderBindingTable, const RenderShaderBindingGroupsInfo &shaderBindingGroupsInfo) override;
         void drawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) override;
         void drawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+        void drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount = 1, uint32_t stride = 12) override;
         void setPipeline(const RenderPipeline *pipeline) override;
         void setComputePipelineLayout(const RenderPipelineLayout *pipelineLayout) override;
         void setComputePushConstants(uint32_t rangeIndex, const void *data, uint32_t offset = 0, uint32_t size = 0) override;
@@ -212,14 +233,29 @@ namespace plume {
         void setScissors(const RenderRect *scissorRects, uint32_t count) override;
         void setFramebuffer(const RenderFramebuffer *framebuffer) override;
         void setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) override;
-        void clearColor(uint32_t attachmentIndex, RenderColor colorValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
-        void clearDepthStencil(bool clearDepth, bool clearStencil, float depthValue, uint32_t stencilValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
+        void setCullMode(RenderCullMode cullMode) override;
+        void setFrontFace(RenderFrontFace frontFace) override;
+        void setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) override;
+        void setDepthEnabled(bool depthEnabled) override;
+        void setDepthWriteEnabled(bool depthWriteEnabled) override;
+        void setDepthFunction(RenderComparisonFunction depthFunction) override;
+        void setStencilEnabled(bool stencilEnabled) override;
+        void setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) override;
+        void setStencilReference(uint32_t stencilReference) override;
+        void setDepthBiasEnabled(bool depthBiasEnabled) override;
+        void setDepthClipEnabled(bool depthClipEnabled) override;
+        bool setVertexInput(const RenderInputSlot *inputSlots, uint32_t inputSlotsCount, const RenderInputElement *inputElements, uint32_t inputElementsCount) override;
+        void setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) override;
+        void setComputeShaderObject(const RenderShaderObject *computeShader) override;
+        void setShaderObjectState(const RenderGraphicsPipelineDesc &desc) override;
+        void clearColor(uint32_t attachmentIndex = 0, RenderColor colorValue = RenderColor(), const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
+        void clearDepthStencil(bool clearDepth = true, bool clearStencil = true, float depthValue = 1.0f, uint32_t stencilValue = 0, const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
         void copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) override;
-        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX, uint32_t dstY, uint32_t dstZ, const RenderBox *srcBox) override;
+        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX = 0, uint32_t dstY = 0, uint32_t dstZ = 0, const RenderBox *srcBox = nullptr) override;
         void copyBuffer(const RenderBuffer *dstBuffer, const RenderBuffer *srcBuffer) override;
         void copyTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
         void resolveTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
-        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect, RenderResolveMode resolveMode) override;
+        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect = nullptr, RenderResolveMode resolveMode = RenderResolveMode::AVERAGE) override;
         void buildBottomLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, const RenderBottomLevelASBuildInfo &buildInfo) override;
         void buildTopLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, RenderBufferReference instancesBuffer, const RenderTopLevelASBuildInfo &buildInfo) override;
         void discardTexture(const RenderTexture* texture) override;
@@ -237,7 +273,7 @@ namespace plume {
         void setRootDescriptor(const D3D12PipelineLayout *activePipelineLayout, RenderBufferReference bufferReference, uint32_t setIndex, bool setCompute);
     };
 
-    struct D3D12CommandFence : RenderCommandFence {
+    struct D3D12CommandFence final : RenderCommandFence {
         ID3D12Fence *d3d = nullptr;
         D3D12Device *device = nullptr;
         HANDLE fenceEvent = 0;
@@ -247,47 +283,59 @@ namespace plume {
         ~D3D12CommandFence() override;
     };
 
-    struct D3D12CommandSemaphore : RenderCommandSemaphore {
+    struct D3D12CommandSemaphore final : RenderCommandSemaphore {
         ID3D12Fence *d3d = nullptr;
         D3D12Device *device = nullptr;
         UINT64 semaphoreValue = 0;
+        RenderExternalHandleType exportHandleType = RenderExternalHandleType::NONE;
+        bool shared = false;
 
-        D3D12CommandSemaphore(D3D12Device *device);
+        D3D12CommandSemaphore(D3D12Device *device, RenderExternalHandleType exportHandleType);
+        D3D12CommandSemaphore(D3D12Device *device, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~D3D12CommandSemaphore() override;
+        RenderExternalHandle exportHandle() override;
     };
 
-    struct D3D12CommandQueue : RenderCommandQueue {
+    struct D3D12CommandQueue final : RenderCommandQueue {
+        using RenderCommandQueue::createCommandList;
+        using RenderCommandQueue::executeCommandLists;
+
         ID3D12CommandQueue *d3d = nullptr;
         D3D12Device *device = nullptr;
         RenderCommandListType type = RenderCommandListType::UNKNOWN;
 
         D3D12CommandQueue(D3D12Device *device, RenderCommandListType type);
         ~D3D12CommandQueue() override;
-        std::unique_ptr<RenderCommandList> createCommandList() override;
+        std::unique_ptr<RenderCommandList> createCommandList(const RenderCommandListDesc &desc) override;
         std::unique_ptr<RenderSwapChain> createSwapChain(RenderWindow renderWindow, uint32_t textureCount, RenderFormat format, uint32_t newFrameLatency) override;
-        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores, uint32_t waitSemaphoreCount, RenderCommandSemaphore **signalSemaphores, uint32_t signalSemaphoreCount, RenderCommandFence *signalFence) override;
+        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores = nullptr, uint32_t waitSemaphoreCount = 0, RenderCommandSemaphore **signalSemaphores = nullptr, uint32_t signalSemaphoreCount = 0, RenderCommandFence *signalFence = nullptr) override;
         void waitForCommandFence(RenderCommandFence *fence) override;
     };
 
-    struct D3D12Buffer : RenderBuffer {
+    struct D3D12Buffer final : RenderBuffer {
         ID3D12Resource *d3d = nullptr;
         D3D12_RESOURCE_STATES resourceStates = D3D12_RESOURCE_STATE_COMMON;
         D3D12Device *device = nullptr;
         D3D12MA::Allocation *allocation = nullptr;
         D3D12Pool *pool = nullptr;
+        ID3D12Heap *hostHeap = nullptr;
+        void *hostPointer = nullptr;
         RenderBufferDesc desc;
 
         D3D12Buffer() = default;
         D3D12Buffer(D3D12Device *device, D3D12Pool *pool, const RenderBufferDesc &desc);
+        D3D12Buffer(D3D12Device *device, void *hostPointer, uint64_t size, RenderBufferFlags flags);
+        D3D12Buffer(D3D12Device *device, const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~D3D12Buffer() override;
-        void *map(uint32_t subresource, const RenderRange *readRange) override;
-        void unmap(uint32_t subresource, const RenderRange *writtenRange) override;
+        void *map(uint32_t subresource = 0, const RenderRange *readRange = nullptr) override;
+        void unmap(uint32_t subresource = 0, const RenderRange *writtenRange = nullptr) override;
         std::unique_ptr<RenderBufferFormattedView> createBufferFormattedView(RenderFormat format) override;
         void setName(const std::string &name) override;
         uint64_t getDeviceAddress() const override;
+        RenderExternalHandle exportMemory() override;
     };
 
-    struct D3D12BufferFormattedView : RenderBufferFormattedView {
+    struct D3D12BufferFormattedView final : RenderBufferFormattedView {
         RenderFormat format = RenderFormat::UNKNOWN;
         D3D12Buffer *buffer = nullptr;
 
@@ -295,7 +343,7 @@ namespace plume {
         ~D3D12BufferFormattedView() override;
     };
 
-    struct D3D12Texture : RenderTexture {
+    struct D3D12Texture final : RenderTexture {
         ID3D12Resource *d3d = nullptr;
         D3D12_RESOURCE_STATES resourceStates = D3D12_RESOURCE_STATE_COMMON;
         RenderTextureLayout layout = RenderTextureLayout::UNKNOWN;
@@ -303,15 +351,18 @@ namespace plume {
         D3D12MA::Allocation *allocation = nullptr;
         D3D12Pool *pool = nullptr;
         RenderTextureDesc desc;
+        bool imported = false;
 
         D3D12Texture() = default;
         D3D12Texture(D3D12Device *device, D3D12Pool *pool, const RenderTextureDesc &desc);
+        D3D12Texture(D3D12Device *device, const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~D3D12Texture() override;
         std::unique_ptr<RenderTextureView> createTextureView(const RenderTextureViewDesc &desc) const override;
         void setName(const std::string &name) override;
+        RenderExternalHandle exportMemory() override;
     };
 
-    struct D3D12TextureView : RenderTextureView {
+    struct D3D12TextureView final : RenderTextureView {
         DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
         const D3D12Texture *texture = nullptr;
         RenderTextureViewDesc desc;
@@ -326,7 +377,7 @@ namespace plume {
         ~D3D12TextureView() override;
     };
 
-    struct D3D12AccelerationStructure :RenderAccelerationStructure {
+    struct D3D12AccelerationStructure final : RenderAccelerationStructure {
         D3D12Device *device = nullptr;
         const D3D12Buffer *buffer = nullptr;
         uint64_t offset = 0;
@@ -337,7 +388,7 @@ namespace plume {
         ~D3D12AccelerationStructure() override;
     };
 
-    struct D3D12Pool : RenderPool {
+    struct D3D12Pool final : RenderPool {
         D3D12MA::Pool *d3d = nullptr;
         D3D12Device *device = nullptr;
         RenderPoolDesc desc;
@@ -348,7 +399,7 @@ namespace plume {
         std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) override;
     };
 
-    struct D3D12Shader : RenderShader {
+    struct D3D12Shader final : RenderShader {
         std::vector<uint8_t> d3d;
         std::string entryPointName;
         D3D12Device *device = nullptr;
@@ -359,7 +410,7 @@ namespace plume {
         virtual void setName(const std::string &name) override;
     };
 
-    struct D3D12Sampler : RenderSampler {
+    struct D3D12Sampler final : RenderSampler {
         D3D12_SAMPLER_DESC samplerDesc = {};
         D3D12Device *device = nullptr;
         RenderBorderColor borderColor = RenderBorderColor::UNKNOWN;
@@ -384,7 +435,7 @@ namespace plume {
         virtual ~D3D12Pipeline() override;
     };
 
-    struct D3D12ComputePipeline : D3D12Pipeline {
+    struct D3D12ComputePipeline final : D3D12Pipeline {
         ID3D12PipelineState *d3d = nullptr;
 
         D3D12ComputePipeline(D3D12Device *device, const RenderComputePipelineDesc &desc);
@@ -393,11 +444,13 @@ namespace plume {
         virtual RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct D3D12GraphicsPipeline : D3D12Pipeline {
+    struct D3D12GraphicsPipeline final : D3D12Pipeline {
         ID3D12PipelineState *d3d = nullptr;
         std::vector<RenderInputSlot> inputSlots;
         D3D12_PRIMITIVE_TOPOLOGY topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
         uint32_t stencilRef = 0;
+        RenderDynamicStateFlags dynamicStates = RenderDynamicStateFlag::NONE;
+        uint32_t viewInstanceCount = 0;
 
         D3D12GraphicsPipeline(D3D12Device *device, const RenderGraphicsPipelineDesc &desc);
         ~D3D12GraphicsPipeline() override;
@@ -405,7 +458,7 @@ namespace plume {
         virtual RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct D3D12RaytracingPipeline : D3D12Pipeline {
+    struct D3D12RaytracingPipeline final : D3D12Pipeline {
         ID3D12StateObject *stateObject = nullptr;
         ID3D12StateObjectProperties *stateObjectProperties = nullptr;
         std::vector<void *> programShaderIdentifiers;
@@ -418,7 +471,7 @@ namespace plume {
         virtual RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct D3D12PipelineLayout : RenderPipelineLayout {
+    struct D3D12PipelineLayout final : RenderPipelineLayout {
         ID3D12RootSignature *rootSignature = nullptr;
         D3D12Device *device = nullptr;
         std::vector<RenderPushConstantRange> pushConstantRanges;
@@ -432,7 +485,10 @@ namespace plume {
         ~D3D12PipelineLayout() override;
     };
 
-    struct D3D12Device : RenderDevice {
+    struct D3D12Device final : RenderDevice {
+        using RenderDevice::createBufferFromHostMemory;
+        using RenderDevice::createCommandSemaphore;
+
         ID3D12Device8 *d3d = nullptr;
         D3D12Interface *renderInterface = nullptr;
         IDXGIAdapter1 *adapter = nullptr;
@@ -447,49 +503,77 @@ namespace plume {
         std::unique_ptr<D3D12Pool> customUploadPool;
         RenderDeviceCapabilities capabilities;
         RenderDeviceDescription description;
+        std::vector<RenderFormatSupport> formatSupport;
         uint64_t timestampFrequency = 1;
         bool gpuUploadHeapFallback = false;
+        std::unordered_map<uint32_t, ID3D12CommandSignature *> dispatchMeshSignatures;
+        std::mutex dispatchMeshSignaturesMutex;
 
         D3D12Device(D3D12Interface *renderInterface, const std::string &preferredDeviceName);
         ~D3D12Device() override;
         std::unique_ptr<RenderDescriptorSet> createDescriptorSet(const RenderDescriptorSetDesc &desc) override;
         std::unique_ptr<RenderShader> createShader(const void *data, uint64_t size, const char *entryPointName, RenderShaderFormat format) override;
+        std::vector<std::unique_ptr<RenderShaderObject>> createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked = false) override;
         std::unique_ptr<RenderSampler> createSampler(const RenderSamplerDesc &desc) override;
         std::unique_ptr<RenderPipeline> createComputePipeline(const RenderComputePipelineDesc &desc) override;
         std::unique_ptr<RenderPipeline> createGraphicsPipeline(const RenderGraphicsPipelineDesc &desc) override;
-        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline) override;
+        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline = nullptr) override;
         std::unique_ptr<RenderCommandQueue> createCommandQueue(RenderCommandListType type) override;
         std::unique_ptr<RenderBuffer> createBuffer(const RenderBufferDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) override;
         std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderTexture> createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) override;
         std::unique_ptr<RenderAccelerationStructure> createAccelerationStructure(const RenderAccelerationStructureDesc &desc) override;
         std::unique_ptr<RenderPool> createPool(const RenderPoolDesc &desc) override;
         std::unique_ptr<RenderPipelineLayout> createPipelineLayout(const RenderPipelineLayoutDesc &desc) override;
         std::unique_ptr<RenderCommandFence> createCommandFence() override;
-        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore() override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore(RenderExternalHandleType exportHandleType) override;
         std::unique_ptr<RenderFramebuffer> createFramebuffer(const RenderFramebufferDesc &desc) override;
         std::unique_ptr<RenderQueryPool> createQueryPool(uint32_t queryCount) override;
-        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild, bool preferFastTrace) override;
-        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild, bool preferFastTrace) override;
+        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
+        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
         void setShaderBindingTableInfo(RenderShaderBindingTableInfo &tableInfo, const RenderShaderBindingGroups &groups, const RenderPipeline *pipeline, RenderDescriptorSet **descriptorSets, uint32_t descriptorSetCount) override;
         const RenderDeviceCapabilities &getCapabilities() const override;
         const RenderDeviceDescription &getDescription() const override;
         RenderSampleCounts getSampleCountsSupported(RenderFormat format) const override;
+        RenderFormatSupport getFormatSupport(RenderFormat format) const override;
+        ID3D12CommandSignature *getDispatchMeshSignature(uint32_t stride);
         void release();
         bool isValid() const;
         bool beginCapture() override;
         bool endCapture() override;
     };
 
-    struct D3D12Interface : RenderInterface {
+    struct D3D12Interface final : RenderInterface {
         IDXGIFactory4 *dxgiFactory = nullptr;
         RenderInterfaceCapabilities capabilities;
         std::vector<std::string> deviceNames;
 
         D3D12Interface();
         ~D3D12Interface() override;
-        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName) override;
+        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName = "") override;
         const RenderInterfaceCapabilities &getCapabilities() const override;
         const std::vector<std::string> &getDeviceNames() const override;
         bool isValid() const;
     };
+
+#if defined(PLUME_SINGLE_BACKEND_D3D12)
+    // Only this backend is built, so applications can cast to the final types below to let the compiler resolve and inline the calls.
+    typedef D3D12Buffer RenderBackendBuffer;
+    typedef D3D12DescriptorSet RenderBackendDescriptorSet;
+    typedef D3D12SwapChain RenderBackendSwapChain;
+    typedef D3D12Framebuffer RenderBackendFramebuffer;
+    typedef D3D12QueryPool RenderBackendQueryPool;
+    typedef D3D12CommandList RenderBackendCommandList;
+    typedef D3D12CommandFence RenderBackendCommandFence;
+    typedef D3D12CommandSemaphore RenderBackendCommandSemaphore;
+    typedef D3D12CommandQueue RenderBackendCommandQueue;
+    typedef D3D12Pool RenderBackendPool;
+    typedef D3D12PipelineLayout RenderBackendPipelineLayout;
+    typedef D3D12Sampler RenderBackendSampler;
+    typedef D3D12Device RenderBackendDevice;
+    typedef D3D12Interface RenderBackendInterface;
+#endif
 };
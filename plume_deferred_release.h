@@ -0,0 +1,118 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <mutex>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    // Defers the destruction of objects the GPU might still be using until the frame they were released on has finished executing.
+    // Objects are queued on the current frame and destroyed in bulk when the ring cycles back to it in beginFrame(), which must only
+    // be called after waiting on the fence that the command lists recorded during that frame were submitted with. This removes the
+    // need to wait for the GPU to go idle before dropping a resource.
+    //
+    // Objects can be released from any thread. The destruction happens on the thread that calls beginFrame() or flush().
+    struct RenderDeferredReleaseQueue {
+        typedef std::unique_ptr<void, void (*)(void *)> Object;
+
+        std::vector<std::vector<Object>> frames;
+        uint32_t frameIndex = 0;
+        std::mutex queueMutex;
+
+        RenderDeferredReleaseQueue() = default;
+
+        RenderDeferredReleaseQueue(uint32_t frameCount) {
+            create(frameCount);
+        }
+
+        // The GPU must be idle when the queue is destroyed.
+        ~RenderDeferredReleaseQueue() {
+            flush();
+        }
+
+        // Creating the queue again destroys the objects still pending on it, so the GPU must be idle.
+        void create(uint32_t frameCount) {
+            assert(frameCount > 0);
+
+            flush();
+
+            const std::scoped_lock lock(queueMutex);
+            frames.clear();
+            frames.resize(frameCount);
+            frameIndex = 0;
+        }
+
+        // Destroys the objects previously released on the frame and makes it the target of new releases.
+        void beginFrame(uint32_t frameIndex) {
+            assert(frameIndex < frames.size());
+
+            // Move the objects out first so their destructors run without holding the lock.
+            std::vector<Object> releasedObjects;
+            {
+                const std::scoped_lock lock(queueMutex);
+                releasedObjects.swap(frames[frameIndex]);
+                this->frameIndex = frameIndex;
+            }
+
+            releasedObjects.clear();
+
+            // Keep the capacity of the frame to avoid allocating once the queue has reached its working size.
+            const std::scoped_lock lock(queueMutex);
+            if (frames[frameIndex].empty()) {
+                frames[frameIndex].swap(releasedObjects);
+            }
+        }
+
+        // Destroys the objects of all frames. Only valid after waiting for all submissions to finish.
+        void flush() {
+            std::vector<std::vector<Object>> releasedFrames;
+            {
+                const std::scoped_lock lock(queueMutex);
+                releasedFrames.swap(frames);
+                frames.resize(releasedFrames.size());
+            }
+
+            releasedFrames.clear();
+        }
+
+        template<typename T>
+        void release(std::unique_ptr<T> &&object) {
+            if (object == nullptr) {
+                return;
+            }
+
+            Object releasedObject(object.release(), [](void *pointer) {
+                delete static_cast<T *>(pointer);
+            });
+
+            const std::scoped_lock lock(queueMutex);
+            assert(!frames.empty() && "Queue must be created before use.");
+            frames[frameIndex].emplace_back(std::move(releasedObject));
+        }
+
+        template<typename T>
+        void release(std::vector<std::unique_ptr<T>> &&objects) {
+            for (std::unique_ptr<T> &object : objects) {
+                release(std::move(object));
+            }
+
+            objects.clear();
+        }
+
+        size_t pendingCount() {
+            const std::scoped_lock lock(queueMutex);
+            size_t count = 0;
+            for (const std::vector<Object> &frame : frames) {
+                count += frame.size();
+            }
+
+            return count;
+        }
+    };
+};
@@ -0,0 +1,292 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    // 32-bit handle made out of a slot index and the generation of the slot at the time the handle was created.
+    // The generation is advanced every time a slot is freed, so handles to destroyed objects are detected as stale
+    // until the generation wraps around. Handles with a value of zero are always invalid.
+    template<typename Tag>
+    struct RenderHandle {
+        static constexpr uint32_t IndexBits = 20;
+        static constexpr uint32_t GenerationBits = 32 - IndexBits;
+        static constexpr uint32_t IndexMask = (1U << IndexBits) - 1U;
+        static constexpr uint32_t GenerationMask = (1U << GenerationBits) - 1U;
+        static constexpr uint32_t MaxIndex = IndexMask;
+
+        uint32_t value = 0;
+
+        RenderHandle() = default;
+
+        RenderHandle(uint32_t index, uint32_t generation) {
+            value = ((generation & GenerationMask) << IndexBits) | (index & IndexMask);
+        }
+
+        uint32_t index() const {
+            return value & IndexMask;
+        }
+
+        uint32_t generation() const {
+            return (value >> IndexBits) & GenerationMask;
+        }
+
+        bool isNull() const {
+            return value == 0;
+        }
+
+        bool operator==(const RenderHandle &other) const {
+            return value == other.value;
+        }
+
+        bool operator!=(const RenderHandle &other) const {
+            return value != other.value;
+        }
+    };
+
+    // Stores objects densely in a single array so iterating over them and looking them up touches contiguous memory.
+    // Removing an object moves the last one into its place, so pointers returned by get() are only valid until the next
+    // insertion or removal. Handles remain valid until the object they refer to is removed.
+    template<typename T, typename Tag = T>
+    struct RenderHandleTable {
+        typedef RenderHandle<Tag> Handle;
+
+        struct Slot {
+            // Generations start at one so a zero handle never refers to a live object.
+            uint32_t generation = 1;
+            uint32_t denseIndex = 0;
+            uint32_t nextFree = 0;
+        };
+
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFFU;
+
+        std::vector<T> objects;
+        std::vector<uint32_t> denseToSlot;
+        std::vector<Slot> slots;
+        uint32_t freeSlot = InvalidIndex;
+
+        RenderHandleTable() = default;
+
+        void reserve(uint32_t count) {
+            objects.reserve(count);
+            denseToSlot.reserve(count);
+            slots.reserve(count);
+        }
+
+        Handle insert(T &&object) {
+            uint32_t slotIndex;
+            if (freeSlot != InvalidIndex) {
+                slotIndex = freeSlot;
+                freeSlot = slots[slotIndex].nextFree;
+            }
+            else {
+                assert((slots.size() <= Handle::MaxIndex) && "Handle table has run out of slots.");
+                slotIndex = uint32_t(slots.size());
+                slots.emplace_back();
+            }
+
+            Slot &slot = slots[slotIndex];
+            slot.denseIndex = uint32_t(objects.size());
+            slot.nextFree = InvalidIndex;
+            objects.emplace_back(std::move(object));
+            denseToSlot.emplace_back(slotIndex);
+            return Handle(slotIndex, slot.generation);
+        }
+
+        bool isValid(Handle handle) const {
+            const uint32_t slotIndex = handle.index();
+            return !handle.isNull() && (slotIndex < slots.size()) && (slots[slotIndex].generation == handle.generation()) && (slots[slotIndex].nextFree == InvalidIndex);
+        }
+
+        // Returns null if the handle is stale.
+        T *get(Handle handle) {
+            return isValid(handle) ? &objects[slots[handle.index()].denseIndex] : nullptr;
+        }
+
+        const T *get(Handle handle) const {
+            return isValid(handle) ? &objects[slots[handle.index()].denseIndex] : nullptr;
+        }
+
+        // Returns false if the handle is stale.
+        bool remove(Handle handle) {
+            if (!isValid(handle)) {
+                return false;
+            }
+
+            const uint32_t slotIndex = handle.index();
+            Slot &slot = slots[slotIndex];
+            const uint32_t lastIndex = uint32_t(objects.size() - 1);
+            if (slot.denseIndex != lastIndex) {
+                objects[slot.denseIndex] = std::move(objects[lastIndex]);
+                denseToSlot[slot.denseIndex] = denseToSlot[lastIndex];
+                slots[denseToSlot[slot.denseIndex]].denseIndex = slot.denseIndex;
+            }
+
+            objects.pop_back();
+            denseToSlot.pop_back();
+
+            // Skip the zero generation when wrapping around to keep null handles invalid.
+            slot.generation = (slot.generation + 1) & Handle::GenerationMask;
+            if (slot.generation == 0) {
+                slot.generation = 1;
+            }
+
+            slot.nextFree = freeSlot;
+            freeSlot = slotIndex;
+            return true;
+        }
+
+        // Returns the handle of the object at the specified position of the dense array.
+        Handle handleAt(uint32_t denseIndex) const {
+            assert(denseIndex < objects.size());
+            const uint32_t slotIndex = denseToSlot[denseIndex];
+            return Handle(slotIndex, slots[slotIndex].generation);
+        }
+
+        uint32_t size() const {
+            return uint32_t(objects.size());
+        }
+
+        void clear() {
+            objects.clear();
+            denseToSlot.clear();
+            slots.clear();
+            freeSlot = InvalidIndex;
+        }
+    };
+
+    struct RenderBufferHandleTag;
+    struct RenderTextureHandleTag;
+    struct RenderTextureViewHandleTag;
+    struct RenderDescriptorSetHandleTag;
+    typedef RenderHandle<RenderBufferHandleTag> RenderBufferHandle;
+    typedef RenderHandle<RenderTextureHandleTag> RenderTextureHandle;
+    typedef RenderHandle<RenderTextureViewHandleTag> RenderTextureViewHandle;
+    typedef RenderHandle<RenderDescriptorSetHandleTag> RenderDescriptorSetHandle;
+
+    // Optional handle-based front end for the resources of a device. Applications can store and pass around 32-bit handles
+    // instead of owning pointers, and destroyed resources are detected when a stale handle is resolved.
+    //
+    // The tables only store the pointers and the descriptions, so resolving a handle stays within one contiguous array per type.
+    // The resources themselves are still created by the backend.
+    struct RenderResourceTables {
+        struct BufferEntry {
+            std::unique_ptr<RenderBuffer> buffer;
+            RenderBufferDesc desc;
+        };
+
+        struct TextureEntry {
+            std::unique_ptr<RenderTexture> texture;
+            RenderTextureDesc desc;
+        };
+
+        struct TextureViewEntry {
+            std::unique_ptr<RenderTextureView> textureView;
+            RenderTextureHandle texture;
+        };
+
+        struct DescriptorSetEntry {
+            std::unique_ptr<RenderDescriptorSet> descriptorSet;
+        };
+
+        RenderDevice *device = nullptr;
+        RenderHandleTable<BufferEntry, RenderBufferHandleTag> buffers;
+        RenderHandleTable<TextureEntry, RenderTextureHandleTag> textures;
+        RenderHandleTable<TextureViewEntry, RenderTextureViewHandleTag> textureViews;
+        RenderHandleTable<DescriptorSetEntry, RenderDescriptorSetHandleTag> descriptorSets;
+
+        RenderResourceTables() = default;
+
+        RenderResourceTables(RenderDevice *device) {
+            assert(device != nullptr);
+            this->device = device;
+        }
+
+        RenderBufferHandle createBuffer(const RenderBufferDesc &desc) {
+            BufferEntry entry;
+            entry.buffer = device->createBuffer(desc);
+            entry.desc = desc;
+            return (entry.buffer != nullptr) ? buffers.insert(std::move(entry)) : RenderBufferHandle();
+        }
+
+        RenderTextureHandle createTexture(const RenderTextureDesc &desc) {
+            TextureEntry entry;
+            entry.texture = device->createTexture(desc);
+            entry.desc = desc;
+            return (entry.texture != nullptr) ? textures.insert(std::move(entry)) : RenderTextureHandle();
+        }
+
+        RenderTextureViewHandle createTextureView(RenderTextureHandle texture, const RenderTextureViewDesc &desc) {
+            TextureEntry *textureEntry = textures.get(texture);
+            assert((textureEntry != nullptr) && "Texture handle is stale.");
+
+            TextureViewEntry entry;
+            entry.textureView = textureEntry->texture->createTextureView(desc);
+            entry.texture = texture;
+            return (entry.textureView != nullptr) ? textureViews.insert(std::move(entry)) : RenderTextureViewHandle();
+        }
+
+        RenderDescriptorSetHandle createDescriptorSet(const RenderDescriptorSetDesc &desc) {
+            DescriptorSetEntry entry;
+            entry.descriptorSet = device->createDescriptorSet(desc);
+            return (entry.descriptorSet != nullptr) ? descriptorSets.insert(std::move(entry)) : RenderDescriptorSetHandle();
+        }
+
+        // Resolving returns null for stale handles.
+        RenderBuffer *get(RenderBufferHandle handle) const {
+            const BufferEntry *entry = buffers.get(handle);
+            return (entry != nullptr) ? entry->buffer.get() : nullptr;
+        }
+
+        RenderTexture *get(RenderTextureHandle handle) const {
+            const TextureEntry *entry = textures.get(handle);
+            return (entry != nullptr) ? entry->texture.get() : nullptr;
+        }
+
+        // Views are also stale once the texture they were created from has been destroyed.
+        RenderTextureView *get(RenderTextureViewHandle handle) const {
+            const TextureViewEntry *entry = textureViews.get(handle);
+            return ((entry != nullptr) && textures.isValid(entry->texture)) ? entry->textureView.get() : nullptr;
+        }
+
+        RenderDescriptorSet *get(RenderDescriptorSetHandle handle) const {
+            const DescriptorSetEntry *entry = descriptorSets.get(handle);
+            return (entry != nullptr) ? entry->descriptorSet.get() : nullptr;
+        }
+
+        // The resources must no longer be in use by the GPU. Destroying a stale handle is a no-op that returns false.
+        bool destroy(RenderBufferHandle handle) {
+            return buffers.remove(handle);
+        }
+
+        // Also destroys the views created from the texture, as they can't outlive it.
+        bool destroy(RenderTextureHandle handle) {
+            if (!textures.isValid(handle)) {
+                return false;
+            }
+
+            // Removing moves the last view into the removed position, so the views are visited from the back.
+            for (uint32_t i = textureViews.size(); i > 0; i--) {
+                if (textureViews.objects[i - 1].texture == handle) {
+                    textureViews.remove(textureViews.handleAt(i - 1));
+                }
+            }
+
+            return textures.remove(handle);
+        }
+
+        bool destroy(RenderTextureViewHandle handle) {
+            return textureViews.remove(handle);
+        }
+
+        bool destroy(RenderDescriptorSetHandle handle) {
+            return descriptorSets.remove(handle);
+        }
+    };
+};
@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <mutex>
+#include <unistd.h>
 
 #include "plume_metal.h"
+#include "plume_allocator.h"
 
 namespace plume {
     // MARK: - Constants
@@ -439,6 +441,110 @@ namespace plume {
                return MTL::PixelFormatBC7_RGBAUnorm;
            case RenderFormat::BC7_UNORM_SRGB:
                return MTL::PixelFormatBC7_RGBAUnorm_sRGB;
+           case RenderFormat::ETC2_R8G8B8_UNORM:
+               return MTL::PixelFormatETC2_RGB8;
+           case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+               return MTL::PixelFormatETC2_RGB8_sRGB;
+           case RenderFormat::ETC2_R8G8B8A1_UNORM:
+               return MTL::PixelFormatETC2_RGB8A1;
+           case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+               return MTL::PixelFormatETC2_RGB8A1_sRGB;
+           case RenderFormat::ETC2_R8G8B8A8_UNORM:
+               return MTL::PixelFormatEAC_RGBA8;
+           case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+               return MTL::PixelFormatEAC_RGBA8_sRGB;
+           case RenderFormat::EAC_R11_UNORM:
+               return MTL::PixelFormatEAC_R11Unorm;
+           case RenderFormat::EAC_R11_SNORM:
+               return MTL::PixelFormatEAC_R11Snorm;
+           case RenderFormat::EAC_R11G11_UNORM:
+               return MTL::PixelFormatEAC_RG11Unorm;
+           case RenderFormat::EAC_R11G11_SNORM:
+               return MTL::PixelFormatEAC_RG11Snorm;
+           case RenderFormat::ASTC_4X4_UNORM:
+               return MTL::PixelFormatASTC_4x4_LDR;
+           case RenderFormat::ASTC_4X4_UNORM_SRGB:
+               return MTL::PixelFormatASTC_4x4_sRGB;
+           case RenderFormat::ASTC_4X4_FLOAT:
+               return MTL::PixelFormatASTC_4x4_HDR;
+           case RenderFormat::ASTC_5X4_UNORM:
+               return MTL::PixelFormatASTC_5x4_LDR;
+           case RenderFormat::ASTC_5X4_UNORM_SRGB:
+               return MTL::PixelFormatASTC_5x4_sRGB;
+           case RenderFormat::ASTC_5X4_FLOAT:
+               return MTL::PixelFormatASTC_5x4_HDR;
+           case RenderFormat::ASTC_5X5_UNORM:
+               return MTL::PixelFormatASTC_5x5_LDR;
+           case RenderFormat::ASTC_5X5_UNORM_SRGB:
+               return MTL::PixelFormatASTC_5x5_sRGB;
+           case RenderFormat::ASTC_5X5_FLOAT:
+               return MTL::PixelFormatASTC_5x5_HDR;
+           case RenderFormat::ASTC_6X5_UNORM:
+               return MTL::PixelFormatASTC_6x5_LDR;
+           case RenderFormat::ASTC_6X5_UNORM_SRGB:
+               return MTL::PixelFormatASTC_6x5_sRGB;
+           case RenderFormat::ASTC_6X5_FLOAT:
+               return MTL::PixelFormatASTC_6x5_HDR;
+           case RenderFormat::ASTC_6X6_UNORM:
+               return MTL::PixelFormatASTC_6x6_LDR;
+           case RenderFormat::ASTC_6X6_UNORM_SRGB:
+               return MTL::PixelFormatASTC_6x6_sRGB;
+           case RenderFormat::ASTC_6X6_FLOAT:
+               return MTL::PixelFormatASTC_6x6_HDR;
+           case RenderFormat::ASTC_8X5_UNORM:
+               return MTL::PixelFormatASTC_8x5_LDR;
+           case RenderFormat::ASTC_8X5_UNORM_SRGB:
+               return MTL::PixelFormatASTC_8x5_sRGB;
+           case RenderFormat::ASTC_8X5_FLOAT:
+               return MTL::PixelFormatASTC_8x5_HDR;
+           case RenderFormat::ASTC_8X6_UNORM:
+               return MTL::PixelFormatASTC_8x6_LDR;
+           case RenderFormat::ASTC_8X6_UNORM_SRGB:
+               return MTL::PixelFormatASTC_8x6_sRGB;
+           case RenderFormat::ASTC_8X6_FLOAT:
+               return MTL::PixelFormatASTC_8x6_HDR;
+           case RenderFormat::ASTC_8X8_UNORM:
+               return MTL::PixelFormatASTC_8x8_LDR;
+           case RenderFormat::ASTC_8X8_UNORM_SRGB:
+               return MTL::PixelFormatASTC_8x8_sRGB;
+           case RenderFormat::ASTC_8X8_FLOAT:
+               return MTL::PixelFormatASTC_8x8_HDR;
+           case RenderFormat::ASTC_10X5_UNORM:
+               return MTL::PixelFormatASTC_10x5_LDR;
+           case RenderFormat::ASTC_10X5_UNORM_SRGB:
+               return MTL::PixelFormatASTC_10x5_sRGB;
+           case RenderFormat::ASTC_10X5_FLOAT:
+               return MTL::PixelFormatASTC_10x5_HDR;
+           case RenderFormat::ASTC_10X6_UNORM:
+               return MTL::PixelFormatASTC_10x6_LDR;
+           case RenderFormat::ASTC_10X6_UNORM_SRGB:
+               return MTL::PixelFormatASTC_10x6_sRGB;
+           case RenderFormat::ASTC_10X6_FLOAT:
+               return MTL::PixelFormatASTC_10x6_HDR;
+           case RenderFormat::ASTC_10X8_UNORM:
+               return MTL::PixelFormatASTC_10x8_LDR;
+           case RenderFormat::ASTC_10X8_UNORM_SRGB:
+               return MTL::PixelFormatASTC_10x8_sRGB;
+           case RenderFormat::ASTC_10X8_FLOAT:
+               return MTL::PixelFormatASTC_10x8_HDR;
+           case RenderFormat::ASTC_10X10_UNORM:
+               return MTL::PixelFormatASTC_10x10_LDR;
+           case RenderFormat::ASTC_10X10_UNORM_SRGB:
+               return MTL::PixelFormatASTC_10x10_sRGB;
+           case RenderFormat::ASTC_10X10_FLOAT:
+               return MTL::PixelFormatASTC_10x10_HDR;
+           case RenderFormat::ASTC_12X10_UNORM:
+               return MTL::PixelFormatASTC_12x10_LDR;
+           case RenderFormat::ASTC_12X10_UNORM_SRGB:
+               return MTL::PixelFormatASTC_12x10_sRGB;
+           case RenderFormat::ASTC_12X10_FLOAT:
+               return MTL::PixelFormatASTC_12x10_HDR;
+           case RenderFormat::ASTC_12X12_UNORM:
+               return MTL::PixelFormatASTC_12x12_LDR;
+           case RenderFormat::ASTC_12X12_UNORM_SRGB:
+               return MTL::PixelFormatASTC_12x12_sRGB;
+           case RenderFormat::ASTC_12X12_FLOAT:
+               return MTL::PixelFormatASTC_12x12_HDR;
             default:
                 assert(false && "Unknown format.");
                 return MTL::PixelFormatInvalid;
@@ -1128,6 +1234,30 @@ namespace plume {
         }
     }
 
+    MetalBuffer::MetalBuffer(MetalDevice *device, void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        assert(device != nullptr);
+        assert(hostPointer != nullptr);
+
+        const uint64_t importAlignment = device->capabilities.hostMemoryImportAlignment;
+        assert((((uintptr_t(hostPointer) % importAlignment) == 0) && ((size % importAlignment) == 0)) && "Host memory must be aligned to the import alignment.");
+
+        this->desc = RenderBufferDesc::UploadBuffer(size, flags);
+        this->device = device;
+
+        // The memory is owned by the caller, so no deallocator is provided.
+        this->mtl = device->mtl->newBuffer(hostPointer, size, MTL::ResourceStorageModeShared | MTL::ResourceCPUCacheModeDefaultCache, nullptr);
+
+        if (flags & RenderBufferFlag::DEVICE_ADDRESSABLE) {
+            std::lock_guard lock(device->gpuAddressableResourcesMutex);
+            if (device->gpuAddressableResidencySet != nullptr) {
+                device->gpuAddressableResidencySet->addAllocation(mtl);
+                device->gpuAddressableResidencySet->commit();
+            } else {
+                device->gpuAddressableResources.push_back(mtl);
+            }
+        }
+    }
+
     MetalBuffer::~MetalBuffer() {
         if (desc.flags & RenderBufferFlag::DEVICE_ADDRESSABLE) {
             std::lock_guard lock(device->gpuAddressableResourcesMutex);
@@ -1174,6 +1304,11 @@ namespace plume {
         return mtl->gpuAddress();
     }
 
+    RenderExternalHandle MetalBuffer::exportMemory() {
+        assert(false && "External memory is unsupported on Metal.");
+        return RenderExternalHandleInvalid;
+    }
+
     // MetalBufferFormattedView
 
     MetalBufferFormattedView::MetalBufferFormattedView(MetalBuffer *buffer, RenderFormat format) {
@@ -1249,6 +1384,11 @@ namespace plume {
         mtl->setLabel(NS::String::string(name.c_str(), NS::UTF8StringEncoding));
     }
 
+    RenderExternalHandle MetalTexture::exportMemory() {
+        assert(false && "External memory is unsupported on Metal.");
+        return RenderExternalHandleInvalid;
+    }
+
     // MetalTextureView
 
     bool operator==(const RenderTextureDimension lhs, RenderTextureViewDimension rhs) {
@@ -1351,7 +1491,22 @@ namespace plume {
         if (specConstants != nullptr) {
             for (uint32_t i = 0; i < specConstantsCount; i++) {
                 const RenderSpecConstant &specConstant = specConstants[i];
-                values->setConstantValue(&specConstant.value, MTL::DataTypeUInt, specConstant.index);
+                switch (specConstant.type) {
+                case RenderSpecConstantType::INT:
+                    values->setConstantValue(&specConstant.value, MTL::DataTypeInt, specConstant.index);
+                    break;
+                case RenderSpecConstantType::FLOAT:
+                    values->setConstantValue(&specConstant.value, MTL::DataTypeFloat, specConstant.index);
+                    break;
+                case RenderSpecConstantType::BOOL: {
+                    const bool boolValue = (specConstant.value != 0);
+                    values->setConstantValue(&boolValue, MTL::DataTypeBool, specConstant.index);
+                    break;
+                }
+                default:
+                    values->setConstantValue(&specConstant.value, MTL::DataTypeUInt, specConstant.index);
+                    break;
+                }
             }
         }
         NS::Error *error = nullptr;
@@ -1458,9 +1613,28 @@ namespace plume {
 
     MetalGraphicsPipeline::MetalGraphicsPipeline(const MetalDevice *device, const RenderGraphicsPipelineDesc &desc) : MetalPipeline(device, Type::Graphics) {
         assert(desc.pipelineLayout != nullptr);
+        assert((desc.taskShader == nullptr) && (desc.meshShader == nullptr) && "Mesh shaders are unsupported on Metal.");
+        assert(((desc.viewMask == 0) || device->capabilities.multiview) && "Multiview is unsupported on this device.");
         NS::AutoreleasePool *releasePool = NS::AutoreleasePool::alloc()->init();
 
         MTL::RenderPipelineDescriptor *descriptor = MTL::RenderPipelineDescriptor::alloc()->init();
+
+        // Multiview is implemented with vertex amplification, with each amplified vertex routed to the render target array slice of its bit in the view mask.
+        state.viewMask = desc.viewMask;
+        for (uint32_t i = 0; i < 32; i++) {
+            if (desc.viewMask & (1U << i)) {
+                MTL::VertexAmplificationViewMapping viewMapping;
+                viewMapping.viewportArrayIndexOffset = 0;
+                viewMapping.renderTargetArrayIndexOffset = i;
+                state.viewMappings.emplace_back(viewMapping);
+            }
+        }
+
+        if (!state.viewMappings.empty()) {
+            assert((state.viewMappings.size() <= device->capabilities.maxMultiviewViewCount) && "View mask exceeds the amount of views supported by the device.");
+            descriptor->setMaxVertexAmplificationCount(state.viewMappings.size());
+        }
+
         descriptor->setInputPrimitiveTopology(mapPrimitiveTopologyClass(desc.primitiveTopology));
         descriptor->setRasterSampleCount(desc.multisampling.sampleCount);
         descriptor->setAlphaToCoverageEnabled(desc.alphaToCoverageEnabled);
@@ -1574,6 +1748,7 @@ namespace plume {
         state.renderPipelineState = device->mtl->newRenderPipelineState(descriptor, &error);
         state.primitiveType = mapPrimitiveType(desc.primitiveTopology);
         state.stencilReference = desc.stencilEnabled ? desc.stencilReference : 0;
+        state.dynamicStates = desc.dynamicStates;
 
         if (desc.dynamicDepthBiasEnabled) {
             state.dynamicDepthBiasEnabled = true;
@@ -1862,6 +2037,11 @@ namespace plume {
         mtl->texture()->setLabel(NS::String::string(name.c_str(), NS::UTF8StringEncoding));
     }
 
+    RenderExternalHandle MetalDrawable::exportMemory() {
+        assert(false && "External memory is unsupported on Metal.");
+        return RenderExternalHandleInvalid;
+    }
+
     // MetalSwapChain
 
     MetalSwapChain::MetalSwapChain(MetalCommandQueue *commandQueue, const RenderWindow renderWindow, uint32_t textureCount, const RenderFormat format, uint32_t maxFrameLatency) {
@@ -2072,9 +2252,26 @@ namespace plume {
         assert(device != nullptr);
         NS::AutoreleasePool *releasePool = NS::AutoreleasePool::alloc()->init();
 
+        assert(((desc.viewMask == 0) || device->capabilities.multiview) && "Multiview is unsupported on this device.");
+
         colorAttachments.reserve(desc.colorAttachmentsCount);
         depthAttachmentReadOnly = desc.depthAttachmentReadOnly;
 
+        assert((desc.layerCount > 0) && "Framebuffers must have at least one layer.");
+        assert(((desc.viewMask == 0) || (desc.layerCount == 1)) && "Layered framebuffers can't use multiview.");
+        assert(((desc.layerCount == 1) || (device->capabilities.maxFramebufferLayers > 1)) && "Layered rendering is unsupported on this device.");
+
+        // The render pass must cover every array slice selected by the view mask or the shaders.
+        if (desc.layerCount > 1) {
+            renderTargetArrayLength = desc.layerCount;
+        }
+
+        for (uint32_t i = 0; i < 32; i++) {
+            if (desc.viewMask & (1U << i)) {
+                renderTargetArrayLength = i + 1;
+            }
+        }
+
         const MetalTexture *firstTexture = nullptr;
 
         for (uint32_t i = 0; i < desc.colorAttachmentsCount; i++) {
@@ -2187,7 +2384,10 @@ namespace plume {
 
     // MetalCommandList
 
-    MetalCommandList::MetalCommandList(const MetalCommandQueue *queue) {
+    MetalCommandList::MetalCommandList(const MetalCommandQueue *queue, const RenderCommandListDesc &desc) {
+        // Command buffers can only be committed once.
+        assert(!desc.reusable && "Reusable command lists are unsupported on Metal.");
+
         this->device = queue->device;
         this->queue = queue;
 
@@ -2343,6 +2543,16 @@ namespace plume {
         }
     }
 
+    uint32_t MetalCommandList::beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
+        // Metal has no split barriers, so the barriers are issued in full when the split begins.
+        barriers(stages, bufferBarriers, bufferBarriersCount, textureBarriers, textureBarriersCount);
+        return 0;
+    }
+
+    void MetalCommandList::endSplitBarriers(uint32_t splitIndex) {
+        // Nothing to do, the barriers were already issued when the split began.
+    }
+
     void MetalCommandList::barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, const uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, const uint32_t textureBarriersCount) {
         assert(bufferBarriersCount == 0 || bufferBarriers != nullptr);
         assert(textureBarriersCount == 0 || textureBarriers != nullptr);
@@ -2442,7 +2652,7 @@ namespace plume {
         checkActiveRenderEncoder();
         checkForUpdatesInGraphicsState();
 
-        activeRenderEncoder->drawPrimitives(activeRenderState->primitiveType, startVertexLocation, vertexCountPerInstance, instanceCount, startInstanceLocation);
+        activeRenderEncoder->drawPrimitives(currentPrimitiveType, startVertexLocation, vertexCountPerInstance, instanceCount, startInstanceLocation);
     }
 
     void MetalCommandList::drawIndexedInstanced(const uint32_t indexCountPerInstance, const uint32_t instanceCount, const uint32_t startIndexLocation, const int32_t baseVertexLocation, const uint32_t startInstanceLocation) {
@@ -2453,6 +2663,14 @@ namespace plume {
         activeRenderEncoder->drawIndexedPrimitives(currentPrimitiveType, indexCountPerInstance, currentIndexType, indexBuffer, indexBufferOffset + (startIndexLocation * indexTypeSize), instanceCount, baseVertexLocation, startInstanceLocation);
     }
 
+    void MetalCommandList::drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        assert(false && "Mesh shaders are unsupported on Metal.");
+    }
+
+    void MetalCommandList::drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount, uint32_t stride) {
+        assert(false && "Mesh shaders are unsupported on Metal.");
+    }
+
     void MetalCommandList::setPipeline(const RenderPipeline *pipeline) {
         assert(pipeline != nullptr);
 
@@ -2468,7 +2686,8 @@ namespace plume {
             }
             case MetalPipeline::Type::Graphics: {
                 const MetalGraphicsPipeline *graphicsPipeline = static_cast<const MetalGraphicsPipeline *>(interfacePipeline);
-                currentPrimitiveType = graphicsPipeline->state.primitiveType;
+                const bool dynamicPrimitiveType = (graphicsPipeline->state.dynamicStates & RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY);
+                currentPrimitiveType = dynamicPrimitiveType ? dynamicState.primitiveType : graphicsPipeline->state.primitiveType;
                 if (activeRenderState != &graphicsPipeline->state) {
                     activeRenderState = &graphicsPipeline->state;
                     dirtyGraphicsState.pipelineState = 1;
@@ -2696,6 +2915,89 @@ namespace plume {
         dynamicDepthBias.slopeScaledDepthBias = slopeScaledDepthBias;
     }
 
+    void MetalCommandList::setCullMode(RenderCullMode cullMode) {
+        const MTL::CullMode mtlCullMode = mapCullMode(cullMode);
+        if (dynamicState.cullMode != mtlCullMode) {
+            dynamicState.cullMode = mtlCullMode;
+            dirtyGraphicsState.dynamicStates = 1;
+        }
+    }
+
+    void MetalCommandList::setFrontFace(RenderFrontFace frontFace) {
+        const MTL::Winding winding = mapFrontFace(frontFace);
+        if (dynamicState.winding != winding) {
+            dynamicState.winding = winding;
+            dirtyGraphicsState.dynamicStates = 1;
+        }
+    }
+
+    void MetalCommandList::setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) {
+        // The primitive type is specified on every draw call, so there's no state to invalidate.
+        dynamicState.primitiveType = mapPrimitiveType(primitiveTopology);
+        if ((activeRenderState != nullptr) && (activeRenderState->dynamicStates & RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY)) {
+            currentPrimitiveType = dynamicState.primitiveType;
+        }
+    }
+
+    void MetalCommandList::setDepthEnabled(bool depthEnabled) {
+        assert(false && "Dynamic depth test is unsupported on Metal.");
+    }
+
+    void MetalCommandList::setDepthWriteEnabled(bool depthWriteEnabled) {
+        assert(false && "Dynamic depth write is unsupported on Metal.");
+    }
+
+    void MetalCommandList::setDepthFunction(RenderComparisonFunction depthFunction) {
+        assert(false && "Dynamic depth function is unsupported on Metal.");
+    }
+
+    void MetalCommandList::setStencilEnabled(bool stencilEnabled) {
+        assert(false && "Dynamic stencil test is unsupported on Metal.");
+    }
+
+    void MetalCommandList::setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) {
+        assert(false && "Dynamic stencil operations are unsupported on Metal.");
+    }
+
+    void MetalCommandList::setStencilReference(uint32_t stencilReference) {
+        if (dynamicState.stencilReference != stencilReference) {
+            dynamicState.stencilReference = stencilReference;
+            dirtyGraphicsState.dynamicStates = 1;
+        }
+    }
+
+    void MetalCommandList::setDepthBiasEnabled(bool depthBiasEnabled) {
+        if (dynamicState.depthBiasEnabled != depthBiasEnabled) {
+            dynamicState.depthBiasEnabled = depthBiasEnabled;
+            dirtyGraphicsState.depthBias = 1;
+        }
+    }
+
+    void MetalCommandList::setDepthClipEnabled(bool depthClipEnabled) {
+        const MTL::DepthClipMode depthClipMode = depthClipEnabled ? MTL::DepthClipModeClip : MTL::DepthClipModeClamp;
+        if (dynamicState.depthClipMode != depthClipMode) {
+            dynamicState.depthClipMode = depthClipMode;
+            dirtyGraphicsState.dynamicStates = 1;
+        }
+    }
+
+    bool MetalCommandList::setVertexInput(const RenderInputSlot *, uint32_t, const RenderInputElement *, uint32_t) {
+        assert(false && "Dynamic vertex input is unsupported on Metal.");
+        return false;
+    }
+
+    void MetalCommandList::setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) {
+        assert(false && "Shader objects are unsupported on Metal.");
+    }
+
+    void MetalCommandList::setComputeShaderObject(const RenderShaderObject *computeShader) {
+        assert(false && "Shader objects are unsupported on Metal.");
+    }
+
+    void MetalCommandList::setShaderObjectState(const RenderGraphicsPipelineDesc &desc) {
+        assert(false && "Shader objects are unsupported on Metal.");
+    }
+
     void MetalCommandList::setCommonClearState() const {
         activeRenderEncoder->setViewport({ 0, 0, static_cast<float>(targetFramebuffer->width), static_cast<float>(targetFramebuffer->height), 0.0f, 1.0f });
         activeRenderEncoder->setScissorRect(clampScissorRectIfNecessary({ 0, 0, static_cast<int32_t>(targetFramebuffer->width), static_cast<int32_t>(targetFramebuffer->height) }, targetFramebuffer));
@@ -2770,8 +3072,9 @@ namespace plume {
         const uint32_t rectCount = clearRectsCount > 0 ? clearRectsCount : 1;
         const size_t totalVertices = 6 * rectCount;  // 6 vertices per rect
 
-        thread_local std::vector<simd::float2> allVertices;
-        allVertices.resize(totalVertices);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<simd::float2> allVertices;
+        allVertices.resize(uint32_t(totalVertices));
 
         if (clearRectsCount > 0) {
             // Process each clear rect
@@ -2873,8 +3176,9 @@ namespace plume {
             const uint32_t rectCount = clearRectsCount > 0 ? clearRectsCount : 1;
             const size_t totalVertices = 6 * rectCount;  // 6 vertices per rect
 
-            thread_local std::vector<simd::float2> allVertices;
-            allVertices.resize(totalVertices);
+            RenderScratchScope scratchScope;
+            RenderScratchArray<simd::float2> allVertices;
+            allVertices.resize(uint32_t(totalVertices));
 
             if (clearRectsCount > 0) {
                 // Process each clear rect
@@ -2941,12 +3245,13 @@ namespace plume {
 
             // Calculate block size based on destination texture format
             const uint32_t blockWidth = RenderFormatBlockWidth(dstTexture->desc.format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(dstTexture->desc.format);
 
             // Use actual dimensions for the copy size
             const MTL::Size size = { srcLocation.placedFootprint.width, srcLocation.placedFootprint.height, srcLocation.placedFootprint.depth};
 
             const uint32_t horizontalBlocks = (srcLocation.placedFootprint.rowWidth + blockWidth - 1) / blockWidth;
-            const uint32_t verticalBlocks = (srcLocation.placedFootprint.height + blockWidth - 1) / blockWidth;
+            const uint32_t verticalBlocks = (srcLocation.placedFootprint.height + blockHeight - 1) / blockHeight;
             const uint32_t bytesPerRow = horizontalBlocks * RenderFormatSize(dstTexture->desc.format);
             const uint32_t bytesPerImage = bytesPerRow * verticalBlocks;
 
@@ -2965,6 +3270,43 @@ namespace plume {
                 dstOrigin
             );
             activeBlitEncoder->popDebugGroup();
+        } else if (dstLocation.type == RenderTextureCopyType::PLACED_FOOTPRINT && srcLocation.type == RenderTextureCopyType::SUBRESOURCE) {
+            assert(dstBuffer != nullptr);
+            assert(srcTexture != nullptr);
+
+            // Calculate block size based on source texture format
+            const uint32_t blockWidth = RenderFormatBlockWidth(srcTexture->desc.format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(srcTexture->desc.format);
+
+            MTL::Origin srcOrigin;
+            MTL::Size size;
+
+            if (srcBox != nullptr) {
+                srcOrigin = { NS::UInteger(srcBox->left), NS::UInteger(srcBox->top), NS::UInteger(srcBox->front) };
+                size = { NS::UInteger(srcBox->right - srcBox->left), NS::UInteger(srcBox->bottom - srcBox->top), NS::UInteger(srcBox->back - srcBox->front) };
+            } else {
+                srcOrigin = { 0, 0, 0 };
+                size = { dstLocation.placedFootprint.width, dstLocation.placedFootprint.height, dstLocation.placedFootprint.depth };
+            }
+
+            const uint32_t horizontalBlocks = (dstLocation.placedFootprint.rowWidth + blockWidth - 1) / blockWidth;
+            const uint32_t verticalBlocks = (dstLocation.placedFootprint.height + blockHeight - 1) / blockHeight;
+            const uint32_t bytesPerRow = horizontalBlocks * RenderFormatSize(srcTexture->desc.format);
+            const uint32_t bytesPerImage = bytesPerRow * verticalBlocks;
+
+            activeBlitEncoder->pushDebugGroup(MTLSTR("CopyTextureRegion"));
+            activeBlitEncoder->copyFromTexture(
+                srcTexture->mtl,
+                srcLocation.subresource.arrayIndex,
+                srcLocation.subresource.mipLevel,
+                srcOrigin,
+                size,
+                dstBuffer->mtl,
+                dstLocation.placedFootprint.offset,
+                bytesPerRow,
+                bytesPerImage
+            );
+            activeBlitEncoder->popDebugGroup();
         } else {
             assert(dstTexture != nullptr);
             assert(srcTexture != nullptr);
@@ -3325,6 +3667,10 @@ namespace plume {
                 renderDescriptor->setSamplePositions(targetFramebuffer->samplePositions, targetFramebuffer->sampleCount);
             }
 
+            if (targetFramebuffer->renderTargetArrayLength > 0) {
+                renderDescriptor->setRenderTargetArrayLength(targetFramebuffer->renderTargetArrayLength);
+            }
+
             activeRenderEncoder = mtl->renderCommandEncoder(renderDescriptor);
             activeRenderEncoder->setLabel(MTLSTR("Graphics Render Encoder"));
 
@@ -3350,15 +3696,35 @@ namespace plume {
             if (activeRenderState) {
                 activeRenderEncoder->setRenderPipelineState(activeRenderState->renderPipelineState);
                 activeRenderEncoder->setDepthStencilState(activeRenderState->depthStencilState);
-                activeRenderEncoder->setDepthClipMode(activeRenderState->depthClipMode);
-                activeRenderEncoder->setCullMode(activeRenderState->cullMode);
-                activeRenderEncoder->setFrontFacingWinding(activeRenderState->winding);
-                activeRenderEncoder->setStencilReferenceValue(activeRenderState->stencilReference);
                 stateCache.lastPipelineState = activeRenderState->renderPipelineState;
+                dirtyGraphicsState.dynamicStates = 1;
+
+                // The amplification persists on the encoder, so it must be reset when switching back to a pipeline without multiview.
+                if (activeRenderState->viewMask != stateCache.lastViewMask) {
+                    if (activeRenderState->viewMappings.empty()) {
+                        activeRenderEncoder->setVertexAmplificationCount(1, nullptr);
+                    }
+                    else {
+                        activeRenderEncoder->setVertexAmplificationCount(activeRenderState->viewMappings.size(), activeRenderState->viewMappings.data());
+                    }
+
+                    stateCache.lastViewMask = activeRenderState->viewMask;
+                }
             }
             dirtyGraphicsState.pipelineState = 0;
         }
 
+        if (dirtyGraphicsState.dynamicStates) {
+            if (activeRenderState) {
+                const RenderDynamicStateFlags dynamicStates = activeRenderState->dynamicStates;
+                activeRenderEncoder->setDepthClipMode((dynamicStates & RenderDynamicStateFlag::DEPTH_CLIP_ENABLED) ? dynamicState.depthClipMode : activeRenderState->depthClipMode);
+                activeRenderEncoder->setCullMode((dynamicStates & RenderDynamicStateFlag::CULL_MODE) ? dynamicState.cullMode : activeRenderState->cullMode);
+                activeRenderEncoder->setFrontFacingWinding((dynamicStates & RenderDynamicStateFlag::FRONT_FACE) ? dynamicState.winding : activeRenderState->winding);
+                activeRenderEncoder->setStencilReferenceValue((dynamicStates & RenderDynamicStateFlag::STENCIL_REFERENCE) ? dynamicState.stencilReference : activeRenderState->stencilReference);
+            }
+            dirtyGraphicsState.dynamicStates = 0;
+        }
+
         if (dirtyGraphicsState.viewports) {
             if (viewportVector.empty()) return;
 
@@ -3368,7 +3734,9 @@ namespace plume {
         }
 
         if (dirtyGraphicsState.depthBias) {
-            if (activeRenderState->dynamicDepthBiasEnabled) {
+            if ((activeRenderState->dynamicStates & RenderDynamicStateFlag::DEPTH_BIAS_ENABLED) && !dynamicState.depthBiasEnabled) {
+                activeRenderEncoder->setDepthBias(0.0f, 0.0f, 0.0f);
+            } else if (activeRenderState->dynamicDepthBiasEnabled) {
                 activeRenderEncoder->setDepthBias(dynamicDepthBias.depthBias, dynamicDepthBias.slopeScaledDepthBias, dynamicDepthBias.depthBiasClamp);
             } else {
                 activeRenderEncoder->setDepthBias(activeRenderState->depthBiasConstantFactor, activeRenderState->depthBiasSlopeFactor, activeRenderState->depthBiasClamp);
@@ -3441,6 +3809,7 @@ namespace plume {
 
             // Clear state cache since we'll need to rebind everything
             stateCache.lastPipelineState = nullptr;
+            stateCache.lastViewMask = 0;
             stateCache.lastViewports.clear();
             stateCache.lastScissors.clear();
             stateCache.lastPushConstants.clear();
@@ -3557,6 +3926,11 @@ namespace plume {
         mtl->release();
     }
 
+    RenderExternalHandle MetalCommandSemaphore::exportHandle() {
+        assert(false && "External semaphores are unsupported on Metal.");
+        return RenderExternalHandleInvalid;
+    }
+
     // MetalCommandQueue
 
     MetalCommandQueue::MetalCommandQueue(MetalDevice *device, RenderCommandListType type) {
@@ -3576,8 +3950,8 @@ namespace plume {
         mtl->release();
     }
 
-    std::unique_ptr<RenderCommandList> MetalCommandQueue::createCommandList() {
-        return std::make_unique<MetalCommandList>(this);
+    std::unique_ptr<RenderCommandList> MetalCommandQueue::createCommandList(const RenderCommandListDesc &desc) {
+        return std::make_unique<MetalCommandList>(this, desc);
     }
 
     std::unique_ptr<RenderSwapChain> MetalCommandQueue::createSwapChain(RenderWindow renderWindow, uint32_t textureCount, RenderFormat format, uint32_t maxFrameLatency) {
@@ -3720,11 +4094,39 @@ namespace plume {
         capabilities.presentWait = true;
         capabilities.preferHDR = mtl->recommendedMaxWorkingSetSize() > (512 * 1024 * 1024);
         capabilities.dynamicDepthBias = true;
+        capabilities.dynamicStates = RenderDynamicStateFlag::CULL_MODE | RenderDynamicStateFlag::FRONT_FACE | RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY | RenderDynamicStateFlag::STENCIL_REFERENCE |
+            RenderDynamicStateFlag::DEPTH_BIAS_ENABLED | RenderDynamicStateFlag::DEPTH_CLIP_ENABLED;
         capabilities.uma = mtl->hasUnifiedMemory();
         capabilities.gpuUploadHeap = capabilities.uma;
         capabilities.queryPools = timestampCounterSet != nullptr;
+        capabilities.specConstants = true;
         capabilities.samplerMirrorClampToEdge = true;
 
+        // Buffers can be created without copying from any page aligned memory.
+        capabilities.hostMemoryImport = true;
+        capabilities.hostMemoryImportAlignment = uint64_t(getpagesize());
+
+        // ETC2 and ASTC are only supported by Apple GPUs, with HDR ASTC starting from the A13.
+        capabilities.textureCompressionBC = mtl->supportsBCTextureCompression();
+        capabilities.textureCompressionETC2 = mtl->supportsFamily(MTL::GPUFamilyApple2);
+        capabilities.textureCompressionASTC = mtl->supportsFamily(MTL::GPUFamilyApple2);
+        capabilities.textureCompressionASTCHDR = mtl->supportsFamily(MTL::GPUFamilyApple6);
+
+        // Layered rendering is supported on all Mac GPUs and on Apple GPUs starting from the A12.
+        const bool layeredRenderingSupported = mtl->supportsFamily(MTL::GPUFamilyMac2) || mtl->supportsFamily(MTL::GPUFamilyApple5);
+        capabilities.layerOutputFromVertex = layeredRenderingSupported;
+        capabilities.maxFramebufferLayers = layeredRenderingSupported ? 2048 : 1;
+
+        // Find the highest amplification count supported by the device. Amplification counts are contiguous up to the maximum.
+        capabilities.multiview = mtl->supportsVertexAmplificationCount(2);
+        capabilities.maxMultiviewViewCount = 0;
+        if (capabilities.multiview) {
+            capabilities.maxMultiviewViewCount = 2;
+            while ((capabilities.maxMultiviewViewCount < 32) && mtl->supportsVertexAmplificationCount(capabilities.maxMultiviewViewCount + 1)) {
+                capabilities.maxMultiviewViewCount++;
+            }
+        }
+
 #if PLUME_IOS
         capabilities.descriptorIndexing = mtl->supportsFamily(MTL::GPUFamilyApple3);
         capabilities.displayTiming = false;
@@ -3773,6 +4175,11 @@ namespace plume {
         return std::make_unique<MetalShader>(this, data, size, entryPointName, format);
     }
 
+    std::vector<std::unique_ptr<RenderShaderObject>> MetalDevice::createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked) {
+        assert(false && "Shader objects are unsupported on Metal.");
+        return std::vector<std::unique_ptr<RenderShaderObject>>();
+    }
+
     std::unique_ptr<RenderSampler> MetalDevice::createSampler(const RenderSamplerDesc &desc) {
         return std::make_unique<MetalSampler>(this, desc);
     }
@@ -3798,10 +4205,29 @@ namespace plume {
         return std::make_unique<MetalBuffer>(this, nullptr, desc);
     }
 
+    std::unique_ptr<RenderBuffer> MetalDevice::createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        return std::make_unique<MetalBuffer>(this, hostPointer, size, flags);
+    }
+
     std::unique_ptr<RenderTexture> MetalDevice::createTexture(const RenderTextureDesc &desc) {
         return std::make_unique<MetalTexture>(this, nullptr, desc);
     }
 
+    std::unique_ptr<RenderBuffer> MetalDevice::createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(false && "External memory is unsupported on Metal.");
+        return nullptr;
+    }
+
+    std::unique_ptr<RenderTexture> MetalDevice::createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(false && "External memory is unsupported on Metal.");
+        return nullptr;
+    }
+
+    std::unique_ptr<RenderCommandSemaphore> MetalDevice::createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(false && "External semaphores are unsupported on Metal.");
+        return nullptr;
+    }
+
     std::unique_ptr<RenderAccelerationStructure> MetalDevice::createAccelerationStructure(const RenderAccelerationStructureDesc &desc) {
         return std::make_unique<MetalAccelerationStructure>(this, desc);
     }
@@ -3818,7 +4244,8 @@ namespace plume {
         return std::make_unique<MetalCommandFence>(this);
     }
 
-    std::unique_ptr<RenderCommandSemaphore> MetalDevice::createCommandSemaphore() {
+    std::unique_ptr<RenderCommandSemaphore> MetalDevice::createCommandSemaphore(RenderExternalHandleType exportHandleType) {
+        assert((exportHandleType == RenderExternalHandleType::NONE) && "External semaphores are unsupported on Metal.");
         return std::make_unique<MetalCommandSemaphore>(this);
     }
 
@@ -3861,6 +4288,173 @@ namespace plume {
         return supportedSampleCounts;
     }
 
+    RenderFormatSupport MetalDevice::getFormatSupport(RenderFormat format) const {
+        // Metal doesn't provide a query for format capabilities, so the support is derived from the feature set tables.
+        RenderFormatSupport support;
+        switch (format) {
+        case RenderFormat::UNKNOWN:
+            break;
+        case RenderFormat::R32G32B32_TYPELESS:
+        case RenderFormat::R32G32B32_FLOAT:
+        case RenderFormat::R32G32B32_UINT:
+        case RenderFormat::R32G32B32_SINT:
+            // There are no three component pixel formats, so these are only usable as vertex attributes.
+            support.flags = (format != RenderFormat::R32G32B32_TYPELESS) ? RenderFormatSupportFlag::VERTEX_BUFFER : RenderFormatSupportFlag::NONE;
+            break;
+        case RenderFormat::D16_UNORM:
+        case RenderFormat::D32_FLOAT:
+        case RenderFormat::D32_FLOAT_S8_UINT:
+            support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::DEPTH_TARGET;
+            break;
+        case RenderFormat::BC1_TYPELESS:
+        case RenderFormat::BC1_UNORM:
+        case RenderFormat::BC1_UNORM_SRGB:
+        case RenderFormat::BC2_TYPELESS:
+        case RenderFormat::BC2_UNORM:
+        case RenderFormat::BC2_UNORM_SRGB:
+        case RenderFormat::BC3_TYPELESS:
+        case RenderFormat::BC3_UNORM:
+        case RenderFormat::BC3_UNORM_SRGB:
+        case RenderFormat::BC4_TYPELESS:
+        case RenderFormat::BC4_UNORM:
+        case RenderFormat::BC4_SNORM:
+        case RenderFormat::BC5_TYPELESS:
+        case RenderFormat::BC5_UNORM:
+        case RenderFormat::BC5_SNORM:
+        case RenderFormat::BC6H_TYPELESS:
+        case RenderFormat::BC6H_UF16:
+        case RenderFormat::BC6H_SF16:
+        case RenderFormat::BC7_TYPELESS:
+        case RenderFormat::BC7_UNORM:
+        case RenderFormat::BC7_UNORM_SRGB:
+            if (capabilities.textureCompressionBC) {
+                support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::LINEAR_FILTER;
+            }
+
+            break;
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+        case RenderFormat::EAC_R11_UNORM:
+        case RenderFormat::EAC_R11_SNORM:
+        case RenderFormat::EAC_R11G11_UNORM:
+        case RenderFormat::EAC_R11G11_SNORM:
+            if (capabilities.textureCompressionETC2) {
+                support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::LINEAR_FILTER;
+            }
+
+            break;
+        case RenderFormat::ASTC_4X4_UNORM:
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X4_UNORM:
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X5_UNORM:
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X5_UNORM:
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X6_UNORM:
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X5_UNORM:
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+        case RenderFormat::ASTC_8X6_UNORM:
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X8_UNORM:
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X5_UNORM:
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+        case RenderFormat::ASTC_10X6_UNORM:
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+        case RenderFormat::ASTC_10X8_UNORM:
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X10_UNORM:
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X10_UNORM:
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X12_UNORM:
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+            if (capabilities.textureCompressionASTC) {
+                support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::LINEAR_FILTER;
+            }
+
+            break;
+        case RenderFormat::ASTC_4X4_FLOAT:
+        case RenderFormat::ASTC_5X4_FLOAT:
+        case RenderFormat::ASTC_5X5_FLOAT:
+        case RenderFormat::ASTC_6X5_FLOAT:
+        case RenderFormat::ASTC_6X6_FLOAT:
+        case RenderFormat::ASTC_8X5_FLOAT:
+        case RenderFormat::ASTC_8X6_FLOAT:
+        case RenderFormat::ASTC_8X8_FLOAT:
+        case RenderFormat::ASTC_10X5_FLOAT:
+        case RenderFormat::ASTC_10X6_FLOAT:
+        case RenderFormat::ASTC_10X8_FLOAT:
+        case RenderFormat::ASTC_10X10_FLOAT:
+        case RenderFormat::ASTC_12X10_FLOAT:
+        case RenderFormat::ASTC_12X12_FLOAT:
+            if (capabilities.textureCompressionASTCHDR) {
+                support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::LINEAR_FILTER;
+            }
+
+            break;
+        case RenderFormat::R32G32B32A32_UINT:
+        case RenderFormat::R32G32B32A32_SINT:
+        case RenderFormat::R16G16B16A16_UINT:
+        case RenderFormat::R16G16B16A16_SINT:
+        case RenderFormat::R32G32_UINT:
+        case RenderFormat::R32G32_SINT:
+        case RenderFormat::R8G8B8A8_UINT:
+        case RenderFormat::R8G8B8A8_SINT:
+        case RenderFormat::R16G16_UINT:
+        case RenderFormat::R16G16_SINT:
+        case RenderFormat::R32_UINT:
+        case RenderFormat::R32_SINT:
+        case RenderFormat::R8G8_UINT:
+        case RenderFormat::R8G8_SINT:
+        case RenderFormat::R16_UINT:
+        case RenderFormat::R16_SINT:
+        case RenderFormat::R8_UINT:
+        case RenderFormat::R8_SINT:
+            support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::READ_WRITE_TEXTURE | RenderFormatSupportFlag::RENDER_TARGET | RenderFormatSupportFlag::VERTEX_BUFFER |
+                RenderFormatSupportFlag::FORMATTED_BUFFER | RenderFormatSupportFlag::READ_WRITE_FORMATTED_BUFFER;
+
+            if ((format == RenderFormat::R32_UINT) || (format == RenderFormat::R32_SINT)) {
+                support.flags |= RenderFormatSupportFlag::READ_WRITE_TEXTURE_ATOMIC;
+            }
+
+            break;
+        default:
+            support.flags = RenderFormatSupportFlag::TEXTURE | RenderFormatSupportFlag::LINEAR_FILTER | RenderFormatSupportFlag::READ_WRITE_TEXTURE | RenderFormatSupportFlag::RENDER_TARGET |
+                RenderFormatSupportFlag::BLEND | RenderFormatSupportFlag::FORMATTED_BUFFER | RenderFormatSupportFlag::READ_WRITE_FORMATTED_BUFFER;
+
+            // Typeless formats have no vertex format equivalent.
+            const bool typeless = (format == RenderFormat::R32G32B32A32_TYPELESS) || (format == RenderFormat::R16G16B16A16_TYPELESS) || (format == RenderFormat::R32G32_TYPELESS) ||
+                (format == RenderFormat::R8G8B8A8_TYPELESS) || (format == RenderFormat::R16G16_TYPELESS) || (format == RenderFormat::R32_TYPELESS) ||
+                (format == RenderFormat::R8G8_TYPELESS) || (format == RenderFormat::R16_TYPELESS) || (format == RenderFormat::R8_TYPELESS);
+
+            if (!typeless) {
+                support.flags |= RenderFormatSupportFlag::VERTEX_BUFFER;
+            }
+
+            // Filtering of 32-bit float formats is optional.
+            const bool float32 = (format == RenderFormat::R32G32B32A32_FLOAT) || (format == RenderFormat::R32G32_FLOAT) || (format == RenderFormat::R32_FLOAT);
+            if (float32 && !mtl->supports32BitFloatFiltering()) {
+                support.flags &= ~RenderFormatSupportFlag::LINEAR_FILTER;
+            }
+
+            break;
+        }
+
+        // Sample counts are only reported for formats that can be used as targets.
+        if (support.flags & (RenderFormatSupportFlag::RENDER_TARGET | RenderFormatSupportFlag::DEPTH_TARGET)) {
+            support.sampleCounts = getSampleCountsSupported(format);
+        }
+
+        return support;
+    }
+
     void MetalDevice::release() {
         mtl->release();
     }
@@ -112,6 +112,7 @@ namespace plume {
         uint32_t scissors : 1;
         uint32_t indexBuffer : 1;
         uint32_t depthBias : 1;
+        uint32_t dynamicStates : 1;
 
         // marks from which descriptor set we'll invalidate from
         uint32_t descriptorSetDirtyIndex : 5;
@@ -127,6 +128,7 @@ namespace plume {
             scissors = 1;
             indexBuffer = 1;
             depthBias = 1;
+            dynamicStates = 1;
 
             descriptorSetDirtyIndex = 0;
             vertexBufferSlots = (1U << MAX_VERTEX_BUFFER_BINDINGS) - 1;
@@ -195,6 +197,9 @@ namespace plume {
         float depthBiasClamp;
         float depthBiasSlopeFactor;
         bool dynamicDepthBiasEnabled;
+        RenderDynamicStateFlags dynamicStates = RenderDynamicStateFlag::NONE;
+        uint32_t viewMask = 0;
+        std::vector<MTL::VertexAmplificationViewMapping> viewMappings;
     };
 
     struct ExtendedRenderTexture : RenderTexture {
@@ -202,7 +207,7 @@ namespace plume {
         virtual MTL::Texture* getTexture() const = 0;
     };
 
-    struct MetalDescriptorSet : RenderDescriptorSet {
+    struct MetalDescriptorSet final : RenderDescriptorSet {
         struct ResourceEntry {
             MTL::Resource* resource = nullptr;
             RenderDescriptorRangeType type = RenderDescriptorRangeType::UNKNOWN;
@@ -220,8 +225,8 @@ namespace plume {
         MetalDescriptorSet(MetalDevice *device, const RenderDescriptorSetDesc &desc);
         MetalDescriptorSet(MetalDevice *device, uint32_t entryCount);
         ~MetalDescriptorSet() override;
-        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize, const RenderBufferStructuredView *bufferStructuredView, const RenderBufferFormattedView *bufferFormattedView) override;
-        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView) override;
+        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize = 0, const RenderBufferStructuredView *bufferStructuredView = nullptr, const RenderBufferFormattedView *bufferFormattedView = nullptr) override;
+        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView = nullptr) override;
         void setSampler(uint32_t descriptorIndex, const RenderSampler *sampler) override;
         void setAccelerationStructure(uint32_t descriptorIndex, const RenderAccelerationStructure *accelerationStructure) override;
         void setDescriptor(uint32_t descriptorIndex, const Descriptor *descriptor);
@@ -230,7 +235,7 @@ namespace plume {
         RenderDescriptorRangeType getDescriptorType(uint32_t binding) const;
     };
 
-    struct MetalSwapChain : RenderSwapChain {
+    struct MetalSwapChain final : RenderSwapChain {
         CA::MetalLayer *layer = nullptr;
         MetalCommandQueue *commandQueue = nullptr;
         RenderFormat format = RenderFormat::UNKNOWN;
@@ -280,7 +285,7 @@ namespace plume {
         MTL::Texture* getTexture() const;
     };
 
-    struct MetalFramebuffer : RenderFramebuffer {
+    struct MetalFramebuffer final : RenderFramebuffer {
         bool depthAttachmentReadOnly = false;
         uint32_t width = 0;
         uint32_t height = 0;
@@ -290,6 +295,7 @@ namespace plume {
         MTL::SamplePosition samplePositions[16] = {};
         uint32_t sampleCount = 0;
         bool samplePositionsEnabled = false;
+        uint32_t renderTargetArrayLength = 0;
 
         MetalFramebuffer(const MetalDevice *device, const RenderFramebufferDesc &desc);
         ~MetalFramebuffer() override;
@@ -297,7 +303,7 @@ namespace plume {
         uint32_t getHeight() const override;
     };
 
-    struct MetalQueryPool : RenderQueryPool {
+    struct MetalQueryPool final : RenderQueryPool {
         MetalDevice *device = nullptr;
         MTL::CounterSampleBuffer *sampleBuffer = nullptr;
         std::vector<uint64_t> results;
@@ -330,7 +336,11 @@ namespace plume {
         }
     }
 
-    struct MetalCommandList : RenderCommandList {
+    struct MetalCommandList final : RenderCommandList {
+        using RenderCommandList::barriers;
+        using RenderCommandList::setViewports;
+        using RenderCommandList::setScissors;
+
         union ClearValue {
             RenderColor color;
             float depth;
@@ -371,6 +381,7 @@ namespace plume {
 
         struct {
             MTL::RenderPipelineState* lastPipelineState = nullptr;
+            uint32_t lastViewMask = 0;
             std::vector<MTL::Viewport> lastViewports;
             std::vector<MTL::ScissorRect> lastScissors;
             std::vector<PushConstantData> lastPushConstants;
@@ -394,6 +405,15 @@ namespace plume {
             float slopeScaledDepthBias;
         } dynamicDepthBias;
 
+        struct {
+            MTL::CullMode cullMode = MTL::CullModeNone;
+            MTL::Winding winding = MTL::WindingClockwise;
+            MTL::PrimitiveType primitiveType = MTL::PrimitiveTypeTriangle;
+            MTL::DepthClipMode depthClipMode = MTL::DepthClipModeClip;
+            uint32_t stencilReference = 0;
+            bool depthBiasEnabled = false;
+        } dynamicState;
+
         struct {
             uint32_t updateDirtyBits = ~0;
             int update[MetalBarrierStage::COUNT] = {};
@@ -416,7 +436,7 @@ namespace plume {
         std::unordered_set<MetalDescriptorSet*> currentEncoderDescriptorSets;
         void bindEncoderResources(MTL::CommandEncoder* encoder, bool isCompute);
 
-        MetalCommandList(const MetalCommandQueue *queue);
+        MetalCommandList(const MetalCommandQueue *queue, const RenderCommandListDesc &desc);
         ~MetalCommandList() override;
         void begin() override;
         void end() override;
@@ -426,10 +446,14 @@ namespace plume {
         void guaranteeComputeEncoder();
         void clearDrawCalls();
         void barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        uint32_t beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        void endSplitBarriers(uint32_t splitIndex) override;
         void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) override;
         void traceRays(uint32_t width, uint32_t height, uint32_t depth, RenderBufferReference shaderBindingTable, const RenderShaderBindingGroupsInfo &shaderBindingGroupsInfo) override;
         void drawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) override;
         void drawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+        void drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount = 1, uint32_t stride = 12) override;
         void setPipeline(const RenderPipeline *pipeline) override;
         void setComputePipelineLayout(const RenderPipelineLayout *pipelineLayout) override;
         void setComputePushConstants(uint32_t rangeIndex, const void *data, uint32_t offset = 0, uint32_t size = 0) override;
@@ -447,14 +471,29 @@ namespace plume {
         void setScissors(const RenderRect *scissorRects, uint32_t count) override;
         void setFramebuffer(const RenderFramebuffer *framebuffer) override;
         void setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) override;
-        void clearColor(uint32_t attachmentIndex, RenderColor colorValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
-        void clearDepthStencil(bool clearDepth, bool clearStencil, float depthValue, uint32_t stencilValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
+        void setCullMode(RenderCullMode cullMode) override;
+        void setFrontFace(RenderFrontFace frontFace) override;
+        void setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) override;
+        void setDepthEnabled(bool depthEnabled) override;
+        void setDepthWriteEnabled(bool depthWriteEnabled) override;
+        void setDepthFunction(RenderComparisonFunction depthFunction) override;
+        void setStencilEnabled(bool stencilEnabled) override;
+        void setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) override;
+        void setStencilReference(uint32_t stencilReference) override;
+        void setDepthBiasEnabled(bool depthBiasEnabled) override;
+        void setDepthClipEnabled(bool depthClipEnabled) override;
+        bool setVertexInput(const RenderInputSlot *inputSlots, uint32_t inputSlotsCount, const RenderInputElement *inputElements, uint32_t inputElementsCount) override;
+        void setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) override;
+        void setComputeShaderObject(const RenderShaderObject *computeShader) override;
+        void setShaderObjectState(const RenderGraphicsPipelineDesc &desc) override;
+        void clearColor(uint32_t attachmentIndex = 0, RenderColor colorValue = RenderColor(), const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
+        void clearDepthStencil(bool clearDepth = true, bool clearStencil = true, float depthValue = 1.0f, uint32_t stencilValue = 0, const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
         void copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) override;
-        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX, uint32_t dstY, uint32_t dstZ, const RenderBox *srcBox) override;
+        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX = 0, uint32_t dstY = 0, uint32_t dstZ = 0, const RenderBox *srcBox = nullptr) override;
         void copyBuffer(const RenderBuffer *dstBuffer, const RenderBuffer *srcBuffer) override;
         void copyTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
         void resolveTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
-        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect, RenderResolveMode resolveMode) override;
+        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect = nullptr, RenderResolveMode resolveMode = RenderResolveMode::AVERAGE) override;
         void buildBottomLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, const RenderBottomLevelASBuildInfo &buildInfo) override;
         void buildTopLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, RenderBufferReference instancesBuffer, const RenderTopLevelASBuildInfo &buildInfo) override;
         void discardTexture(const RenderTexture* texture) override;
@@ -488,34 +527,38 @@ namespace plume {
 
     static uint64_t toStageMask(RenderBarrierStages stages);
 
-    struct MetalCommandFence : RenderCommandFence {
+    struct MetalCommandFence final : RenderCommandFence {
         dispatch_semaphore_t semaphore;
 
         MetalCommandFence(MetalDevice *device);
         ~MetalCommandFence() override;
     };
 
-    struct MetalCommandSemaphore : RenderCommandSemaphore {
+    struct MetalCommandSemaphore final : RenderCommandSemaphore {
         MTL::Event *mtl;
         std::atomic<uint64_t> mtlEventValue;
 
         MetalCommandSemaphore(const MetalDevice *device);
         ~MetalCommandSemaphore() override;
+        RenderExternalHandle exportHandle() override;
     };
 
-    struct MetalCommandQueue : RenderCommandQueue {
+    struct MetalCommandQueue final : RenderCommandQueue {
+        using RenderCommandQueue::createCommandList;
+        using RenderCommandQueue::executeCommandLists;
+
         MTL::CommandQueue *mtl = nullptr;
         MetalDevice *device = nullptr;
 
         MetalCommandQueue(MetalDevice *device, RenderCommandListType type);
         ~MetalCommandQueue() override;
-        std::unique_ptr<RenderCommandList> createCommandList() override;
+        std::unique_ptr<RenderCommandList> createCommandList(const RenderCommandListDesc &desc) override;
         std::unique_ptr<RenderSwapChain> createSwapChain(RenderWindow renderWindow, uint32_t bufferCount, RenderFormat format, uint32_t maxFrameLatency) override;
-        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores, uint32_t waitSemaphoreCount, RenderCommandSemaphore **signalSemaphores, uint32_t signalSemaphoreCount, RenderCommandFence *signalFence) override;
+        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores = nullptr, uint32_t waitSemaphoreCount = 0, RenderCommandSemaphore **signalSemaphores = nullptr, uint32_t signalSemaphoreCount = 0, RenderCommandFence *signalFence = nullptr) override;
         void waitForCommandFence(RenderCommandFence *fence) override;
     };
 
-    struct MetalBuffer : RenderBuffer {
+    struct MetalBuffer final : RenderBuffer {
         MTL::Buffer *mtl = nullptr;
         MetalPool *pool = nullptr;
         MetalDevice *device = nullptr;
@@ -524,15 +567,17 @@ namespace plume {
 
         MetalBuffer() = default;
         MetalBuffer(MetalDevice *device, MetalPool *pool, const RenderBufferDesc &desc);
+        MetalBuffer(MetalDevice *device, void *hostPointer, uint64_t size, RenderBufferFlags flags);
         ~MetalBuffer() override;
-        void *map(uint32_t subresource, const RenderRange *readRange) override;
-        void unmap(uint32_t subresource, const RenderRange *writtenRange) override;
+        void *map(uint32_t subresource = 0, const RenderRange *readRange = nullptr) override;
+        void unmap(uint32_t subresource = 0, const RenderRange *writtenRange = nullptr) override;
         std::unique_ptr<RenderBufferFormattedView> createBufferFormattedView(RenderFormat format) override;
         void setName(const std::string &name) override;
         uint64_t getDeviceAddress() const override;
+        RenderExternalHandle exportMemory() override;
     };
 
-    struct MetalBufferFormattedView : RenderBufferFormattedView {
+    struct MetalBufferFormattedView final : RenderBufferFormattedView {
         MetalBuffer *buffer = nullptr;
         MTL::Texture *texture = nullptr;
 
@@ -540,7 +585,7 @@ namespace plume {
         ~MetalBufferFormattedView() override;
     };
 
-    struct MetalDrawable : ExtendedRenderTexture {
+    struct MetalDrawable final : ExtendedRenderTexture {
         CA::MetalDrawable *mtl = nullptr;
 
 
@@ -549,10 +594,11 @@ namespace plume {
         ~MetalDrawable() override;
         std::unique_ptr<RenderTextureView> createTextureView(const RenderTextureViewDesc &desc) const override;
         void setName(const std::string &name) override;
+        RenderExternalHandle exportMemory() override;
         MTL::Texture* getTexture() const override { return mtl->texture(); }
     };
 
-    struct MetalTexture : ExtendedRenderTexture {
+    struct MetalTexture final : ExtendedRenderTexture {
         MTL::Texture *mtl = nullptr;
         RenderTextureLayout layout = RenderTextureLayout::UNKNOWN;
         MetalPool *pool = nullptr;
@@ -564,10 +610,11 @@ namespace plume {
         ~MetalTexture() override;
         std::unique_ptr<RenderTextureView> createTextureView(const RenderTextureViewDesc &desc) const override;
         void setName(const std::string &name) override;
+        RenderExternalHandle exportMemory() override;
         MTL::Texture* getTexture() const override { return mtl; }
     };
 
-    struct MetalTextureView : RenderTextureView {
+    struct MetalTextureView final : RenderTextureView {
         MTL::Texture *texture = nullptr;
         const MetalTexture *parentTexture = nullptr;
         RenderTextureViewDesc desc;
@@ -576,7 +623,7 @@ namespace plume {
         ~MetalTextureView() override;
     };
 
-    struct MetalAccelerationStructure : RenderAccelerationStructure {
+    struct MetalAccelerationStructure final : RenderAccelerationStructure {
         MetalDevice *device = nullptr;
         const MetalBuffer *buffer = nullptr;
         uint64_t offset = 0;
@@ -587,7 +634,7 @@ namespace plume {
         ~MetalAccelerationStructure() override;
     };
 
-    struct MetalPool : RenderPool {
+    struct MetalPool final : RenderPool {
         MTL::Heap *heap = nullptr;
         MetalDevice *device = nullptr;
 
@@ -597,7 +644,7 @@ namespace plume {
         std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) override;
     };
 
-    struct MetalShader : RenderShader {
+    struct MetalShader final : RenderShader {
         NS::String *functionName = nullptr;
         RenderShaderFormat format = RenderShaderFormat::UNKNOWN;
         MTL::Library *library = nullptr;
@@ -609,7 +656,7 @@ namespace plume {
         MTL::Function* createFunction(const RenderSpecConstant *specConstants, uint32_t specConstantsCount) const;
     };
 
-    struct MetalSampler : RenderSampler {
+    struct MetalSampler final : RenderSampler {
         MTL::SamplerState *state = nullptr;
         RenderBorderColor borderColor = RenderBorderColor::UNKNOWN;
         RenderShaderVisibility shaderVisibility = RenderShaderVisibility::UNKNOWN;
@@ -632,7 +679,7 @@ namespace plume {
         ~MetalPipeline() override;
     };
 
-    struct MetalComputePipeline : MetalPipeline {
+    struct MetalComputePipeline final : MetalPipeline {
         MetalComputeState state;
 
         MetalComputePipeline(const MetalDevice *device, const RenderComputePipelineDesc &desc);
@@ -641,7 +688,7 @@ namespace plume {
         RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct MetalGraphicsPipeline : MetalPipeline {
+    struct MetalGraphicsPipeline final : MetalPipeline {
         MetalRenderState state;
 
         MetalGraphicsPipeline(const MetalDevice *device, const RenderGraphicsPipelineDesc &desc);
@@ -650,7 +697,7 @@ namespace plume {
         RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct MetalPipelineLayout : RenderPipelineLayout {
+    struct MetalPipelineLayout final : RenderPipelineLayout {
         std::vector<RenderPushConstantRange> pushConstantRanges;
         uint32_t setLayoutCount = 0;
 
@@ -659,7 +706,10 @@ namespace plume {
         void bindDescriptorSets(MTL::CommandEncoder* encoder, const MetalDescriptorSet* const* descriptorSets, uint32_t descriptorSetCount, bool isCompute, uint32_t startIndex, std::unordered_set<MetalDescriptorSet*>& encoderDescriptorSets, MTL::CommandBuffer* commandBuffer) const;
     };
 
-    struct MetalDevice : RenderDevice {
+    struct MetalDevice final : RenderDevice {
+        using RenderDevice::createBufferFromHostMemory;
+        using RenderDevice::createCommandSemaphore;
+
         MTL::Device *mtl = nullptr;
         MetalInterface *renderInterface = nullptr;
         RenderDeviceCapabilities capabilities;
@@ -699,26 +749,32 @@ namespace plume {
         ~MetalDevice() override;
         std::unique_ptr<RenderDescriptorSet> createDescriptorSet(const RenderDescriptorSetDesc &desc) override;
         std::unique_ptr<RenderShader> createShader(const void *data, uint64_t size, const char *entryPointName, RenderShaderFormat format) override;
+        std::vector<std::unique_ptr<RenderShaderObject>> createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked = false) override;
         std::unique_ptr<RenderSampler> createSampler(const RenderSamplerDesc &desc) override;
         std::unique_ptr<RenderPipeline> createComputePipeline(const RenderComputePipelineDesc &desc) override;
         std::unique_ptr<RenderPipeline> createGraphicsPipeline(const RenderGraphicsPipelineDesc &desc) override;
-        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline) override;
+        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline = nullptr) override;
         std::unique_ptr<RenderCommandQueue> createCommandQueue(RenderCommandListType type) override;
         std::unique_ptr<RenderBuffer> createBuffer(const RenderBufferDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) override;
         std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderTexture> createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) override;
         std::unique_ptr<RenderAccelerationStructure> createAccelerationStructure(const RenderAccelerationStructureDesc &desc) override;
         std::unique_ptr<RenderPool> createPool(const RenderPoolDesc &desc) override;
         std::unique_ptr<RenderPipelineLayout> createPipelineLayout(const RenderPipelineLayoutDesc &desc) override;
         std::unique_ptr<RenderCommandFence> createCommandFence() override;
-        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore() override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore(RenderExternalHandleType exportHandleType) override;
         std::unique_ptr<RenderFramebuffer> createFramebuffer(const RenderFramebufferDesc &desc) override;
         std::unique_ptr<RenderQueryPool> createQueryPool(uint32_t queryCount) override;
-        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild, bool preferFastTrace) override;
-        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild, bool preferFastTrace) override;
+        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
+        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
         void setShaderBindingTableInfo(RenderShaderBindingTableInfo &tableInfo, const RenderShaderBindingGroups &groups, const RenderPipeline *pipeline, RenderDescriptorSet **descriptorSets, uint32_t descriptorSetCount) override;
         const RenderDeviceCapabilities &getCapabilities() const override;
         const RenderDeviceDescription &getDescription() const override;
         RenderSampleCounts getSampleCountsSupported(RenderFormat format) const override;
+        RenderFormatSupport getFormatSupport(RenderFormat format) const override;
         void release();
         bool isValid() const;
         bool beginCapture() override;
@@ -733,15 +789,33 @@ namespace plume {
         MTL::RenderPipelineState* getOrCreateClearRenderPipelineState(MTL::RenderPipelineDescriptor *pipelineDesc, bool depthWriteEnabled = false, bool stencilWriteEnabled = false);
     };
 
-    struct MetalInterface : RenderInterface {
+    struct MetalInterface final : RenderInterface {
         std::vector<std::string> deviceNames;
         RenderInterfaceCapabilities capabilities;
 
         MetalInterface();
         ~MetalInterface() override;
-        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName) override;
+        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName = "") override;
         const RenderInterfaceCapabilities &getCapabilities() const override;
         const std::vector<std::string> &getDeviceNames() const override;
         bool isValid() const;
     };
+
+#if defined(PLUME_SINGLE_BACKEND_METAL)
+    // Only this backend is built, so applications can cast to the final types below to let the compiler resolve and inline the calls.
+    typedef MetalBuffer RenderBackendBuffer;
+    typedef MetalDescriptorSet RenderBackendDescriptorSet;
+    typedef MetalSwapChain RenderBackendSwapChain;
+    typedef MetalFramebuffer RenderBackendFramebuffer;
+    typedef MetalQueryPool RenderBackendQueryPool;
+    typedef MetalCommandList RenderBackendCommandList;
+    typedef MetalCommandFence RenderBackendCommandFence;
+    typedef MetalCommandSemaphore RenderBackendCommandSemaphore;
+    typedef MetalCommandQueue RenderBackendCommandQueue;
+    typedef MetalPool RenderBackendPool;
+    typedef MetalPipelineLayout RenderBackendPipelineLayout;
+    typedef MetalSampler RenderBackendSampler;
+    typedef MetalDevice RenderBackendDevice;
+    typedef MetalInterface RenderBackendInterface;
+#endif
 }
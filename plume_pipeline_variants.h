@@ -0,0 +1,352 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    // Set of specialization constants that is kept sorted by index so equal sets always hash and compare the same.
+    struct RenderSpecConstantSet {
+        std::vector<RenderSpecConstant> constants;
+
+        RenderSpecConstantSet() = default;
+
+        void set(uint32_t index, uint32_t value, RenderSpecConstantType type) {
+            auto it = std::lower_bound(constants.begin(), constants.end(), index, [](const RenderSpecConstant &constant, uint32_t index) {
+                return constant.index < index;
+            });
+
+            if ((it != constants.end()) && (it->index == index)) {
+                it->value = value;
+                it->type = type;
+            }
+            else {
+                constants.insert(it, RenderSpecConstant(index, value, type));
+            }
+        }
+
+        void setBool(uint32_t index, bool value) {
+            set(index, value ? 1U : 0U, RenderSpecConstantType::BOOL);
+        }
+
+        void setInt(uint32_t index, int32_t value) {
+            set(index, uint32_t(value), RenderSpecConstantType::INT);
+        }
+
+        void setUint(uint32_t index, uint32_t value) {
+            set(index, value, RenderSpecConstantType::UINT);
+        }
+
+        void setFloat(uint32_t index, float value) {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            set(index, bits, RenderSpecConstantType::FLOAT);
+        }
+
+        uint64_t hash() const {
+            // FNV-1a.
+            uint64_t result = 14695981039346656037ULL;
+            auto hashValue = [&](uint32_t value) {
+                for (uint32_t i = 0; i < 4; i++) {
+                    result ^= (value >> (i * 8)) & 0xFF;
+                    result *= 1099511628211ULL;
+                }
+            };
+
+            for (const RenderSpecConstant &constant : constants) {
+                hashValue(constant.index);
+                hashValue(constant.value);
+                hashValue(uint32_t(constant.type));
+            }
+
+            return result;
+        }
+
+        bool operator==(const RenderSpecConstantSet &other) const {
+            if (constants.size() != other.constants.size()) {
+                return false;
+            }
+
+            for (size_t i = 0; i < constants.size(); i++) {
+                const RenderSpecConstant &a = constants[i];
+                const RenderSpecConstant &b = other.constants[i];
+                if ((a.index != b.index) || (a.value != b.value) || (a.type != b.type)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    // Creates specialized variants of a base pipeline and hands out the generic pipeline built from the base description
+    // until the requested variant is ready. Variants are deduplicated by their constants and identified by a stable handle.
+    //
+    // Variants are compiled on worker threads the first time they're requested, or immediately if they're added with precompile.
+    // The shaders and pipeline layout of the base description, as well as the semantic names of its input elements, must outlive the cache.
+    //
+    // On backends that don't support specialization constants (D3D12), variants are ready as soon as they're requested and use the generic pipeline.
+    struct RenderPipelineVariantCache {
+        enum class State {
+            IDLE,
+            QUEUED,
+            READY,
+            FAILED
+        };
+
+        struct Variant {
+            RenderSpecConstantSet specConstants;
+            std::unique_ptr<RenderPipeline> pipeline;
+            std::atomic<State> state = State::IDLE;
+        };
+
+        RenderDevice *device = nullptr;
+        bool compute = false;
+        RenderGraphicsPipelineDesc graphicsDesc;
+        RenderComputePipelineDesc computeDesc;
+        std::vector<RenderInputSlot> inputSlots;
+        std::vector<RenderInputElement> inputElements;
+        std::vector<RenderSpecConstant> baseSpecConstants;
+        std::unique_ptr<RenderPipeline> genericPipeline;
+        std::deque<Variant> variants;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> variantHandles;
+        std::deque<uint32_t> jobQueue;
+        uint32_t jobsPending = 0;
+        bool specConstantsSupported = false;
+        std::vector<std::thread> workers;
+        std::mutex variantMutex;
+        std::condition_variable jobCondition;
+        std::condition_variable idleCondition;
+        bool stopWorkers = false;
+
+        RenderPipelineVariantCache() = default;
+
+        RenderPipelineVariantCache(RenderDevice *device, const RenderGraphicsPipelineDesc &desc, uint32_t threadCount = 1) {
+            create(device, desc, threadCount);
+        }
+
+        RenderPipelineVariantCache(RenderDevice *device, const RenderComputePipelineDesc &desc, uint32_t threadCount = 1) {
+            create(device, desc, threadCount);
+        }
+
+        ~RenderPipelineVariantCache() {
+            release();
+        }
+
+        void create(RenderDevice *device, const RenderGraphicsPipelineDesc &desc, uint32_t threadCount = 1) {
+            assert(device != nullptr);
+            assert((genericPipeline == nullptr) && "Cache must be released before being created again.");
+
+            this->device = device;
+            compute = false;
+            specConstantsSupported = device->getCapabilities().specConstants;
+            graphicsDesc = desc;
+            inputSlots.assign(desc.inputSlots, desc.inputSlots + desc.inputSlotsCount);
+            inputElements.assign(desc.inputElements, desc.inputElements + desc.inputElementsCount);
+            baseSpecConstants.assign(desc.specConstants, desc.specConstants + desc.specConstantsCount);
+            graphicsDesc.inputSlots = inputSlots.data();
+            graphicsDesc.inputElements = inputElements.data();
+            graphicsDesc.specConstants = baseSpecConstants.data();
+            genericPipeline = device->createGraphicsPipeline(graphicsDesc);
+            startWorkers(threadCount);
+        }
+
+        void create(RenderDevice *device, const RenderComputePipelineDesc &desc, uint32_t threadCount = 1) {
+            assert(device != nullptr);
+            assert((genericPipeline == nullptr) && "Cache must be released before being created again.");
+
+            this->device = device;
+            compute = true;
+            specConstantsSupported = device->getCapabilities().specConstants;
+            computeDesc = desc;
+            baseSpecConstants.assign(desc.specConstants, desc.specConstants + desc.specConstantsCount);
+            computeDesc.specConstants = baseSpecConstants.data();
+            genericPipeline = device->createComputePipeline(computeDesc);
+            startWorkers(threadCount);
+        }
+
+        // Waits for the variants being compiled to finish and destroys all pipelines.
+        void release() {
+            {
+                const std::scoped_lock lock(variantMutex);
+                stopWorkers = true;
+
+                // The dropped jobs will never finish, so they must stop counting as pending for anyone waiting on the cache to be idle.
+                jobsPending -= uint32_t(jobQueue.size());
+                jobQueue.clear();
+            }
+
+            jobCondition.notify_all();
+            idleCondition.notify_all();
+            for (std::thread &worker : workers) {
+                worker.join();
+            }
+
+            workers.clear();
+            variantHandles.clear();
+            variants.clear();
+            genericPipeline.reset();
+            jobsPending = 0;
+            stopWorkers = false;
+        }
+
+        // Returns the same handle for variants with equal constants. The constants are merged over the ones in the base description.
+        uint32_t addVariant(const RenderSpecConstantSet &specConstants, bool precompile = false) {
+            const uint64_t hash = specConstants.hash();
+            uint32_t handle = 0;
+            {
+                const std::scoped_lock lock(variantMutex);
+                std::vector<uint32_t> &handles = variantHandles[hash];
+                for (uint32_t existingHandle : handles) {
+                    if (variants[existingHandle].specConstants == specConstants) {
+                        handle = existingHandle;
+                        if (precompile) {
+                            queueVariant(handle);
+                        }
+
+                        return handle;
+                    }
+                }
+
+                handle = uint32_t(variants.size());
+                variants.emplace_back().specConstants = specConstants;
+                handles.emplace_back(handle);
+                if (precompile) {
+                    queueVariant(handle);
+                }
+            }
+
+            jobCondition.notify_one();
+            return handle;
+        }
+
+        // Returns the specialized pipeline if it's ready or the generic pipeline otherwise. Queues the variant for compilation on the first request.
+        const RenderPipeline *getPipeline(uint32_t handle) {
+            Variant *variant;
+            {
+                const std::scoped_lock lock(variantMutex);
+                assert((handle < variants.size()) && "Unknown variant handle.");
+                variant = &variants[handle];
+            }
+
+            State state = variant->state.load(std::memory_order_acquire);
+            if (state == State::READY) {
+                return (variant->pipeline != nullptr) ? variant->pipeline.get() : genericPipeline.get();
+            }
+            else if (state == State::IDLE) {
+                {
+                    const std::scoped_lock lock(variantMutex);
+                    queueVariant(handle);
+                }
+
+                jobCondition.notify_one();
+            }
+
+            return genericPipeline.get();
+        }
+
+        const RenderPipeline *getGenericPipeline() const {
+            return genericPipeline.get();
+        }
+
+        bool isReady(uint32_t handle) {
+            const std::scoped_lock lock(variantMutex);
+            assert((handle < variants.size()) && "Unknown variant handle.");
+            return variants[handle].state.load(std::memory_order_acquire) == State::READY;
+        }
+
+        // Blocks until all queued variants have finished compiling.
+        void waitIdle() {
+            std::unique_lock<std::mutex> lock(variantMutex);
+            idleCondition.wait(lock, [this]() { return jobsPending == 0; });
+        }
+
+        // Must be called with the mutex locked.
+        void queueVariant(uint32_t handle) {
+            State expected = State::IDLE;
+            if (!specConstantsSupported) {
+                // Compiling the variant would only create a copy of the generic pipeline.
+                variants[handle].state.compare_exchange_strong(expected, State::READY);
+            }
+            else if (variants[handle].state.compare_exchange_strong(expected, State::QUEUED)) {
+                jobQueue.emplace_back(handle);
+                jobsPending++;
+            }
+        }
+
+        void startWorkers(uint32_t threadCount) {
+            assert(threadCount > 0);
+            for (uint32_t i = 0; i < threadCount; i++) {
+                workers.emplace_back(&RenderPipelineVariantCache::workerLoop, this);
+            }
+        }
+
+        void workerLoop() {
+            while (true) {
+                Variant *variant;
+                {
+                    std::unique_lock<std::mutex> lock(variantMutex);
+                    jobCondition.wait(lock, [this]() { return stopWorkers || !jobQueue.empty(); });
+                    if (stopWorkers) {
+                        return;
+                    }
+
+                    variant = &variants[jobQueue.front()];
+                    jobQueue.pop_front();
+                }
+
+                std::unique_ptr<RenderPipeline> pipeline = createVariantPipeline(variant->specConstants);
+                {
+                    const std::scoped_lock lock(variantMutex);
+                    const bool created = (pipeline != nullptr);
+                    variant->pipeline = std::move(pipeline);
+                    variant->state.store(created ? State::READY : State::FAILED, std::memory_order_release);
+                    jobsPending--;
+                }
+
+                idleCondition.notify_all();
+            }
+        }
+
+        std::unique_ptr<RenderPipeline> createVariantPipeline(const RenderSpecConstantSet &specConstants) const {
+            std::vector<RenderSpecConstant> mergedConstants = specConstants.constants;
+            for (const RenderSpecConstant &baseConstant : baseSpecConstants) {
+                bool overridden = false;
+                for (const RenderSpecConstant &constant : specConstants.constants) {
+                    overridden = overridden || (constant.index == baseConstant.index);
+                }
+
+                if (!overridden) {
+                    mergedConstants.emplace_back(baseConstant);
+                }
+            }
+
+            if (compute) {
+                RenderComputePipelineDesc desc = computeDesc;
+                desc.specConstants = mergedConstants.data();
+                desc.specConstantsCount = uint32_t(mergedConstants.size());
+                return device->createComputePipeline(desc);
+            }
+            else {
+                RenderGraphicsPipelineDesc desc = graphicsDesc;
+                desc.specConstants = mergedConstants.data();
+                desc.specConstantsCount = uint32_t(mergedConstants.size());
+                return device->createGraphicsPipeline(desc);
+            }
+        }
+    };
+};
@@ -0,0 +1,243 @@
+//
+// plume
+//
+// Copyright (c) 2024 renderbag and contributors. All rights reserved.
+// Licensed under the MIT license. See LICENSE file for details.
+//
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <numeric>
+
+#include "plume_render_interface.h"
+
+namespace plume {
+    struct RenderReadbackResult {
+        const uint8_t *data = nullptr;
+        uint64_t size = 0;
+
+        // Only filled out for texture readbacks. Rows and slices are laid out with the pitches specified here.
+        RenderFormat format = RenderFormat::UNKNOWN;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        uint32_t rowPitch = 0;
+        uint32_t depthPitch = 0;
+    };
+
+    typedef std::function<void(const RenderReadbackResult &result)> RenderReadbackCallback;
+
+    // Sub-allocates readbacks from a ring of persistently mapped READBACK buffers, one for each frame in flight.
+    // The callbacks of a frame are invoked when the ring cycles back to it in beginFrame(), which must only be called
+    // after waiting on the fence that the command lists recorded during that frame were submitted with.
+    //
+    // The resources being read must already be in a state where they can be used as the source of a copy.
+    struct RenderReadbackRing {
+        // Offset and pitch alignments that satisfy the copy requirements of all backends. Texture offsets must also be a multiple of the format's size.
+        static constexpr uint64_t BufferOffsetAlignment = 16;
+        static constexpr uint64_t TextureOffsetAlignment = 512;
+        static constexpr uint32_t TextureRowPitchAlignment = 256;
+
+        struct Request {
+            RenderReadbackResult result;
+            uint64_t offset = 0;
+            RenderReadbackCallback callback;
+        };
+
+        struct Frame {
+            std::unique_ptr<RenderBuffer> buffer;
+            uint8_t *mappedData = nullptr;
+            uint64_t allocatedSize = 0;
+            std::vector<Request> requests;
+        };
+
+        RenderDevice *device = nullptr;
+        std::vector<Frame> frames;
+        uint64_t frameCapacity = 0;
+        uint32_t frameIndex = 0;
+
+        RenderReadbackRing() = default;
+
+        RenderReadbackRing(RenderDevice *device, uint32_t frameCount, uint64_t frameCapacity) {
+            create(device, frameCount, frameCapacity);
+        }
+
+        ~RenderReadbackRing() {
+            release();
+        }
+
+        void create(RenderDevice *device, uint32_t frameCount, uint64_t frameCapacity) {
+            assert(device != nullptr);
+            assert(frameCount > 0);
+            assert(frameCapacity > 0);
+            assert(frames.empty() && "Ring must be released before being created again.");
+
+            this->device = device;
+            this->frameCapacity = frameCapacity;
+            frameIndex = 0;
+            frames.resize(frameCount);
+            for (Frame &frame : frames) {
+                frame.buffer = device->createBuffer(RenderBufferDesc::ReadbackBuffer(frameCapacity));
+                frame.mappedData = reinterpret_cast<uint8_t *>(frame.buffer->map());
+                assert((frame.mappedData != nullptr) && "Readback buffer must be mappable.");
+            }
+        }
+
+        // Pending readbacks are discarded without invoking their callbacks.
+        void release() {
+            for (Frame &frame : frames) {
+                if (frame.mappedData != nullptr) {
+                    frame.buffer->unmap();
+                }
+            }
+
+            frames.clear();
+            frameCapacity = 0;
+            frameIndex = 0;
+        }
+
+        // Completes the readbacks previously recorded on the frame and makes it the target of new readbacks.
+        void beginFrame(uint32_t frameIndex) {
+            assert(frameIndex < frames.size());
+
+            completeFrame(frames[frameIndex]);
+            this->frameIndex = frameIndex;
+        }
+
+        // Completes the readbacks of all frames. Only valid after waiting for all submissions to finish.
+        void flush() {
+            for (Frame &frame : frames) {
+                completeFrame(frame);
+            }
+        }
+
+        // Returns false if the frame doesn't have enough space left for the readback.
+        bool readBuffer(RenderCommandList *commandList, RenderBufferReference srcBuffer, uint64_t size, const RenderReadbackCallback &callback) {
+            assert(commandList != nullptr);
+            assert(srcBuffer.ref != nullptr);
+            assert(size > 0);
+
+            uint64_t dstOffset = 0;
+            if (!allocate(size, BufferOffsetAlignment, dstOffset)) {
+                return false;
+            }
+
+            Frame &frame = frames[frameIndex];
+            commandList->copyBufferRegion(frame.buffer->at(dstOffset), srcBuffer, size);
+
+            Request request;
+            request.result.size = size;
+            request.offset = dstOffset;
+            request.callback = callback;
+            frame.requests.emplace_back(std::move(request));
+            return true;
+        }
+
+        // Reads the region of the subresource specified by the box. The format must match the texture's format.
+        bool readTexture(RenderCommandList *commandList, const RenderTextureCopyLocation &srcLocation, RenderFormat format, const RenderBox &srcBox, const RenderReadbackCallback &callback) {
+            assert(commandList != nullptr);
+            assert(srcLocation.type == RenderTextureCopyType::SUBRESOURCE);
+            assert(srcLocation.texture != nullptr);
+            assert((srcBox.right > srcBox.left) && (srcBox.bottom > srcBox.top) && (srcBox.back > srcBox.front));
+
+            const uint32_t width = uint32_t(srcBox.right - srcBox.left);
+            const uint32_t height = uint32_t(srcBox.bottom - srcBox.top);
+            const uint32_t depth = uint32_t(srcBox.back - srcBox.front);
+            const uint32_t formatSize = RenderFormatSize(format);
+            const uint32_t blockWidth = RenderFormatBlockWidth(format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(format);
+            assert((formatSize > 0) && "Format must have a known size.");
+
+            // Round up the row to the amount of blocks required for the pitch to be aligned while remaining a multiple of the format's size.
+            const uint32_t rowBlockAlignment = TextureRowPitchAlignment / std::gcd(TextureRowPitchAlignment, formatSize);
+            const uint32_t rowBlocks = uint32_t(roundUp((width + blockWidth - 1) / blockWidth, rowBlockAlignment));
+            const uint32_t columnBlocks = (height + blockHeight - 1) / blockHeight;
+            const uint32_t rowPitch = rowBlocks * formatSize;
+            const uint32_t depthPitch = rowPitch * columnBlocks;
+            const uint64_t size = uint64_t(depthPitch) * depth;
+
+            uint64_t dstOffset = 0;
+            const uint64_t offsetAlignment = std::lcm(TextureOffsetAlignment, uint64_t(formatSize));
+            if (!allocate(size, offsetAlignment, dstOffset)) {
+                return false;
+            }
+
+            Frame &frame = frames[frameIndex];
+            const RenderTextureCopyLocation dstLocation = RenderTextureCopyLocation::PlacedFootprint(frame.buffer.get(), format, width, height, depth, rowBlocks * blockWidth, dstOffset);
+            commandList->copyTextureRegion(dstLocation, srcLocation, 0, 0, 0, &srcBox);
+
+            Request request;
+            request.result.size = size;
+            request.result.format = format;
+            request.result.width = width;
+            request.result.height = height;
+            request.result.depth = depth;
+            request.result.rowPitch = rowPitch;
+            request.result.depthPitch = depthPitch;
+            request.offset = dstOffset;
+            request.callback = callback;
+            frame.requests.emplace_back(std::move(request));
+            return true;
+        }
+
+        bool readTexture(RenderCommandList *commandList, const RenderTextureCopyLocation &srcLocation, RenderFormat format, uint32_t width, uint32_t height, uint32_t depth, const RenderReadbackCallback &callback) {
+            return readTexture(commandList, srcLocation, format, RenderBox(0, 0, int32_t(width), int32_t(height), 0, int32_t(depth)), callback);
+        }
+
+        // Future-based alternative to the callback. The future is invalid if the frame doesn't have enough space left for the readback.
+        std::future<std::vector<uint8_t>> readBuffer(RenderCommandList *commandList, RenderBufferReference srcBuffer, uint64_t size) {
+            std::shared_ptr<std::promise<std::vector<uint8_t>>> promise = std::make_shared<std::promise<std::vector<uint8_t>>>();
+            std::future<std::vector<uint8_t>> future = promise->get_future();
+            auto fulfill = [promise](const RenderReadbackResult &result) {
+                promise->set_value(std::vector<uint8_t>(result.data, result.data + result.size));
+            };
+
+            if (readBuffer(commandList, srcBuffer, size, fulfill)) {
+                return future;
+            }
+            else {
+                return std::future<std::vector<uint8_t>>();
+            }
+        }
+
+        bool allocate(uint64_t size, uint64_t alignment, uint64_t &offset) {
+            assert(!frames.empty() && "Ring must be created before use.");
+
+            Frame &frame = frames[frameIndex];
+            const uint64_t alignedOffset = roundUp(frame.allocatedSize, alignment);
+            if ((alignedOffset + size) > frameCapacity) {
+                return false;
+            }
+
+            offset = alignedOffset;
+            frame.allocatedSize = alignedOffset + size;
+            return true;
+        }
+
+        void completeFrame(Frame &frame) {
+            if (!frame.requests.empty()) {
+                // Map the range again to make the results visible to the host on non-coherent memory.
+                const RenderRange readRange(0, frame.allocatedSize);
+                frame.buffer->map(0, &readRange);
+
+                for (Request &request : frame.requests) {
+                    request.result.data = frame.mappedData + request.offset;
+                    if (request.callback) {
+                        request.callback(request.result);
+                    }
+                }
+
+                frame.buffer->unmap();
+                frame.requests.clear();
+            }
+
+            frame.allocatedSize = 0;
+        }
+
+        static uint64_t roundUp(uint64_t value, uint64_t alignment) {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+    };
+};
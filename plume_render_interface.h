@@ -26,6 +26,9 @@ namespace plume {
         virtual void setName(const std::string &name) = 0;
         virtual uint64_t getDeviceAddress() const = 0;
 
+        // Returns a new handle to the memory of a buffer created with an export handle type or RenderExternalHandleInvalid on failure. The caller owns the handle.
+        virtual RenderExternalHandle exportMemory() = 0;
+
         // Concrete implementation shortcuts.
         inline RenderBufferReference at(uint64_t offset) const {
             return RenderBufferReference(this, offset);
@@ -40,6 +43,9 @@ namespace plume {
         virtual ~RenderTexture() { }
         virtual std::unique_ptr<RenderTextureView> createTextureView(const RenderTextureViewDesc &desc) const = 0;
         virtual void setName(const std::string &name) = 0;
+
+        // Returns a new handle to the memory of a texture created with an export handle type or RenderExternalHandleInvalid on failure. The caller owns the handle.
+        virtual RenderExternalHandle exportMemory() = 0;
     };
 
     struct RenderAccelerationStructure {
@@ -51,6 +57,11 @@ namespace plume {
         virtual void setName(const std::string &name) = 0;
     };
 
+    struct RenderShaderObject {
+        virtual ~RenderShaderObject() { }
+        virtual void setName(const std::string &name) = 0;
+    };
+
     struct RenderSampler {
         virtual ~RenderSampler() { }
     };
@@ -71,6 +82,9 @@ namespace plume {
 
     struct RenderCommandSemaphore {
         virtual ~RenderCommandSemaphore() { }
+
+        // Returns a new handle to a semaphore created with an export handle type or RenderExternalHandleInvalid on failure. The caller owns the handle.
+        virtual RenderExternalHandle exportHandle() = 0;
     };
 
     struct RenderDescriptorSet {
@@ -116,10 +130,21 @@ namespace plume {
         virtual void begin() = 0;
         virtual void end() = 0;
         virtual void barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) = 0;
+
+        // Split barriers start the transitions as soon as the previous work on the resources is done, but only wait for them when the split ends. The work
+        // recorded in between can overlap with the transitions instead of stalling on them. The resources must not be used until the split ends, and the
+        // split must end in the same command list. Queue ownership transfers can't be split.
+        virtual uint32_t beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) = 0;
+        virtual void endSplitBarriers(uint32_t splitIndex) = 0;
         virtual void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) = 0;
         virtual void traceRays(uint32_t width, uint32_t height, uint32_t depth, RenderBufferReference shaderBindingTable, const RenderShaderBindingGroupsInfo &shaderBindingGroupsInfo) = 0;
         virtual void drawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) = 0;
         virtual void drawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) = 0;
+
+        // Each indirect draw reads three 32-bit group counts from the argument buffer, which must be created with the indirect flag.
+        virtual void drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
+        virtual void drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount = 1, uint32_t stride = 12) = 0;
+
         virtual void setPipeline(const RenderPipeline *pipeline) = 0;
         virtual void setComputePipelineLayout(const RenderPipelineLayout *pipelineLayout) = 0;
         virtual void setComputePushConstants(uint32_t rangeIndex, const void *data, uint32_t offset = 0, uint32_t size = 0) = 0;
@@ -137,6 +162,25 @@ namespace plume {
         virtual void setScissors(const RenderRect *scissorRects, uint32_t count) = 0;
         virtual void setFramebuffer(const RenderFramebuffer *framebuffer) = 0;
         virtual void setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) = 0;
+        // The dynamic state setters require the state's bit in the device's dynamicStates capabilities.
+        virtual void setCullMode(RenderCullMode cullMode) = 0;
+        virtual void setFrontFace(RenderFrontFace frontFace) = 0;
+        virtual void setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) = 0;
+        virtual void setDepthEnabled(bool depthEnabled) = 0;
+        virtual void setDepthWriteEnabled(bool depthWriteEnabled) = 0;
+        virtual void setDepthFunction(RenderComparisonFunction depthFunction) = 0;
+        virtual void setStencilEnabled(bool stencilEnabled) = 0;
+        virtual void setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) = 0;
+        virtual void setStencilReference(uint32_t stencilReference) = 0;
+        virtual void setDepthBiasEnabled(bool depthBiasEnabled) = 0;
+        virtual void setDepthClipEnabled(bool depthClipEnabled) = 0;
+        virtual bool setVertexInput(const RenderInputSlot *inputSlots, uint32_t inputSlotsCount, const RenderInputElement *inputElements, uint32_t inputElementsCount) = 0;
+
+        // Binding shader objects replaces the pipeline. Stages without a shader object are disabled. Every state is dynamic and must be set with
+        // setShaderObjectState(), which ignores the shaders of the description. Viewports and scissors must be set after binding the shader objects.
+        virtual void setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) = 0;
+        virtual void setComputeShaderObject(const RenderShaderObject *computeShader) = 0;
+        virtual void setShaderObjectState(const RenderGraphicsPipelineDesc &desc) = 0;
         virtual void clearColor(uint32_t attachmentIndex = 0, RenderColor colorValue = RenderColor(), const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) = 0;
         virtual void clearDepthStencil(bool clearDepth = true, bool clearStencil = true, float depthValue = 1.0f, uint32_t stencilValue = 0, const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) = 0;
         virtual void copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) = 0;
@@ -199,12 +243,16 @@ namespace plume {
 
     struct RenderCommandQueue {
         virtual ~RenderCommandQueue() { }
-        virtual std::unique_ptr<RenderCommandList> createCommandList() = 0;
+        virtual std::unique_ptr<RenderCommandList> createCommandList(const RenderCommandListDesc &desc) = 0;
         virtual std::unique_ptr<RenderSwapChain> createSwapChain(RenderWindow renderWindow, uint32_t textureCount, RenderFormat format, uint32_t maxFrameLatency) = 0;
         virtual void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores = nullptr, uint32_t waitSemaphoreCount = 0, RenderCommandSemaphore **signalSemaphores = nullptr, uint32_t signalSemaphoreCount = 0, RenderCommandFence *signalFence = nullptr) = 0;
         virtual void waitForCommandFence(RenderCommandFence *fence) = 0;
 
         // Concrete implementation shortcuts.
+        inline std::unique_ptr<RenderCommandList> createCommandList() {
+            return createCommandList(RenderCommandListDesc());
+        }
+
         inline void executeCommandLists(const RenderCommandList *commandList, RenderCommandFence *signalFence = nullptr) {
             executeCommandLists(&commandList, 1, nullptr, 0, nullptr, 0, signalFence);
         }
@@ -227,18 +275,33 @@ namespace plume {
         virtual ~RenderDevice() { }
         virtual std::unique_ptr<RenderDescriptorSet> createDescriptorSet(const RenderDescriptorSetDesc &desc) = 0;
         virtual std::unique_ptr<RenderShader> createShader(const void *data, uint64_t size, const char *entryPointName, RenderShaderFormat format) = 0;
+
+        // Linked shader objects can be optimized across stages, but must always be bound together.
+        virtual std::vector<std::unique_ptr<RenderShaderObject>> createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked = false) = 0;
         virtual std::unique_ptr<RenderSampler> createSampler(const RenderSamplerDesc &desc) = 0;
         virtual std::unique_ptr<RenderPipeline> createComputePipeline(const RenderComputePipelineDesc &desc) = 0;
         virtual std::unique_ptr<RenderPipeline> createGraphicsPipeline(const RenderGraphicsPipelineDesc &desc) = 0;
         virtual std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline = nullptr) = 0;
         virtual std::unique_ptr<RenderCommandQueue> createCommandQueue(RenderCommandListType type) = 0;
         virtual std::unique_ptr<RenderBuffer> createBuffer(const RenderBufferDesc &desc) = 0;
+
+        // Wraps existing host memory in a buffer without copying it. The memory must outlive the buffer, and mapping the buffer returns the same pointer.
+        // The buffer behaves like one on the upload heap. Requires the host memory import capability. On D3D12, the pointer must also be the start of an allocation.
+        virtual std::unique_ptr<RenderBuffer> createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) = 0;
         virtual std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) = 0;
+
+        // Creates resources and semaphores from memory or semaphores exported by another device, API or process. The descriptions must match the
+        // ones the objects were exported with. The handle is consumed if the import succeeds. Requires the external memory and
+        // external semaphore capabilities respectively. Shared semaphores must only be signaled on one side and waited on by the other.
+        // Returns null without consuming the handle if it isn't a valid handle for the backend, such as RenderExternalHandleInvalid.
+        virtual std::unique_ptr<RenderBuffer> createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) = 0;
+        virtual std::unique_ptr<RenderTexture> createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) = 0;
+        virtual std::unique_ptr<RenderCommandSemaphore> createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) = 0;
         virtual std::unique_ptr<RenderAccelerationStructure> createAccelerationStructure(const RenderAccelerationStructureDesc &desc) = 0;
         virtual std::unique_ptr<RenderPool> createPool(const RenderPoolDesc &desc) = 0;
         virtual std::unique_ptr<RenderPipelineLayout> createPipelineLayout(const RenderPipelineLayoutDesc &desc) = 0;
         virtual std::unique_ptr<RenderCommandFence> createCommandFence() = 0;
-        virtual std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore() = 0;
+        virtual std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore(RenderExternalHandleType exportHandleType) = 0;
         virtual std::unique_ptr<RenderFramebuffer> createFramebuffer(const RenderFramebufferDesc &desc) = 0;
         virtual std::unique_ptr<RenderQueryPool> createQueryPool(uint32_t queryCount) = 0;
         virtual void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild = true, bool preferFastTrace = false) = 0;
@@ -247,8 +310,18 @@ namespace plume {
         virtual const RenderDeviceCapabilities &getCapabilities() const = 0;
         virtual const RenderDeviceDescription &getDescription() const = 0;
         virtual RenderSampleCounts getSampleCountsSupported(RenderFormat format) const = 0;
+        virtual RenderFormatSupport getFormatSupport(RenderFormat format) const = 0;
         virtual bool beginCapture() = 0;
         virtual bool endCapture() = 0;
+
+        // Concrete implementation shortcuts.
+        inline std::unique_ptr<RenderBuffer> createBufferFromHostMemory(void *hostPointer, uint64_t size) {
+            return createBufferFromHostMemory(hostPointer, size, RenderBufferFlag::NONE);
+        }
+
+        inline std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore() {
+            return createCommandSemaphore(RenderExternalHandleType::NONE);
+        }
     };
 
     struct RenderInterface {
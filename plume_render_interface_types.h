@@ -160,6 +160,58 @@ namespace plume {
         BC7_TYPELESS,
         BC7_UNORM,
         BC7_UNORM_SRGB,
+        ETC2_R8G8B8_UNORM,
+        ETC2_R8G8B8_UNORM_SRGB,
+        ETC2_R8G8B8A1_UNORM,
+        ETC2_R8G8B8A1_UNORM_SRGB,
+        ETC2_R8G8B8A8_UNORM,
+        ETC2_R8G8B8A8_UNORM_SRGB,
+        EAC_R11_UNORM,
+        EAC_R11_SNORM,
+        EAC_R11G11_UNORM,
+        EAC_R11G11_SNORM,
+        ASTC_4X4_UNORM,
+        ASTC_4X4_UNORM_SRGB,
+        ASTC_4X4_FLOAT,
+        ASTC_5X4_UNORM,
+        ASTC_5X4_UNORM_SRGB,
+        ASTC_5X4_FLOAT,
+        ASTC_5X5_UNORM,
+        ASTC_5X5_UNORM_SRGB,
+        ASTC_5X5_FLOAT,
+        ASTC_6X5_UNORM,
+        ASTC_6X5_UNORM_SRGB,
+        ASTC_6X5_FLOAT,
+        ASTC_6X6_UNORM,
+        ASTC_6X6_UNORM_SRGB,
+        ASTC_6X6_FLOAT,
+        ASTC_8X5_UNORM,
+        ASTC_8X5_UNORM_SRGB,
+        ASTC_8X5_FLOAT,
+        ASTC_8X6_UNORM,
+        ASTC_8X6_UNORM_SRGB,
+        ASTC_8X6_FLOAT,
+        ASTC_8X8_UNORM,
+        ASTC_8X8_UNORM_SRGB,
+        ASTC_8X8_FLOAT,
+        ASTC_10X5_UNORM,
+        ASTC_10X5_UNORM_SRGB,
+        ASTC_10X5_FLOAT,
+        ASTC_10X6_UNORM,
+        ASTC_10X6_UNORM_SRGB,
+        ASTC_10X6_FLOAT,
+        ASTC_10X8_UNORM,
+        ASTC_10X8_UNORM_SRGB,
+        ASTC_10X8_FLOAT,
+        ASTC_10X10_UNORM,
+        ASTC_10X10_UNORM_SRGB,
+        ASTC_10X10_FLOAT,
+        ASTC_12X10_UNORM,
+        ASTC_12X10_UNORM_SRGB,
+        ASTC_12X10_FLOAT,
+        ASTC_12X12_UNORM,
+        ASTC_12X12_UNORM_SRGB,
+        ASTC_12X12_FLOAT,
         MAX
     };
 
@@ -363,6 +415,22 @@ namespace plume {
         GPU_UPLOAD
     };
 
+    enum class RenderExternalHandleType {
+        NONE,
+
+        // File descriptor on Vulkan and NT handle on D3D12. Only compatible with the same driver and device.
+        OPAQUE,
+
+        // Linux dma-buf file descriptor. Only supported by buffers on Vulkan.
+        DMA_BUF
+    };
+
+    // Holds either a file descriptor or a handle depending on the backend.
+    typedef uint64_t RenderExternalHandle;
+
+    // Returned by every backend when exporting fails. Importing it fails instead of creating a new object.
+    constexpr RenderExternalHandle RenderExternalHandleInvalid = UINT64_MAX;
+
     enum class RenderTextureArrangement {
         UNKNOWN,
         ROW_MAJOR
@@ -375,6 +443,13 @@ namespace plume {
         METAL
     };
 
+    enum class RenderSpecConstantType {
+        UINT,
+        INT,
+        FLOAT,
+        BOOL
+    };
+
     enum class RenderRaytracingPipelineLibrarySymbolType {
         UNKNOWN,
         RAYGEN,
@@ -403,7 +478,9 @@ namespace plume {
             CLOSEST_HIT = 1U << 6,
             MISS = 1U << 7,
             INTERSECTION = 1U << 8,
-            CALLABLE = 1U << 9
+            CALLABLE = 1U << 9,
+            TASK = 1U << 10,
+            MESH = 1U << 11
         };
     };
 
@@ -422,7 +499,8 @@ namespace plume {
             ACCELERATION_STRUCTURE_SCRATCH = 1U << 7,
             SHADER_BINDING_TABLE = 1U << 8,
             UNORDERED_ACCESS = 1U << 9,
-            DEVICE_ADDRESSABLE = 1U << 10
+            DEVICE_ADDRESSABLE = 1U << 10,
+            INDIRECT = 1U << 11
         };
     };
 
@@ -494,6 +572,45 @@ namespace plume {
 
     typedef uint32_t RenderSampleCounts;
 
+    namespace RenderFormatSupportFlag {
+        enum Bits : uint32_t {
+            NONE = 0U,
+            TEXTURE = 1U << 0,
+            LINEAR_FILTER = 1U << 1,
+            READ_WRITE_TEXTURE = 1U << 2,
+            READ_WRITE_TEXTURE_ATOMIC = 1U << 3,
+            RENDER_TARGET = 1U << 4,
+            BLEND = 1U << 5,
+            DEPTH_TARGET = 1U << 6,
+            VERTEX_BUFFER = 1U << 7,
+            FORMATTED_BUFFER = 1U << 8,
+            READ_WRITE_FORMATTED_BUFFER = 1U << 9
+        };
+    };
+
+    typedef uint32_t RenderFormatSupportFlags;
+
+    namespace RenderDynamicStateFlag {
+        enum Bits : uint32_t {
+            NONE = 0U,
+            CULL_MODE = 1U << 0,
+            FRONT_FACE = 1U << 1,
+            PRIMITIVE_TOPOLOGY = 1U << 2,
+            DEPTH_ENABLED = 1U << 3,
+            DEPTH_WRITE_ENABLED = 1U << 4,
+            DEPTH_FUNCTION = 1U << 5,
+            STENCIL_ENABLED = 1U << 6,
+            STENCIL_FACES = 1U << 7,
+            STENCIL_REFERENCE = 1U << 8,
+            DEPTH_BIAS_ENABLED = 1U << 9,
+            DEPTH_CLIP_ENABLED = 1U << 10,
+            VERTEX_INPUT = 1U << 11,
+            VERTEX_BUFFER_STRIDE = 1U << 12
+        };
+    };
+
+    typedef uint32_t RenderDynamicStateFlags;
+
     enum class RenderDeviceType {
         UNKNOWN,
         INTEGRATED,
@@ -577,6 +694,12 @@ namespace plume {
         case RenderFormat::BC4_UNORM:
         case RenderFormat::BC4_SNORM:
         case RenderFormat::BC4_TYPELESS:
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+        case RenderFormat::EAC_R11_UNORM:
+        case RenderFormat::EAC_R11_SNORM:
             return 8;
         case RenderFormat::BC2_UNORM:
         case RenderFormat::BC2_UNORM_SRGB:
@@ -590,6 +713,52 @@ namespace plume {
         case RenderFormat::BC6H_SF16:
         case RenderFormat::BC7_UNORM:
         case RenderFormat::BC7_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+        case RenderFormat::EAC_R11G11_UNORM:
+        case RenderFormat::EAC_R11G11_SNORM:
+        case RenderFormat::ASTC_4X4_UNORM:
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+        case RenderFormat::ASTC_4X4_FLOAT:
+        case RenderFormat::ASTC_5X4_UNORM:
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X4_FLOAT:
+        case RenderFormat::ASTC_5X5_UNORM:
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+        case RenderFormat::ASTC_5X5_FLOAT:
+        case RenderFormat::ASTC_6X5_UNORM:
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X5_FLOAT:
+        case RenderFormat::ASTC_6X6_UNORM:
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+        case RenderFormat::ASTC_6X6_FLOAT:
+        case RenderFormat::ASTC_8X5_UNORM:
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+        case RenderFormat::ASTC_8X5_FLOAT:
+        case RenderFormat::ASTC_8X6_UNORM:
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X6_FLOAT:
+        case RenderFormat::ASTC_8X8_UNORM:
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+        case RenderFormat::ASTC_8X8_FLOAT:
+        case RenderFormat::ASTC_10X5_UNORM:
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+        case RenderFormat::ASTC_10X5_FLOAT:
+        case RenderFormat::ASTC_10X6_UNORM:
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+        case RenderFormat::ASTC_10X6_FLOAT:
+        case RenderFormat::ASTC_10X8_UNORM:
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X8_FLOAT:
+        case RenderFormat::ASTC_10X10_UNORM:
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+        case RenderFormat::ASTC_10X10_FLOAT:
+        case RenderFormat::ASTC_12X10_UNORM:
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X10_FLOAT:
+        case RenderFormat::ASTC_12X12_UNORM:
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+        case RenderFormat::ASTC_12X12_FLOAT:
             return 16;
         default:
             assert(false && "Unknown format.");
@@ -674,7 +843,205 @@ namespace plume {
         case RenderFormat::BC7_TYPELESS:
         case RenderFormat::BC7_UNORM:
         case RenderFormat::BC7_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+        case RenderFormat::EAC_R11_UNORM:
+        case RenderFormat::EAC_R11_SNORM:
+        case RenderFormat::EAC_R11G11_UNORM:
+        case RenderFormat::EAC_R11G11_SNORM:
+        case RenderFormat::ASTC_4X4_UNORM:
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+        case RenderFormat::ASTC_4X4_FLOAT:
             return 4;
+        case RenderFormat::ASTC_5X4_UNORM:
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X4_FLOAT:
+        case RenderFormat::ASTC_5X5_UNORM:
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+        case RenderFormat::ASTC_5X5_FLOAT:
+            return 5;
+        case RenderFormat::ASTC_6X5_UNORM:
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X5_FLOAT:
+        case RenderFormat::ASTC_6X6_UNORM:
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+        case RenderFormat::ASTC_6X6_FLOAT:
+            return 6;
+        case RenderFormat::ASTC_8X5_UNORM:
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+        case RenderFormat::ASTC_8X5_FLOAT:
+        case RenderFormat::ASTC_8X6_UNORM:
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X6_FLOAT:
+        case RenderFormat::ASTC_8X8_UNORM:
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+        case RenderFormat::ASTC_8X8_FLOAT:
+            return 8;
+        case RenderFormat::ASTC_10X5_UNORM:
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+        case RenderFormat::ASTC_10X5_FLOAT:
+        case RenderFormat::ASTC_10X6_UNORM:
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+        case RenderFormat::ASTC_10X6_FLOAT:
+        case RenderFormat::ASTC_10X8_UNORM:
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X8_FLOAT:
+        case RenderFormat::ASTC_10X10_UNORM:
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+        case RenderFormat::ASTC_10X10_FLOAT:
+            return 10;
+        case RenderFormat::ASTC_12X10_UNORM:
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X10_FLOAT:
+        case RenderFormat::ASTC_12X12_UNORM:
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+        case RenderFormat::ASTC_12X12_FLOAT:
+            return 12;
+        default:
+            assert(false && "Unknown format.");
+            return 1;
+        }
+    };
+
+    constexpr uint32_t RenderFormatBlockHeight(RenderFormat format) {
+        switch (format) {
+        case RenderFormat::R32G32B32A32_TYPELESS:
+        case RenderFormat::R32G32B32A32_FLOAT:
+        case RenderFormat::R32G32B32A32_UINT:
+        case RenderFormat::R32G32B32A32_SINT:
+        case RenderFormat::R32G32B32_TYPELESS:
+        case RenderFormat::R32G32B32_FLOAT:
+        case RenderFormat::R32G32B32_UINT:
+        case RenderFormat::R32G32B32_SINT:
+        case RenderFormat::R16G16B16A16_TYPELESS:
+        case RenderFormat::R16G16B16A16_FLOAT:
+        case RenderFormat::R16G16B16A16_UNORM:
+        case RenderFormat::R16G16B16A16_UINT:
+        case RenderFormat::R16G16B16A16_SNORM:
+        case RenderFormat::R16G16B16A16_SINT:
+        case RenderFormat::R32G32_TYPELESS:
+        case RenderFormat::R32G32_FLOAT:
+        case RenderFormat::R32G32_UINT:
+        case RenderFormat::R32G32_SINT:
+        case RenderFormat::R8G8B8A8_TYPELESS:
+        case RenderFormat::R8G8B8A8_UNORM:
+        case RenderFormat::R8G8B8A8_UINT:
+        case RenderFormat::R8G8B8A8_SNORM:
+        case RenderFormat::R8G8B8A8_SINT:
+        case RenderFormat::B8G8R8A8_UNORM:
+        case RenderFormat::R16G16_TYPELESS:
+        case RenderFormat::R16G16_FLOAT:
+        case RenderFormat::R16G16_UNORM:
+        case RenderFormat::R16G16_UINT:
+        case RenderFormat::R16G16_SNORM:
+        case RenderFormat::R16G16_SINT:
+        case RenderFormat::R32_TYPELESS:
+        case RenderFormat::D32_FLOAT:
+        case RenderFormat::D32_FLOAT_S8_UINT:
+        case RenderFormat::R32_FLOAT:
+        case RenderFormat::R32_UINT:
+        case RenderFormat::R32_SINT:
+        case RenderFormat::R8G8_TYPELESS:
+        case RenderFormat::R8G8_UNORM:
+        case RenderFormat::R8G8_UINT:
+        case RenderFormat::R8G8_SNORM:
+        case RenderFormat::R8G8_SINT:
+        case RenderFormat::R16_TYPELESS:
+        case RenderFormat::R16_FLOAT:
+        case RenderFormat::D16_UNORM:
+        case RenderFormat::R16_UNORM:
+        case RenderFormat::R16_UINT:
+        case RenderFormat::R16_SNORM:
+        case RenderFormat::R16_SINT:
+        case RenderFormat::R8_TYPELESS:
+        case RenderFormat::R8_UNORM:
+        case RenderFormat::R8_UINT:
+        case RenderFormat::R8_SNORM:
+        case RenderFormat::R8_SINT:
+            return 1;
+        case RenderFormat::BC1_TYPELESS:
+        case RenderFormat::BC1_UNORM:
+        case RenderFormat::BC1_UNORM_SRGB:
+        case RenderFormat::BC2_TYPELESS:
+        case RenderFormat::BC2_UNORM:
+        case RenderFormat::BC2_UNORM_SRGB:
+        case RenderFormat::BC3_TYPELESS:
+        case RenderFormat::BC3_UNORM:
+        case RenderFormat::BC3_UNORM_SRGB:
+        case RenderFormat::BC4_TYPELESS:
+        case RenderFormat::BC4_UNORM:
+        case RenderFormat::BC4_SNORM:
+        case RenderFormat::BC5_TYPELESS:
+        case RenderFormat::BC5_UNORM:
+        case RenderFormat::BC5_SNORM:
+        case RenderFormat::BC6H_TYPELESS:
+        case RenderFormat::BC6H_UF16:
+        case RenderFormat::BC6H_SF16:
+        case RenderFormat::BC7_TYPELESS:
+        case RenderFormat::BC7_UNORM:
+        case RenderFormat::BC7_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+        case RenderFormat::EAC_R11_UNORM:
+        case RenderFormat::EAC_R11_SNORM:
+        case RenderFormat::EAC_R11G11_UNORM:
+        case RenderFormat::EAC_R11G11_SNORM:
+        case RenderFormat::ASTC_4X4_UNORM:
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+        case RenderFormat::ASTC_4X4_FLOAT:
+        case RenderFormat::ASTC_5X4_UNORM:
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+        case RenderFormat::ASTC_5X4_FLOAT:
+            return 4;
+        case RenderFormat::ASTC_5X5_UNORM:
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+        case RenderFormat::ASTC_5X5_FLOAT:
+        case RenderFormat::ASTC_6X5_UNORM:
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+        case RenderFormat::ASTC_6X5_FLOAT:
+        case RenderFormat::ASTC_8X5_UNORM:
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+        case RenderFormat::ASTC_8X5_FLOAT:
+        case RenderFormat::ASTC_10X5_UNORM:
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+        case RenderFormat::ASTC_10X5_FLOAT:
+            return 5;
+        case RenderFormat::ASTC_6X6_UNORM:
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+        case RenderFormat::ASTC_6X6_FLOAT:
+        case RenderFormat::ASTC_8X6_UNORM:
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+        case RenderFormat::ASTC_8X6_FLOAT:
+        case RenderFormat::ASTC_10X6_UNORM:
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+        case RenderFormat::ASTC_10X6_FLOAT:
+            return 6;
+        case RenderFormat::ASTC_8X8_UNORM:
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+        case RenderFormat::ASTC_8X8_FLOAT:
+        case RenderFormat::ASTC_10X8_UNORM:
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+        case RenderFormat::ASTC_10X8_FLOAT:
+            return 8;
+        case RenderFormat::ASTC_10X10_UNORM:
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+        case RenderFormat::ASTC_10X10_FLOAT:
+        case RenderFormat::ASTC_12X10_UNORM:
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+        case RenderFormat::ASTC_12X10_FLOAT:
+            return 10;
+        case RenderFormat::ASTC_12X12_UNORM:
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+        case RenderFormat::ASTC_12X12_FLOAT:
+            return 12;
         default:
             assert(false && "Unknown format.");
             return 1;
@@ -778,8 +1145,10 @@ namespace plume {
     };
 
     struct RenderMultisampling {
+        static const uint32_t MaxSampleLocations = 16;
+
         RenderSampleCounts sampleCount = RenderSampleCount::COUNT_1;
-        RenderMultisamplingLocation sampleLocations[16] = {};
+        RenderMultisamplingLocation sampleLocations[MaxSampleLocations] = {};
         bool sampleLocationsEnabled = false;
 
         RenderMultisampling() = default;
@@ -814,15 +1183,23 @@ namespace plume {
         }
     };
 
+    // Barriers with different source and destination queue types transfer the ownership of the resource between the queues on Vulkan when their families
+    // differ. The same barrier must be recorded twice: once on a command list of the source queue to release it, and once on a command list of the destination
+    // queue to acquire it. The acquiring submission must wait on a semaphore signaled by the releasing one. Both barriers still update the stages and
+    // layout tracked for the resource, so they must not be recorded at the same time from different threads.
     struct RenderBufferBarrier {
         RenderBuffer *buffer = nullptr;
         RenderBufferAccessBits accessBits = RenderBufferAccess::NONE;
+        RenderCommandListType srcQueueType = RenderCommandListType::UNKNOWN;
+        RenderCommandListType dstQueueType = RenderCommandListType::UNKNOWN;
 
         RenderBufferBarrier() = default;
 
-        RenderBufferBarrier(RenderBuffer *buffer, RenderBufferAccessBits accessBits) {
+        RenderBufferBarrier(RenderBuffer *buffer, RenderBufferAccessBits accessBits, RenderCommandListType srcQueueType = RenderCommandListType::UNKNOWN, RenderCommandListType dstQueueType = RenderCommandListType::UNKNOWN) {
             this->buffer = buffer;
             this->accessBits = accessBits;
+            this->srcQueueType = srcQueueType;
+            this->dstQueueType = dstQueueType;
         }
     };
 
@@ -841,12 +1218,21 @@ namespace plume {
     struct RenderTextureBarrier {
         RenderTexture *texture = nullptr;
         RenderTextureLayout layout = RenderTextureLayout::UNKNOWN;
+        RenderCommandListType srcQueueType = RenderCommandListType::UNKNOWN;
+        RenderCommandListType dstQueueType = RenderCommandListType::UNKNOWN;
+
+        // Layout of the texture before an ownership transfer. The release and the acquire must specify the same transition, so the layout is given by
+        // the barrier instead of being carried over from the release. Ignored when the barrier doesn't transfer ownership.
+        RenderTextureLayout srcLayout = RenderTextureLayout::UNKNOWN;
 
         RenderTextureBarrier() = default;
 
-        RenderTextureBarrier(RenderTexture *texture, RenderTextureLayout layout) {
+        RenderTextureBarrier(RenderTexture *texture, RenderTextureLayout layout, RenderCommandListType srcQueueType = RenderCommandListType::UNKNOWN, RenderCommandListType dstQueueType = RenderCommandListType::UNKNOWN, RenderTextureLayout srcLayout = RenderTextureLayout::UNKNOWN) {
             this->texture = texture;
             this->layout = layout;
+            this->srcQueueType = srcQueueType;
+            this->dstQueueType = dstQueueType;
+            this->srcLayout = srcLayout;
         }
     };
 
@@ -879,6 +1265,7 @@ namespace plume {
         RenderHeapType heapType = RenderHeapType::UNKNOWN;
         RenderBufferFlags flags = RenderBufferFlag::NONE;
         bool committed = false;
+        RenderExternalHandleType exportHandleType = RenderExternalHandleType::NONE;
 
         RenderBufferDesc() = default;
 
@@ -944,6 +1331,7 @@ namespace plume {
         const RenderClearValue *optimizedClearValue = nullptr;
         RenderTextureFlags flags = RenderTextureFlag::NONE;
         bool committed = false;
+        RenderExternalHandleType exportHandleType = RenderExternalHandleType::NONE;
 
         RenderTextureDesc() = default;
 
@@ -1213,17 +1601,31 @@ namespace plume {
         RenderStencilOp failOp = RenderStencilOp::KEEP;
         RenderStencilOp depthFailOp = RenderStencilOp::KEEP;
         RenderComparisonFunction compareFunction = RenderComparisonFunction::ALWAYS;
+
+        bool operator==(const RenderStencilFaceDesc &f) const {
+            return (passOp == f.passOp) && (failOp == f.failOp) && (depthFailOp == f.depthFailOp) && (compareFunction == f.compareFunction);
+        }
+
+        bool operator!=(const RenderStencilFaceDesc &f) const {
+            return !(*this == f);
+        }
     };
 
     struct RenderSpecConstant {
         uint32_t index = 0;
+
+        // The 32-bit representation of the value. Booleans are zero or one and floats are stored with their bit pattern.
         uint32_t value = 0;
 
+        // Only used by backends that must know the type the shader declares the constant with.
+        RenderSpecConstantType type = RenderSpecConstantType::UINT;
+
         RenderSpecConstant() = default;
 
-        RenderSpecConstant(uint32_t index, uint32_t value) {
+        RenderSpecConstant(uint32_t index, uint32_t value, RenderSpecConstantType type = RenderSpecConstantType::UINT) {
             this->index = index;
             this->value = value;
+            this->type = type;
         }
     };
 
@@ -1254,12 +1656,23 @@ namespace plume {
         const RenderShader *vertexShader = nullptr;
         const RenderShader *geometryShader = nullptr;
         const RenderShader *pixelShader = nullptr;
+
+        // Mesh pipelines replace the vertex and geometry shaders. The task shader is optional.
+        // The input slots, input elements and primitive topology are ignored when a mesh shader is used.
+        const RenderShader *taskShader = nullptr;
+        const RenderShader *meshShader = nullptr;
+
         RenderComparisonFunction depthFunction = RenderComparisonFunction::NEVER;
         bool depthClipEnabled = false;
         int32_t depthBias = 0;
         float depthBiasClamp = 0.0f;
         float slopeScaledDepthBias = 0.0f;
         bool dynamicDepthBiasEnabled = false;
+
+        // The states specified here are ignored and must be set on the command list after binding the pipeline instead.
+        // The primitive topology set dynamically must belong to the same class (points, lines or triangles) as the one specified here.
+        // The input slots and elements are ignored when the vertex input is dynamic. Dynamic vertex buffer strides are taken from the input slots passed to setVertexBuffers().
+        RenderDynamicStateFlags dynamicStates = RenderDynamicStateFlag::NONE;
         bool depthEnabled = false;
         bool depthWriteEnabled = false;
         bool stencilEnabled = false;
@@ -1285,6 +1698,31 @@ namespace plume {
         uint32_t inputElementsCount = 0;
         const RenderSpecConstant *specConstants = nullptr;
         uint32_t specConstantsCount = 0;
+
+        // Must match the view mask of the framebuffers the pipeline is used with. Zero disables multiview.
+        uint32_t viewMask = 0;
+    };
+
+    struct RenderShaderObjectDesc {
+        RenderShaderStageFlag::Bits stage = RenderShaderStageFlag::NONE;
+        const void *data = nullptr;
+        uint64_t size = 0;
+        const char *entryPointName = nullptr;
+        RenderShaderFormat format = RenderShaderFormat::UNKNOWN;
+        const RenderPipelineLayout *pipelineLayout = nullptr;
+        const RenderSpecConstant *specConstants = nullptr;
+        uint32_t specConstantsCount = 0;
+
+        RenderShaderObjectDesc() = default;
+
+        RenderShaderObjectDesc(RenderShaderStageFlag::Bits stage, const void *data, uint64_t size, const char *entryPointName, RenderShaderFormat format, const RenderPipelineLayout *pipelineLayout) {
+            this->stage = stage;
+            this->data = data;
+            this->size = size;
+            this->entryPointName = entryPointName;
+            this->format = format;
+            this->pipelineLayout = pipelineLayout;
+        }
     };
 
     struct RenderRaytracingPipelineLibrarySymbol {
@@ -1594,6 +2032,24 @@ namespace plume {
         }
     };
 
+    struct RenderCommandListDesc {
+        // Keeps the recorded commands after they're executed so the command list can be submitted again without being recorded.
+        // Calling begin() records it from scratch and is only valid once no submission of the list is in flight. Any parameters
+        // that change between submissions must be read from buffers, as descriptor sets and push constants are baked when recorded.
+        // Requires the reusable command lists capability.
+        bool reusable = false;
+
+        // Allows a reusable command list to be submitted again while a previous submission of it is still in flight.
+        bool simultaneousUse = false;
+
+        RenderCommandListDesc() = default;
+
+        RenderCommandListDesc(bool reusable, bool simultaneousUse = false) {
+            this->reusable = reusable;
+            this->simultaneousUse = simultaneousUse;
+        }
+    };
+
     struct RenderFramebufferDesc {
         const RenderTexture **colorAttachments = nullptr;
         const RenderTextureView **colorAttachmentViews = nullptr;
@@ -1602,6 +2058,15 @@ namespace plume {
         const RenderTextureView *depthAttachmentView = nullptr;
         bool depthAttachmentReadOnly = false;
 
+        // Broadcasts every draw to the array layers of the attachments whose bits are set. The attachments must have enough layers for the highest bit.
+        // Vulkan numbers the views by their bit while D3D12 and Metal number them by their position among the set bits, so portable masks must start at the first bit and be contiguous.
+        // Zero disables multiview.
+        uint32_t viewMask = 0;
+
+        // Amount of layers the shaders can select with the render target array index. The attachments must have at least this many array slices,
+        // or depth slices for 3D textures. Must be 1 when multiview is used.
+        uint32_t layerCount = 1;
+
         RenderFramebufferDesc() = default;
 
         RenderFramebufferDesc(const RenderTexture **colorAttachments, uint32_t colorAttachmentsCount, const RenderTexture *depthAttachment = nullptr, bool depthAttachmentReadOnly = false) {
@@ -1741,10 +2206,20 @@ namespace plume {
         uint64_t dedicatedVideoMemory = 0;
     };
 
+    struct RenderFormatSupport {
+        RenderFormatSupportFlags flags = RenderFormatSupportFlag::NONE;
+
+        // Sample counts supported when the format is used as a render or depth target.
+        RenderSampleCounts sampleCounts = RenderSampleCount::COUNT_0;
+    };
+
     struct RenderDeviceCapabilities {
         // Geometry shaders.
         bool geometryShader = false;
 
+        // Mesh shaders.
+        bool meshShader = false;
+
         // Raytracing.
         bool raytracing = false;
         bool raytracingStateUpdate = false;
@@ -1778,6 +2253,27 @@ namespace plume {
         // Draw.
         bool triangleFan = false;
         bool dynamicDepthBias = false;
+        RenderDynamicStateFlags dynamicStates = RenderDynamicStateFlag::NONE;
+
+        // Shader objects.
+        bool shaderObjects = false;
+
+        // Specialization constants.
+        bool specConstants = false;
+
+        // Texture compression. The ASTC formats with float components require HDR support.
+        bool textureCompressionBC = false;
+        bool textureCompressionETC2 = false;
+        bool textureCompressionASTC = false;
+        bool textureCompressionASTCHDR = false;
+
+        // Multiview.
+        bool multiview = false;
+        uint32_t maxMultiviewViewCount = 0;
+
+        // Layered rendering. The render target array index can be written from the vertex stage without a geometry shader.
+        bool layerOutputFromVertex = false;
+        uint32_t maxFramebufferLayers = 0;
 
         // UMA.
         bool uma = false;
@@ -1787,6 +2283,18 @@ namespace plume {
 
         // Query Pools.
         bool queryPools = false;
+
+        // Command lists.
+        bool reusableCommandLists = false;
+
+        // Host memory import. Imported pointers and sizes must be multiples of the alignment.
+        bool hostMemoryImport = false;
+        uint64_t hostMemoryImportAlignment = 0;
+
+        // External memory and semaphores.
+        bool externalMemory = false;
+        bool externalMemoryDmaBuf = false;
+        bool externalSemaphore = false;
     };
 
     struct RenderInterfaceCapabilities {
@@ -9,6 +9,7 @@
 #define VOLK_IMPLEMENTATION 
 
 #include "plume_vulkan.h"
+#include "plume_allocator.h"
 
 #include <algorithm>
 #include <cmath>
@@ -85,6 +86,20 @@ namespace plume {
         VK_KHR_PRESENT_ID_EXTENSION_NAME,
         VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
         VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+        VK_EXT_VERTEX_INPUT_DYNAMIC_STATE_EXTENSION_NAME,
+        VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+        VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+        VK_EXT_SHADER_OBJECT_EXTENSION_NAME,
+        VK_EXT_MESH_SHADER_EXTENSION_NAME,
+        VK_EXT_SHADER_VIEWPORT_INDEX_LAYER_EXTENSION_NAME,
+        VK_EXT_TEXTURE_COMPRESSION_ASTC_HDR_EXTENSION_NAME,
+        VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+        VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
+        VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME,
+        VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
         // Vulkan spec requires this to be enabled if supported by the driver.
         VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME,
     };
@@ -247,6 +262,110 @@ namespace plume {
             return VK_FORMAT_BC7_UNORM_BLOCK;
         case RenderFormat::BC7_UNORM_SRGB:
             return VK_FORMAT_BC7_SRGB_BLOCK;
+        case RenderFormat::ETC2_R8G8B8_UNORM:
+            return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+        case RenderFormat::ETC2_R8G8B8_UNORM_SRGB:
+            return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+        case RenderFormat::ETC2_R8G8B8A1_UNORM:
+            return VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK;
+        case RenderFormat::ETC2_R8G8B8A1_UNORM_SRGB:
+            return VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK;
+        case RenderFormat::ETC2_R8G8B8A8_UNORM:
+            return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+        case RenderFormat::ETC2_R8G8B8A8_UNORM_SRGB:
+            return VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
+        case RenderFormat::EAC_R11_UNORM:
+            return VK_FORMAT_EAC_R11_UNORM_BLOCK;
+        case RenderFormat::EAC_R11_SNORM:
+            return VK_FORMAT_EAC_R11_SNORM_BLOCK;
+        case RenderFormat::EAC_R11G11_UNORM:
+            return VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
+        case RenderFormat::EAC_R11G11_SNORM:
+            return VK_FORMAT_EAC_R11G11_SNORM_BLOCK;
+        case RenderFormat::ASTC_4X4_UNORM:
+            return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+        case RenderFormat::ASTC_4X4_UNORM_SRGB:
+            return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
+        case RenderFormat::ASTC_4X4_FLOAT:
+            return VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_5X4_UNORM:
+            return VK_FORMAT_ASTC_5x4_UNORM_BLOCK;
+        case RenderFormat::ASTC_5X4_UNORM_SRGB:
+            return VK_FORMAT_ASTC_5x4_SRGB_BLOCK;
+        case RenderFormat::ASTC_5X4_FLOAT:
+            return VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_5X5_UNORM:
+            return VK_FORMAT_ASTC_5x5_UNORM_BLOCK;
+        case RenderFormat::ASTC_5X5_UNORM_SRGB:
+            return VK_FORMAT_ASTC_5x5_SRGB_BLOCK;
+        case RenderFormat::ASTC_5X5_FLOAT:
+            return VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_6X5_UNORM:
+            return VK_FORMAT_ASTC_6x5_UNORM_BLOCK;
+        case RenderFormat::ASTC_6X5_UNORM_SRGB:
+            return VK_FORMAT_ASTC_6x5_SRGB_BLOCK;
+        case RenderFormat::ASTC_6X5_FLOAT:
+            return VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_6X6_UNORM:
+            return VK_FORMAT_ASTC_6x6_UNORM_BLOCK;
+        case RenderFormat::ASTC_6X6_UNORM_SRGB:
+            return VK_FORMAT_ASTC_6x6_SRGB_BLOCK;
+        case RenderFormat::ASTC_6X6_FLOAT:
+            return VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_8X5_UNORM:
+            return VK_FORMAT_ASTC_8x5_UNORM_BLOCK;
+        case RenderFormat::ASTC_8X5_UNORM_SRGB:
+            return VK_FORMAT_ASTC_8x5_SRGB_BLOCK;
+        case RenderFormat::ASTC_8X5_FLOAT:
+            return VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_8X6_UNORM:
+            return VK_FORMAT_ASTC_8x6_UNORM_BLOCK;
+        case RenderFormat::ASTC_8X6_UNORM_SRGB:
+            return VK_FORMAT_ASTC_8x6_SRGB_BLOCK;
+        case RenderFormat::ASTC_8X6_FLOAT:
+            return VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_8X8_UNORM:
+            return VK_FORMAT_ASTC_8x8_UNORM_BLOCK;
+        case RenderFormat::ASTC_8X8_UNORM_SRGB:
+            return VK_FORMAT_ASTC_8x8_SRGB_BLOCK;
+        case RenderFormat::ASTC_8X8_FLOAT:
+            return VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_10X5_UNORM:
+            return VK_FORMAT_ASTC_10x5_UNORM_BLOCK;
+        case RenderFormat::ASTC_10X5_UNORM_SRGB:
+            return VK_FORMAT_ASTC_10x5_SRGB_BLOCK;
+        case RenderFormat::ASTC_10X5_FLOAT:
+            return VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_10X6_UNORM:
+            return VK_FORMAT_ASTC_10x6_UNORM_BLOCK;
+        case RenderFormat::ASTC_10X6_UNORM_SRGB:
+            return VK_FORMAT_ASTC_10x6_SRGB_BLOCK;
+        case RenderFormat::ASTC_10X6_FLOAT:
+            return VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_10X8_UNORM:
+            return VK_FORMAT_ASTC_10x8_UNORM_BLOCK;
+        case RenderFormat::ASTC_10X8_UNORM_SRGB:
+            return VK_FORMAT_ASTC_10x8_SRGB_BLOCK;
+        case RenderFormat::ASTC_10X8_FLOAT:
+            return VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_10X10_UNORM:
+            return VK_FORMAT_ASTC_10x10_UNORM_BLOCK;
+        case RenderFormat::ASTC_10X10_UNORM_SRGB:
+            return VK_FORMAT_ASTC_10x10_SRGB_BLOCK;
+        case RenderFormat::ASTC_10X10_FLOAT:
+            return VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_12X10_UNORM:
+            return VK_FORMAT_ASTC_12x10_UNORM_BLOCK;
+        case RenderFormat::ASTC_12X10_UNORM_SRGB:
+            return VK_FORMAT_ASTC_12x10_SRGB_BLOCK;
+        case RenderFormat::ASTC_12X10_FLOAT:
+            return VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK_EXT;
+        case RenderFormat::ASTC_12X12_UNORM:
+            return VK_FORMAT_ASTC_12x12_UNORM_BLOCK;
+        case RenderFormat::ASTC_12X12_UNORM_SRGB:
+            return VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+        case RenderFormat::ASTC_12X12_FLOAT:
+            return VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK_EXT;
         default:
             assert(false && "Unknown format.");
             return VK_FORMAT_UNDEFINED;
@@ -600,7 +719,7 @@ namespace plume {
         }
     }
     
-    static VkPipelineStageFlags toStageFlags(RenderBarrierStages stages, bool geometrySupported, bool rtSupported) {
+    static VkPipelineStageFlags toStageFlags(RenderBarrierStages stages, bool geometrySupported, bool meshSupported, bool rtSupported) {
         VkPipelineStageFlags flags = 0;
 
         if (stages & RenderBarrierStage::GRAPHICS) {
@@ -615,6 +734,11 @@ namespace plume {
             if (geometrySupported) {
                 flags |= VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
             }
+
+            if (meshSupported) {
+                flags |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT;
+                flags |= VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT;
+            }
         }
 
         if (stages & RenderBarrierStage::COMPUTE) {
@@ -668,6 +792,23 @@ namespace plume {
         }
     }
 
+    // Stays ignored unless both queue types are known and belong to different families, as no ownership transfer is needed otherwise.
+    static void toQueueFamilyTransfer(const VulkanDevice *device, RenderCommandListType srcQueueType, RenderCommandListType dstQueueType, uint32_t &srcFamilyIndex, uint32_t &dstFamilyIndex) {
+        srcFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        dstFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        if ((srcQueueType == RenderCommandListType::UNKNOWN) || (dstQueueType == RenderCommandListType::UNKNOWN)) {
+            return;
+        }
+
+        const uint32_t srcIndex = device->queueFamilyIndices[toFamilyIndex(srcQueueType)];
+        const uint32_t dstIndex = device->queueFamilyIndices[toFamilyIndex(dstQueueType)];
+        if (srcIndex != dstIndex) {
+            srcFamilyIndex = srcIndex;
+            dstFamilyIndex = dstIndex;
+        }
+    }
+
     static VkIndexType toIndexType(RenderFormat format) {
         switch (format) {
         case RenderFormat::R8_UINT:
@@ -719,6 +860,18 @@ namespace plume {
         }
     }
 
+    static bool isReadOnlyLayout(RenderTextureLayout layout) {
+        switch (layout) {
+        case RenderTextureLayout::SHADER_READ:
+        case RenderTextureLayout::DEPTH_READ:
+        case RenderTextureLayout::COPY_SOURCE:
+        case RenderTextureLayout::RESOLVE_SOURCE:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     static VkImageAspectFlags toViewAspectFlags(const RenderTextureFlags flags) {
         return (flags & RenderTextureFlag::DEPTH_TARGET) != 0 ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
     }
@@ -731,6 +884,45 @@ namespace plume {
         return aspect;
     }
 
+    static RenderFormatSupport toFormatSupport(VkPhysicalDevice physicalDevice, RenderFormat format) {
+        const VkFormat vkFormat = toVk(format);
+        if ((format == RenderFormat::UNKNOWN) || (vkFormat == VK_FORMAT_UNDEFINED)) {
+            return RenderFormatSupport();
+        }
+
+        VkFormatProperties2 formatProperties = {};
+        formatProperties.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2;
+        vkGetPhysicalDeviceFormatProperties2(physicalDevice, vkFormat, &formatProperties);
+
+        const VkFormatFeatureFlags imageFeatures = formatProperties.formatProperties.optimalTilingFeatures;
+        const VkFormatFeatureFlags bufferFeatures = formatProperties.formatProperties.bufferFeatures;
+        RenderFormatSupport support;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) ? RenderFormatSupportFlag::TEXTURE : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? RenderFormatSupportFlag::LINEAR_FILTER : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) ? RenderFormatSupportFlag::READ_WRITE_TEXTURE : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_ATOMIC_BIT) ? RenderFormatSupportFlag::READ_WRITE_TEXTURE_ATOMIC : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT) ? RenderFormatSupportFlag::RENDER_TARGET : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT) ? RenderFormatSupportFlag::BLEND : RenderFormatSupportFlag::NONE;
+        support.flags |= (imageFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) ? RenderFormatSupportFlag::DEPTH_TARGET : RenderFormatSupportFlag::NONE;
+        support.flags |= (bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) ? RenderFormatSupportFlag::VERTEX_BUFFER : RenderFormatSupportFlag::NONE;
+        support.flags |= (bufferFeatures & VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT) ? RenderFormatSupportFlag::FORMATTED_BUFFER : RenderFormatSupportFlag::NONE;
+        support.flags |= (bufferFeatures & VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT) ? RenderFormatSupportFlag::READ_WRITE_FORMATTED_BUFFER : RenderFormatSupportFlag::NONE;
+
+        // Sample counts are only reported for formats that can be used as targets.
+        VkImageUsageFlags targetUsage = 0;
+        targetUsage |= (support.flags & RenderFormatSupportFlag::RENDER_TARGET) ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT : 0;
+        targetUsage |= (support.flags & RenderFormatSupportFlag::DEPTH_TARGET) ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : 0;
+        if (targetUsage != 0) {
+            VkImageFormatProperties imageFormatProperties = {};
+            VkResult res = vkGetPhysicalDeviceImageFormatProperties(physicalDevice, vkFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, targetUsage, 0, &imageFormatProperties);
+            if (res == VK_SUCCESS) {
+                support.sampleCounts = RenderSampleCounts(imageFormatProperties.sampleCounts);
+            }
+        }
+
+        return support;
+    }
+
     static VkComponentSwizzle toVk(RenderSwizzle swizzle) {
         switch (swizzle) {
         case RenderSwizzle::IDENTITY:
@@ -783,6 +975,43 @@ namespace plume {
 #   endif
     }
 
+    static VkShaderStageFlagBits toShaderStage(RenderShaderStageFlag::Bits stage) {
+        switch (stage) {
+        case RenderShaderStageFlag::VERTEX:
+            return VK_SHADER_STAGE_VERTEX_BIT;
+        case RenderShaderStageFlag::GEOMETRY:
+            return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case RenderShaderStageFlag::PIXEL:
+            return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case RenderShaderStageFlag::COMPUTE:
+            return VK_SHADER_STAGE_COMPUTE_BIT;
+        default:
+            assert(false && "Unsupported shader object stage.");
+            return VkShaderStageFlagBits(0);
+        }
+    }
+
+    // The locations must hold as many elements as RenderMultisampling::MaxSampleLocations.
+    static void fillSampleLocations(const VulkanDevice *device, const RenderMultisampling &multisampling, VkSampleLocationEXT *sampleLocations, VkSampleLocationsInfoEXT &sampleLocationsInfo) {
+        assert((multisampling.sampleCount <= RenderMultisampling::MaxSampleLocations) && "Sample count exceeds the maximum amount of sample locations.");
+
+        const float *coordinateRange = device->sampleLocationProperties.sampleLocationCoordinateRange;
+        const float coordinateBase = coordinateRange[0];
+        const float coordinateSpace = (coordinateRange[1] - coordinateRange[0]) / 15.0f;
+        for (uint32_t i = 0; i < multisampling.sampleCount; i++) {
+            const RenderMultisamplingLocation &location = multisampling.sampleLocations[i];
+            sampleLocations[i].x = coordinateBase + (location.x + 8) * coordinateSpace;
+            sampleLocations[i].y = coordinateBase + (location.y + 8) * coordinateSpace;
+        }
+
+        sampleLocationsInfo.sType = VK_STRUCTURE_TYPE_SAMPLE_LOCATIONS_INFO_EXT;
+        sampleLocationsInfo.sampleLocationsPerPixel = VkSampleCountFlagBits(multisampling.sampleCount);
+        sampleLocationsInfo.sampleLocationGridSize.width = 1;
+        sampleLocationsInfo.sampleLocationGridSize.height = 1;
+        sampleLocationsInfo.sampleLocationsCount = multisampling.sampleCount;
+        sampleLocationsInfo.pSampleLocations = sampleLocations;
+    }
+
     static void fillSpecInfo(const RenderSpecConstant *specConstants, uint32_t specConstantsCount,
         VkSpecializationInfo &specInfo, VkSpecializationMapEntry *specEntries, uint32_t *specData)
     {
@@ -810,6 +1039,136 @@ namespace plume {
 
     // VulkanBuffer
 
+    static VkBufferUsageFlags toVkBufferUsage(RenderBufferFlags flags) {
+        const RenderBufferFlags storageFormattedMask = (RenderBufferFlag::STORAGE | RenderBufferFlag::FORMATTED);
+        VkBufferUsageFlags usage = 0;
+        usage |= (flags & RenderBufferFlag::VERTEX) ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::INDEX) ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::STORAGE) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::CONSTANT) ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::FORMATTED) ? VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT : 0;
+        usage |= ((flags & storageFormattedMask) == storageFormattedMask) ? VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::ACCELERATION_STRUCTURE) ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR : 0;
+        usage |= (flags & RenderBufferFlag::ACCELERATION_STRUCTURE_SCRATCH) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0;
+        usage |= (flags & RenderBufferFlag::ACCELERATION_STRUCTURE_INPUT) ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR : 0;
+        usage |= (flags & RenderBufferFlag::SHADER_BINDING_TABLE) ? VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR : 0;
+        usage |= (flags & RenderBufferFlag::INDIRECT) ? VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT : 0;
+
+        const uint32_t deviceAddressMask = RenderBufferFlag::CONSTANT | RenderBufferFlag::ACCELERATION_STRUCTURE | RenderBufferFlag::ACCELERATION_STRUCTURE_SCRATCH | RenderBufferFlag::ACCELERATION_STRUCTURE_INPUT | RenderBufferFlag::SHADER_BINDING_TABLE;
+        usage |= (flags & deviceAddressMask) ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
+        return usage;
+    }
+
+    static VkExternalMemoryHandleTypeFlagBits toVkExternalMemoryHandleType(RenderExternalHandleType type) {
+        switch (type) {
+        case RenderExternalHandleType::OPAQUE:
+            return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+        case RenderExternalHandleType::DMA_BUF:
+            return VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+        default:
+            assert(false && "Unknown external handle type.");
+            return VK_EXTERNAL_MEMORY_HANDLE_TYPE_FLAG_BITS_MAX_ENUM;
+        }
+    }
+
+    // External handles are file descriptors, so only non-negative values that fit an int can be imported.
+    static bool isImportableFd(RenderExternalHandle handle) {
+        return handle <= RenderExternalHandle(INT_MAX);
+    }
+
+    // Returns the first memory type with both the required and preferred flags, or the first one with only the required flags.
+    static uint32_t findMemoryTypeIndex(VulkanDevice *device, uint32_t memoryTypeBits, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags) {
+        const VkPhysicalDeviceMemoryProperties *memoryProps = nullptr;
+        vmaGetMemoryProperties(device->allocator, &memoryProps);
+
+        uint32_t fallbackIndex = UINT32_MAX;
+        for (uint32_t i = 0; i < memoryProps->memoryTypeCount; i++) {
+            const VkMemoryPropertyFlags propertyFlags = memoryProps->memoryTypes[i].propertyFlags;
+            if (((memoryTypeBits & (1U << i)) == 0) || ((propertyFlags & requiredFlags) != requiredFlags)) {
+                continue;
+            }
+
+            if ((propertyFlags & preferredFlags) == preferredFlags) {
+                return i;
+            }
+            else if (fallbackIndex == UINT32_MAX) {
+                fallbackIndex = i;
+            }
+        }
+
+        return fallbackIndex;
+    }
+
+    // Allocates dedicated memory for the buffer or image that can be exported, or imports it instead if the file descriptor is valid.
+    static VkDeviceMemory allocateExternalMemory(VulkanDevice *device, const VkMemoryRequirements &memoryRequirements, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags,
+        RenderExternalHandleType handleType, int importFd, VkBuffer buffer, VkImage image, bool deviceAddress)
+    {
+        const VkExternalMemoryHandleTypeFlagBits vkHandleType = toVkExternalMemoryHandleType(handleType);
+        uint32_t memoryTypeBits = memoryRequirements.memoryTypeBits;
+
+        // The memory types a dma-buf can be imported as depend on where it was allocated.
+        if ((importFd >= 0) && (handleType == RenderExternalHandleType::DMA_BUF)) {
+            VkMemoryFdPropertiesKHR fdProperties = {};
+            fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+
+            VkResult res = vkGetMemoryFdPropertiesKHR(device->vk, vkHandleType, importFd, &fdProperties);
+            if (res != VK_SUCCESS) {
+                fprintf(stderr, "vkGetMemoryFdPropertiesKHR failed with error code 0x%X.\n", res);
+                return VK_NULL_HANDLE;
+            }
+
+            memoryTypeBits &= fdProperties.memoryTypeBits;
+        }
+
+        const uint32_t memoryTypeIndex = findMemoryTypeIndex(device, memoryTypeBits, requiredFlags, preferredFlags);
+        if (memoryTypeIndex == UINT32_MAX) {
+            fprintf(stderr, "No memory type is compatible with the external memory.\n");
+            return VK_NULL_HANDLE;
+        }
+
+        VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+        dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+        dedicatedInfo.buffer = buffer;
+        dedicatedInfo.image = image;
+
+        VkImportMemoryFdInfoKHR importInfo = {};
+        VkExportMemoryAllocateInfo exportInfo = {};
+        if (importFd >= 0) {
+            importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+            importInfo.handleType = vkHandleType;
+            importInfo.fd = importFd;
+            dedicatedInfo.pNext = &importInfo;
+        }
+        else {
+            exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO;
+            exportInfo.handleTypes = vkHandleType;
+            dedicatedInfo.pNext = &exportInfo;
+        }
+
+        VkMemoryAllocateFlagsInfo allocateFlagsInfo = {};
+        if (deviceAddress) {
+            allocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+            allocateFlagsInfo.pNext = dedicatedInfo.pNext;
+            allocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+            dedicatedInfo.pNext = &allocateFlagsInfo;
+        }
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.pNext = &dedicatedInfo;
+        allocateInfo.allocationSize = memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkResult res = vkAllocateMemory(device->vk, &allocateInfo, nullptr, &memory);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkAllocateMemory failed with error code 0x%X.\n", res);
+            return VK_NULL_HANDLE;
+        }
+
+        return memory;
+    }
+
     VulkanBuffer::VulkanBuffer(VulkanDevice *device, VulkanPool *pool, const RenderBufferDesc &desc) {
         assert(device != nullptr);
 
@@ -817,24 +1176,17 @@ namespace plume {
         this->pool = pool;
         this->desc = desc;
 
-        const RenderBufferFlags storageFormattedMask = (RenderBufferFlag::STORAGE | RenderBufferFlag::FORMATTED);
+        // Exportable memory must be allocated outside of the allocator.
+        if (desc.exportHandleType != RenderExternalHandleType::NONE) {
+            createExternal(desc.exportHandleType, -1);
+            return;
+        }
+
         VkBufferCreateInfo bufferInfo = {};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.size = desc.size;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::VERTEX) ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::INDEX) ? VK_BUFFER_USAGE_INDEX_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::STORAGE) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::CONSTANT) ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::FORMATTED) ? VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT : 0;
-        bufferInfo.usage |= ((desc.flags & storageFormattedMask) == storageFormattedMask) ? VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::ACCELERATION_STRUCTURE) ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::ACCELERATION_STRUCTURE_SCRATCH) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::ACCELERATION_STRUCTURE_INPUT) ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR : 0;
-        bufferInfo.usage |= (desc.flags & RenderBufferFlag::SHADER_BINDING_TABLE) ? VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR : 0;
-
-        const uint32_t deviceAddressMask = RenderBufferFlag::CONSTANT | RenderBufferFlag::ACCELERATION_STRUCTURE | RenderBufferFlag::ACCELERATION_STRUCTURE_SCRATCH | RenderBufferFlag::ACCELERATION_STRUCTURE_INPUT | RenderBufferFlag::SHADER_BINDING_TABLE;
-        bufferInfo.usage |= (desc.flags & deviceAddressMask) ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
+        bufferInfo.usage = toVkBufferUsage(desc.flags);
 
         VmaAllocationCreateInfo createInfo = {};
         /* TODO: Debug pools.
@@ -892,25 +1244,222 @@ namespace plume {
         }
     }
 
+    VulkanBuffer::VulkanBuffer(VulkanDevice *device, void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        assert(device != nullptr);
+        assert(hostPointer != nullptr);
+        assert(device->capabilities.hostMemoryImport && "Importing host memory is unsupported on this device.");
+
+        const uint64_t importAlignment = device->capabilities.hostMemoryImportAlignment;
+        assert((((uintptr_t(hostPointer) % importAlignment) == 0) && ((size % importAlignment) == 0)) && "Host memory must be aligned to the import alignment.");
+
+        this->device = device;
+        this->hostPointer = hostPointer;
+        desc = RenderBufferDesc::UploadBuffer(size, flags);
+
+        VkMemoryHostPointerPropertiesEXT pointerProperties = {};
+        pointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+
+        VkResult res = vkGetMemoryHostPointerPropertiesEXT(device->vk, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, hostPointer, &pointerProperties);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkGetMemoryHostPointerPropertiesEXT failed with error code 0x%X.\n", res);
+            return;
+        }
+
+        VkExternalMemoryBufferCreateInfo externalInfo = {};
+        externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+        externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.pNext = &externalInfo;
+        bufferInfo.size = size;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.usage = toVkBufferUsage(flags) | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        res = vkCreateBuffer(device->vk, &bufferInfo, nullptr, &vk);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateBuffer failed with error code 0x%X.\n", res);
+            return;
+        }
+
+        VkMemoryRequirements memoryRequirements = {};
+        vkGetBufferMemoryRequirements(device->vk, vk, &memoryRequirements);
+
+        // Pick the first host visible memory type the pointer can be imported as.
+        const uint32_t memoryTypeBits = memoryRequirements.memoryTypeBits & pointerProperties.memoryTypeBits;
+        const uint32_t memoryTypeIndex = findMemoryTypeIndex(device, memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, 0);
+        if (memoryTypeIndex == UINT32_MAX) {
+            fprintf(stderr, "No memory type can import the host pointer.\n");
+            return;
+        }
+
+        VkImportMemoryHostPointerInfoEXT importInfo = {};
+        importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+        importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+        importInfo.pHostPointer = hostPointer;
+
+        VkMemoryAllocateFlagsInfo allocateFlagsInfo = {};
+        if (bufferInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+            allocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+            allocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+            importInfo.pNext = &allocateFlagsInfo;
+        }
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.pNext = &importInfo;
+        allocateInfo.allocationSize = size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+        res = vkAllocateMemory(device->vk, &allocateInfo, nullptr, &memory);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkAllocateMemory failed with error code 0x%X.\n", res);
+            return;
+        }
+
+        res = vkBindBufferMemory(device->vk, vk, memory, 0);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkBindBufferMemory failed with error code 0x%X.\n", res);
+            return;
+        }
+    }
+
+    VulkanBuffer::VulkanBuffer(VulkanDevice *device, const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(device != nullptr);
+
+        assert(isImportableFd(handle) && "Handle must be a valid file descriptor.");
+
+        this->device = device;
+        this->desc = desc;
+
+        createExternal(handleType, int(handle));
+    }
+
     VulkanBuffer::~VulkanBuffer() {
-        if (vk != VK_NULL_HANDLE) {
+        if (allocation != VK_NULL_HANDLE) {
             vmaDestroyBuffer(device->allocator, vk, allocation);
         }
+        else {
+            if (vk != VK_NULL_HANDLE) {
+                vkDestroyBuffer(device->vk, vk, nullptr);
+            }
+
+            if (memory != VK_NULL_HANDLE) {
+                vkFreeMemory(device->vk, memory, nullptr);
+            }
+        }
+    }
+
+    void VulkanBuffer::createExternal(RenderExternalHandleType handleType, int importFd) {
+        assert(handleType != RenderExternalHandleType::NONE);
+        assert(device->capabilities.externalMemory && "External memory is unsupported on this device.");
+        assert(((handleType != RenderExternalHandleType::DMA_BUF) || device->capabilities.externalMemoryDmaBuf) && "Dma-buf memory is unsupported on this device.");
+
+        VkExternalMemoryBufferCreateInfo externalInfo = {};
+        externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+        externalInfo.handleTypes = toVkExternalMemoryHandleType(handleType);
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.pNext = &externalInfo;
+        bufferInfo.size = desc.size;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.usage = toVkBufferUsage(desc.flags) | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        VkResult res = vkCreateBuffer(device->vk, &bufferInfo, nullptr, &vk);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateBuffer failed with error code 0x%X.\n", res);
+            return;
+        }
+
+        // Host visible memory is required to be coherent so it can be mapped without flushing or invalidating it.
+        VkMemoryPropertyFlags requiredFlags = 0;
+        VkMemoryPropertyFlags preferredFlags = 0;
+        switch (desc.heapType) {
+        case RenderHeapType::DEFAULT:
+            preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            break;
+        case RenderHeapType::UPLOAD:
+            requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            break;
+        case RenderHeapType::READBACK:
+            requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            break;
+        case RenderHeapType::GPU_UPLOAD:
+            requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            break;
+        default:
+            assert(false && "Unknown heap type.");
+            break;
+        }
+
+        VkMemoryRequirements memoryRequirements = {};
+        vkGetBufferMemoryRequirements(device->vk, vk, &memoryRequirements);
+
+        const bool deviceAddress = (bufferInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0;
+        memory = allocateExternalMemory(device, memoryRequirements, requiredFlags, preferredFlags, handleType, importFd, vk, VK_NULL_HANDLE, deviceAddress);
+        if (memory == VK_NULL_HANDLE) {
+            return;
+        }
+
+        res = vkBindBufferMemory(device->vk, vk, memory, 0);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkBindBufferMemory failed with error code 0x%X.\n", res);
+            return;
+        }
     }
 
     void *VulkanBuffer::map(uint32_t subresource, const RenderRange *readRange) {
+        // Imported memory is always accessible through the original pointer.
+        if (hostPointer != nullptr) {
+            return hostPointer;
+        }
+
         void *data = nullptr;
+
+        // External memory isn't owned by the allocator and is always coherent when it's host visible.
+        if (allocation == VK_NULL_HANDLE) {
+            VkResult res = vkMapMemory(device->vk, memory, 0, VK_WHOLE_SIZE, 0, &data);
+            if (res != VK_SUCCESS) {
+                fprintf(stderr, "vkMapMemory failed with error code 0x%X.\n", res);
+                return nullptr;
+            }
+
+            return data;
+        }
+
         VkResult res = vmaMapMemory(device->allocator, allocation, &data);
         if (res != VK_SUCCESS) {
             fprintf(stderr, "vmaMapMemory failed with error code 0x%X.\n", res);
             return nullptr;
         }
 
+        // Readback memory is not guaranteed to be coherent, so the range must be invalidated before the host reads it.
+        // This allows persistently mapped buffers to be mapped again to make the latest results visible.
+        if (desc.heapType == RenderHeapType::READBACK) {
+            const VkDeviceSize invalidateOffset = (readRange != nullptr) ? readRange->begin : 0;
+            const VkDeviceSize invalidateSize = (readRange != nullptr) ? (readRange->end - readRange->begin) : VK_WHOLE_SIZE;
+            res = vmaInvalidateAllocation(device->allocator, allocation, invalidateOffset, invalidateSize);
+            if (res != VK_SUCCESS) {
+                fprintf(stderr, "vmaInvalidateAllocation failed with error code 0x%X.\n", res);
+            }
+        }
+
         return data;
     }
 
     void VulkanBuffer::unmap(uint32_t subresource, const RenderRange *writtenRange) {
-        vmaUnmapMemory(device->allocator, allocation);
+        if (hostPointer != nullptr) {
+            return;
+        }
+
+        if (allocation == VK_NULL_HANDLE) {
+            vkUnmapMemory(device->vk, memory);
+        }
+        else {
+            vmaUnmapMemory(device->allocator, allocation);
+        }
     }
 
     std::unique_ptr<RenderBufferFormattedView> VulkanBuffer::createBufferFormattedView(RenderFormat format) {
@@ -930,6 +1479,24 @@ namespace plume {
         return vkGetBufferDeviceAddress(device->vk, &info);
     }
 
+    RenderExternalHandle VulkanBuffer::exportMemory() {
+        assert((desc.exportHandleType != RenderExternalHandleType::NONE) && "Buffer must have been created with an export handle type.");
+
+        VkMemoryGetFdInfoKHR getFdInfo = {};
+        getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+        getFdInfo.memory = memory;
+        getFdInfo.handleType = toVkExternalMemoryHandleType(desc.exportHandleType);
+
+        int fd = -1;
+        VkResult res = vkGetMemoryFdKHR(device->vk, &getFdInfo, &fd);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkGetMemoryFdKHR failed with error code 0x%X.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(fd);
+    }
+
     // VulkanBufferFormattedView
 
     VulkanBufferFormattedView::VulkanBufferFormattedView(VulkanBuffer *buffer, RenderFormat format) {
@@ -960,14 +1527,7 @@ namespace plume {
 
     // VulkanTexture
 
-    VulkanTexture::VulkanTexture(VulkanDevice *device, VulkanPool *pool, const RenderTextureDesc &desc) {
-        assert(device != nullptr);
-
-        this->device = device;
-        this->pool = pool;
-        this->desc = desc;
-        this->ownership = true;
-
+    static VkImageCreateInfo toVkImageCreateInfo(const RenderTextureDesc &desc) {
         VkImageCreateInfo imageInfo = {};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = toImageType(desc.dimension);
@@ -994,9 +1554,35 @@ namespace plume {
             imageInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
         }
 
+        // Framebuffers can only attach the depth slices of 3D textures through 2D array views.
+        if ((desc.dimension == RenderTextureDimension::TEXTURE_3D) && (desc.flags & RenderTextureFlag::RENDER_TARGET)) {
+            imageInfo.flags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
+        }
+
+        return imageInfo;
+    }
+
+    VulkanTexture::VulkanTexture(VulkanDevice *device, VulkanPool *pool, const RenderTextureDesc &desc) {
+        assert(device != nullptr);
+
+        this->device = device;
+        this->pool = pool;
+        this->desc = desc;
+        this->ownership = true;
+
+        const VkImageCreateInfo imageInfo = toVkImageCreateInfo(desc);
         imageFormat = imageInfo.format;
         fillSubresourceRange();
 
+        // Exportable memory must be allocated outside of the allocator.
+        if (desc.exportHandleType != RenderExternalHandleType::NONE) {
+            if (createExternal(imageInfo, desc.exportHandleType, -1)) {
+                createImageView(imageInfo.format);
+            }
+
+            return;
+        }
+
         VmaAllocationCreateInfo createInfo = {};
         createInfo.pool = (pool != nullptr) ? pool->vk : VK_NULL_HANDLE;
         createInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -1022,14 +1608,74 @@ namespace plume {
         vk = image;
     }
 
+    VulkanTexture::VulkanTexture(VulkanDevice *device, const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        assert(device != nullptr);
+        assert(isImportableFd(handle) && "Handle must be a valid file descriptor.");
+
+        this->device = device;
+        this->desc = desc;
+        this->ownership = true;
+
+        const VkImageCreateInfo imageInfo = toVkImageCreateInfo(desc);
+        imageFormat = imageInfo.format;
+        fillSubresourceRange();
+
+        if (createExternal(imageInfo, handleType, int(handle))) {
+            createImageView(imageInfo.format);
+        }
+    }
+
     VulkanTexture::~VulkanTexture() {
         if (imageView != VK_NULL_HANDLE) {
             vkDestroyImageView(device->vk, imageView, nullptr);
         }
 
         if (ownership && (vk != VK_NULL_HANDLE)) {
-            vmaDestroyImage(device->allocator, vk, allocation);
+            if (allocation != VK_NULL_HANDLE) {
+                vmaDestroyImage(device->allocator, vk, allocation);
+            }
+            else {
+                vkDestroyImage(device->vk, vk, nullptr);
+            }
+        }
+
+        if (memory != VK_NULL_HANDLE) {
+            vkFreeMemory(device->vk, memory, nullptr);
+        }
+    }
+
+    bool VulkanTexture::createExternal(const VkImageCreateInfo &imageInfo, RenderExternalHandleType handleType, int importFd) {
+        assert(device->capabilities.externalMemory && "External memory is unsupported on this device.");
+        assert((handleType == RenderExternalHandleType::OPAQUE) && "Textures only support opaque external memory.");
+
+        VkExternalMemoryImageCreateInfo externalInfo = {};
+        externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO;
+        externalInfo.handleTypes = toVkExternalMemoryHandleType(handleType);
+
+        VkImageCreateInfo externalImageInfo = imageInfo;
+        externalImageInfo.pNext = &externalInfo;
+
+        VkResult res = vkCreateImage(device->vk, &externalImageInfo, nullptr, &vk);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateImage failed with error code 0x%X.\n", res);
+            return false;
+        }
+
+        VkMemoryRequirements memoryRequirements = {};
+        vkGetImageMemoryRequirements(device->vk, vk, &memoryRequirements);
+
+        memory = allocateExternalMemory(device, memoryRequirements, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, handleType, importFd, VK_NULL_HANDLE, vk, false);
+        if (memory == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        res = vkBindImageMemory(device->vk, vk, memory, 0);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkBindImageMemory failed with error code 0x%X.\n", res);
+            return false;
         }
+
+        return true;
     }
     
     void VulkanTexture::createImageView(VkFormat format) {
@@ -1060,6 +1706,24 @@ namespace plume {
         setObjectName(device->vk, VK_OBJECT_TYPE_IMAGE, uint64_t(vk), name);
     }
 
+    RenderExternalHandle VulkanTexture::exportMemory() {
+        assert((desc.exportHandleType != RenderExternalHandleType::NONE) && "Texture must have been created with an export handle type.");
+
+        VkMemoryGetFdInfoKHR getFdInfo = {};
+        getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+        getFdInfo.memory = memory;
+        getFdInfo.handleType = toVkExternalMemoryHandleType(desc.exportHandleType);
+
+        int fd = -1;
+        VkResult res = vkGetMemoryFdKHR(device->vk, &getFdInfo, &fd);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkGetMemoryFdKHR failed with error code 0x%X.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(fd);
+    }
+
     void VulkanTexture::fillSubresourceRange() {
         imageSubresourceRange.aspectMask = toViewAspectFlags(desc.flags);
         imageSubresourceRange.baseMipLevel = 0;
@@ -1139,6 +1803,19 @@ namespace plume {
         }
     }
 
+    // VulkanLayoutKeyHash
+
+    size_t VulkanLayoutKeyHash::operator()(const VulkanLayoutKey &key) const {
+        // FNV-1a.
+        uint64_t hash = 14695981039346656037ULL;
+        for (uint64_t value : key) {
+            hash ^= value;
+            hash *= 1099511628211ULL;
+        }
+
+        return size_t(hash);
+    }
+
     // VulkanDescriptorSetLayout
 
     VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(VulkanDevice *device, const RenderDescriptorSetDesc &descriptorSetDesc) {
@@ -1147,8 +1824,8 @@ namespace plume {
         this->device = device;
 
         // Gather immutable sampler handles.
-        thread_local std::vector<VkSampler> samplerHandles;
-        samplerHandles.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkSampler> samplerHandles;
 
         for (uint32_t i = 0; i < descriptorSetDesc.descriptorRangesCount; i++) {
             const RenderDescriptorRange &srcRange = descriptorSetDesc.descriptorRanges[i];
@@ -1190,16 +1867,15 @@ namespace plume {
         setLayoutInfo.pBindings = !setBindings.empty() ? setBindings.data() : nullptr;
         setLayoutInfo.bindingCount = uint32_t(setBindings.size());
         
-        thread_local std::vector<VkDescriptorBindingFlags> bindingFlags;
+        RenderScratchArray<VkDescriptorBindingFlags> bindingFlags;
         VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {};
         if (descriptorSetDesc.lastRangeIsBoundless && (descriptorSetDesc.descriptorRangesCount > 0)) {
-            bindingFlags.clear();
-            bindingFlags.resize(descriptorSetDesc.descriptorRangesCount, 0);
+            bindingFlags.resize(descriptorSetDesc.descriptorRangesCount);
             bindingFlags[descriptorSetDesc.descriptorRangesCount - 1] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
 
             flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
             flagsInfo.pBindingFlags = bindingFlags.data();
-            flagsInfo.bindingCount = uint32_t(bindingFlags.size());
+            flagsInfo.bindingCount = bindingFlags.size();
 
             setLayoutInfo.pNext = &flagsInfo;
             setLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
@@ -1218,6 +1894,26 @@ namespace plume {
         }
     }
 
+    void VulkanDescriptorSetLayout::computeKey(const RenderDescriptorSetDesc &descriptorSetDesc, VulkanLayoutKey &key) {
+        // The size of the boundless range is only used when allocating the set, so it's not part of the layout.
+        key.clear();
+        key.emplace_back(descriptorSetDesc.lastRangeIsBoundless ? 1 : 0);
+        key.emplace_back(descriptorSetDesc.descriptorRangesCount);
+        for (uint32_t i = 0; i < descriptorSetDesc.descriptorRangesCount; i++) {
+            const RenderDescriptorRange &range = descriptorSetDesc.descriptorRanges[i];
+            key.emplace_back(uint64_t(range.type));
+            key.emplace_back(range.count);
+            key.emplace_back(range.binding);
+            key.emplace_back((range.immutableSampler != nullptr) ? 1 : 0);
+
+            if (range.immutableSampler != nullptr) {
+                for (uint32_t j = 0; j < range.count; j++) {
+                    key.emplace_back(static_cast<const VulkanSampler *>(range.immutableSampler[j])->id);
+                }
+            }
+        }
+    }
+
     // VulkanPipelineLayout
 
     VulkanPipelineLayout::VulkanPipelineLayout(VulkanDevice *device, const RenderPipelineLayoutDesc &desc) {
@@ -1242,17 +1938,19 @@ namespace plume {
             dstRange.stageFlags |= (srcRange.stageFlags & RenderShaderStageFlag::CLOSEST_HIT) ? VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR : 0;
             dstRange.stageFlags |= (srcRange.stageFlags & RenderShaderStageFlag::MISS) ? VK_SHADER_STAGE_MISS_BIT_KHR : 0;
             dstRange.stageFlags |= (srcRange.stageFlags & RenderShaderStageFlag::CALLABLE) ? VK_SHADER_STAGE_CALLABLE_BIT_KHR : 0;
+            dstRange.stageFlags |= (srcRange.stageFlags & RenderShaderStageFlag::TASK) ? VK_SHADER_STAGE_TASK_BIT_EXT : 0;
+            dstRange.stageFlags |= (srcRange.stageFlags & RenderShaderStageFlag::MESH) ? VK_SHADER_STAGE_MESH_BIT_EXT : 0;
             pushConstantRanges.emplace_back(dstRange);
         }
 
         layoutInfo.pPushConstantRanges = !pushConstantRanges.empty() ? pushConstantRanges.data() : nullptr;
         layoutInfo.pushConstantRangeCount = uint32_t(pushConstantRanges.size());
 
-        thread_local std::vector<VkDescriptorSetLayout> setLayoutHandles;
-        setLayoutHandles.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkDescriptorSetLayout> setLayoutHandles;
 
         for (uint32_t i = 0; i < desc.descriptorSetDescsCount; i++) {
-            VulkanDescriptorSetLayout *setLayout = new VulkanDescriptorSetLayout(device, desc.descriptorSetDescs[i]);
+            VulkanDescriptorSetLayout *setLayout = device->acquireDescriptorSetLayout(desc.descriptorSetDescs[i]);
             descriptorSetLayouts.emplace_back(setLayout);
             setLayoutHandles.emplace_back(setLayout->vk);
         }
@@ -1260,21 +1958,44 @@ namespace plume {
         layoutInfo.pSetLayouts = !setLayoutHandles.empty() ? setLayoutHandles.data() : nullptr;
         layoutInfo.setLayoutCount = uint32_t(setLayoutHandles.size());
 
-        VkResult res = vkCreatePipelineLayout(device->vk, &layoutInfo, nullptr, &vk);
-        if (res != VK_SUCCESS) {
-            fprintf(stderr, "vkCreatePipelineLayout failed with error code 0x%X.\n", res);
-            return;
+        // Set layouts are shared, so they're identified by their objects.
+        cacheKey.emplace_back(pushConstantRanges.size());
+        for (const VkPushConstantRange &range : pushConstantRanges) {
+            cacheKey.emplace_back(range.offset);
+            cacheKey.emplace_back(range.size);
+            cacheKey.emplace_back(range.stageFlags);
         }
+
+        for (const VulkanDescriptorSetLayout *setLayout : descriptorSetLayouts) {
+            cacheKey.emplace_back(uint64_t(reinterpret_cast<uintptr_t>(setLayout)));
+        }
+
+        vk = device->acquirePipelineLayout(cacheKey, layoutInfo);
     }
 
     VulkanPipelineLayout::~VulkanPipelineLayout() {
         if (vk != VK_NULL_HANDLE) {
-            vkDestroyPipelineLayout(device->vk, vk, nullptr);
+            device->releasePipelineLayout(cacheKey);
         }
 
         for (VulkanDescriptorSetLayout *setLayout : descriptorSetLayouts) {
-            delete setLayout;
+            device->releaseDescriptorSetLayout(setLayout);
+        }
+    }
+
+    bool VulkanPipelineLayout::isCompatibleForSet(const VulkanLayoutKey &otherKey, uint32_t setIndex) const {
+        // Layouts are compatible for a set if their push constant ranges and all the set layouts up to and including the set are identical.
+        // The key stores the push constant ranges first and the set layouts after them, so this is a comparison of the prefix up to the set.
+        if (setIndex >= descriptorSetLayouts.size()) {
+            return false;
+        }
+
+        const size_t prefixLength = 1 + pushConstantRanges.size() * 3 + setIndex + 1;
+        if (otherKey.size() < prefixLength) {
+            return false;
         }
+
+        return std::equal(cacheKey.begin(), cacheKey.begin() + prefixLength, otherKey.begin());
     }
 
     // VulkanShader
@@ -1311,12 +2032,34 @@ namespace plume {
         setObjectName(device->vk, VK_OBJECT_TYPE_SHADER_MODULE, uint64_t(vk), name);
     }
 
+    // VulkanShaderObject
+
+    VulkanShaderObject::VulkanShaderObject(VulkanDevice *device, VkShaderEXT vk, VkShaderStageFlagBits stage) {
+        assert(device != nullptr);
+        assert(vk != VK_NULL_HANDLE);
+
+        this->device = device;
+        this->vk = vk;
+        this->stage = stage;
+    }
+
+    VulkanShaderObject::~VulkanShaderObject() {
+        if (vk != VK_NULL_HANDLE) {
+            vkDestroyShaderEXT(device->vk, vk, nullptr);
+        }
+    }
+
+    void VulkanShaderObject::setName(const std::string &name) {
+        setObjectName(device->vk, VK_OBJECT_TYPE_SHADER_EXT, uint64_t(vk), name);
+    }
+
     // VulkanSampler
 
     VulkanSampler::VulkanSampler(VulkanDevice *device, const RenderSamplerDesc &desc) {
         assert(device != nullptr);
 
         this->device = device;
+        this->id = ++device->samplerIdCounter;
 
         VkSamplerCreateInfo samplerInfo = {};
         samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -1368,8 +2111,12 @@ namespace plume {
         assert(desc.pipelineLayout != nullptr);
         assert((desc.threadGroupSizeX > 0) && (desc.threadGroupSizeY > 0) && (desc.threadGroupSizeZ > 0));
 
-        std::vector<VkSpecializationMapEntry> specEntries(desc.specConstantsCount);
-        std::vector<uint32_t> specData(desc.specConstantsCount);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkSpecializationMapEntry> specEntries;
+        RenderScratchArray<uint32_t> specData;
+        specEntries.resize(desc.specConstantsCount);
+        specData.resize(desc.specConstantsCount);
+
         VkSpecializationInfo specInfo = {};
         fillSpecInfo(desc.specConstants, desc.specConstantsCount, specInfo, specEntries.data(), specData.data());
 
@@ -1414,11 +2161,22 @@ namespace plume {
     VulkanGraphicsPipeline::VulkanGraphicsPipeline(VulkanDevice *device, const RenderGraphicsPipelineDesc &desc) : VulkanPipeline(device, Type::Graphics) {
         assert(desc.pipelineLayout != nullptr);
 
-        thread_local std::vector<VkPipelineShaderStageCreateInfo> stages;
-        stages.clear();
+        dynamicStates = desc.dynamicStates;
+
+        const bool meshPipeline = (desc.meshShader != nullptr);
+        assert((!meshPipeline || device->capabilities.meshShader) && "Mesh shaders are unsupported on this device.");
+        assert((!meshPipeline || ((desc.vertexShader == nullptr) && (desc.geometryShader == nullptr))) && "Mesh pipelines can't use vertex or geometry shaders.");
+        assert(((desc.taskShader == nullptr) || meshPipeline) && "Task shaders require a mesh shader.");
+        assert((!meshPipeline || !(desc.dynamicStates & (RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY | RenderDynamicStateFlag::VERTEX_INPUT | RenderDynamicStateFlag::VERTEX_BUFFER_STRIDE))) && "Mesh pipelines can't use dynamic vertex input or topology.");
+        assert(((desc.viewMask == 0) || device->capabilities.multiview) && "Multiview is unsupported on this device.");
+
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkPipelineShaderStageCreateInfo> stages;
+        RenderScratchArray<VkSpecializationMapEntry> specEntries;
+        RenderScratchArray<uint32_t> specData;
+        specEntries.resize(desc.specConstantsCount);
+        specData.resize(desc.specConstantsCount);
 
-        std::vector<VkSpecializationMapEntry> specEntries(desc.specConstantsCount);
-        std::vector<uint32_t> specData(desc.specConstantsCount);
         VkSpecializationInfo specInfo = {};
         fillSpecInfo(desc.specConstants, desc.specConstantsCount, specInfo, specEntries.data(), specData.data());
 
@@ -1445,6 +2203,28 @@ namespace plume {
             stages.emplace_back(stageInfo);
         }
 
+        if (desc.taskShader != nullptr) {
+            const VulkanShader *taskShader = static_cast<const VulkanShader *>(desc.taskShader);
+            VkPipelineShaderStageCreateInfo stageInfo = {};
+            stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stageInfo.stage = VK_SHADER_STAGE_TASK_BIT_EXT;
+            stageInfo.module = taskShader->vk;
+            stageInfo.pName = taskShader->entryPointName.c_str();
+            stageInfo.pSpecializationInfo = pSpecInfo;
+            stages.emplace_back(stageInfo);
+        }
+
+        if (desc.meshShader != nullptr) {
+            const VulkanShader *meshShader = static_cast<const VulkanShader *>(desc.meshShader);
+            VkPipelineShaderStageCreateInfo stageInfo = {};
+            stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stageInfo.stage = VK_SHADER_STAGE_MESH_BIT_EXT;
+            stageInfo.module = meshShader->vk;
+            stageInfo.pName = meshShader->entryPointName.c_str();
+            stageInfo.pSpecializationInfo = pSpecInfo;
+            stages.emplace_back(stageInfo);
+        }
+
         if (desc.pixelShader != nullptr) {
             const VulkanShader *pixelShader = static_cast<const VulkanShader *>(desc.pixelShader);
             VkPipelineShaderStageCreateInfo stageInfo = {};
@@ -1456,10 +2236,8 @@ namespace plume {
             stages.emplace_back(stageInfo);
         }
 
-        thread_local std::vector<VkVertexInputBindingDescription> vertexBindings;
-        thread_local std::vector<VkVertexInputAttributeDescription> vertexAttributes;
-        vertexBindings.clear();
-        vertexAttributes.clear();
+        RenderScratchArray<VkVertexInputBindingDescription> vertexBindings;
+        RenderScratchArray<VkVertexInputAttributeDescription> vertexAttributes;
 
         for (uint32_t i = 0; i < desc.inputSlotsCount; i++) {
             const RenderInputSlot &inputSlot = desc.inputSlots[i];
@@ -1483,9 +2261,9 @@ namespace plume {
         VkPipelineVertexInputStateCreateInfo vertexInput = {};
         vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vertexInput.pVertexBindingDescriptions = !vertexBindings.empty() ? vertexBindings.data() : nullptr;
-        vertexInput.vertexBindingDescriptionCount = uint32_t(vertexBindings.size());
+        vertexInput.vertexBindingDescriptionCount = vertexBindings.size();
         vertexInput.pVertexAttributeDescriptions = !vertexAttributes.empty() ? vertexAttributes.data() : nullptr;
-        vertexInput.vertexAttributeDescriptionCount = uint32_t(vertexAttributes.size());
+        vertexInput.vertexAttributeDescriptionCount = vertexAttributes.size();
 
         VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -1523,27 +2301,12 @@ namespace plume {
             rasterization.depthBiasSlopeFactor = desc.slopeScaledDepthBias;
         }
 
-        thread_local std::vector<VkSampleLocationEXT> sampleLocationVector;
+        VkSampleLocationEXT sampleLocationArray[RenderMultisampling::MaxSampleLocations];
         VkSampleLocationsInfoEXT sampleLocationsInfo = {};
         VkPipelineSampleLocationsStateCreateInfoEXT sampleLocations = {};
         const void *multisamplingNext = nullptr;
         if (desc.multisampling.sampleLocationsEnabled) {
-            const float *coordinateRange = device->sampleLocationProperties.sampleLocationCoordinateRange;
-            const float coordinateBase = coordinateRange[0];
-            const float coordinateSpace = (coordinateRange[1] - coordinateRange[0]) / 15.0f;
-            sampleLocationVector.resize(desc.multisampling.sampleCount);
-            for (uint32_t i = 0; i < desc.multisampling.sampleCount; i++) {
-                const RenderMultisamplingLocation &location = desc.multisampling.sampleLocations[i];
-                sampleLocationVector[i].x = coordinateBase + (location.x + 8) * coordinateSpace;
-                sampleLocationVector[i].y = coordinateBase + (location.y + 8) * coordinateSpace;
-            }
-
-            sampleLocationsInfo.sType = VK_STRUCTURE_TYPE_SAMPLE_LOCATIONS_INFO_EXT;
-            sampleLocationsInfo.sampleLocationsPerPixel = VkSampleCountFlagBits(desc.multisampling.sampleCount);
-            sampleLocationsInfo.sampleLocationGridSize.width = 1;
-            sampleLocationsInfo.sampleLocationGridSize.height = 1;
-            sampleLocationsInfo.sampleLocationsCount = uint32_t(sampleLocationVector.size());
-            sampleLocationsInfo.pSampleLocations = sampleLocationVector.data();
+            fillSampleLocations(device, desc.multisampling, sampleLocationArray, sampleLocationsInfo);
 
             sampleLocations.sType = VK_STRUCTURE_TYPE_PIPELINE_SAMPLE_LOCATIONS_STATE_CREATE_INFO_EXT;
             sampleLocations.sampleLocationsEnable = true;
@@ -1557,8 +2320,7 @@ namespace plume {
         multisampling.rasterizationSamples = VkSampleCountFlagBits(desc.multisampling.sampleCount);
         multisampling.alphaToCoverageEnable = desc.alphaToCoverageEnabled;
 
-        thread_local std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments;
-        colorBlendAttachments.clear();
+        RenderScratchArray<VkPipelineColorBlendAttachmentState> colorBlendAttachments;
 
         for (uint32_t i = 0; i < desc.renderTargetCount; i++) {
             VkPipelineColorBlendAttachmentState attachment = {};
@@ -1579,7 +2341,7 @@ namespace plume {
         colorBlend.logicOpEnable = desc.logicOpEnabled;
         colorBlend.logicOp = toVk(desc.logicOp);
         colorBlend.pAttachments = !colorBlendAttachments.empty() ? colorBlendAttachments.data() : nullptr;
-        colorBlend.attachmentCount = uint32_t(colorBlendAttachments.size());
+        colorBlend.attachmentCount = colorBlendAttachments.size();
         
         VkPipelineDepthStencilStateCreateInfo depthStencil = {};
         depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
@@ -1605,27 +2367,79 @@ namespace plume {
         depthStencil.back.writeMask = desc.stencilWriteMask;
         depthStencil.back.reference = desc.stencilReference;
 
-        thread_local std::vector<VkDynamicState> dynamicStates;
-        dynamicStates.clear();
-        dynamicStates.emplace_back(VK_DYNAMIC_STATE_VIEWPORT);
-        dynamicStates.emplace_back(VK_DYNAMIC_STATE_SCISSOR);
+        RenderScratchArray<VkDynamicState> vkDynamicStates;
+        vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_VIEWPORT);
+        vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_SCISSOR);
 
         if (desc.dynamicDepthBiasEnabled) {
-            dynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_BIAS);
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_BIAS);
+        }
+
+        assert(((desc.dynamicStates & ~device->capabilities.dynamicStates) == 0) && "Dynamic states are unsupported on this device.");
+        if (desc.dynamicStates & RenderDynamicStateFlag::CULL_MODE) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::FRONT_FACE) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_FRONT_FACE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::DEPTH_ENABLED) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::DEPTH_WRITE_ENABLED) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::DEPTH_FUNCTION) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::STENCIL_ENABLED) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::STENCIL_FACES) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_STENCIL_OP_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::STENCIL_REFERENCE) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_STENCIL_REFERENCE);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::DEPTH_BIAS_ENABLED) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::DEPTH_CLIP_ENABLED) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::VERTEX_INPUT) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_VERTEX_INPUT_EXT);
+        }
+
+        if (desc.dynamicStates & RenderDynamicStateFlag::VERTEX_BUFFER_STRIDE) {
+            vkDynamicStates.emplace_back(VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE_EXT);
         }
 
         VkPipelineDynamicStateCreateInfo dynamicState = {};
         dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.pDynamicStates = dynamicStates.data();
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = vkDynamicStates.data();
+        dynamicState.dynamicStateCount = vkDynamicStates.size();
 
-        thread_local std::vector<VkFormat> renderTargetFormats;
+        RenderScratchArray<VkFormat> renderTargetFormats;
         renderTargetFormats.resize(desc.renderTargetCount);
         for (uint32_t i = 0; i < desc.renderTargetCount; i++) {
             renderTargetFormats[i] = toVk(desc.renderTargetFormat[i]);
         }
 
-        renderPass = createRenderPass(device, renderTargetFormats.data(), desc.renderTargetCount, toVk(desc.depthTargetFormat), VkSampleCountFlagBits(desc.multisampling.sampleCount));
+        renderPass = createRenderPass(device, renderTargetFormats.data(), desc.renderTargetCount, toVk(desc.depthTargetFormat), VkSampleCountFlagBits(desc.multisampling.sampleCount), desc.viewMask);
         if (renderPass == VK_NULL_HANDLE) {
             return;
         }
@@ -1634,9 +2448,9 @@ namespace plume {
         VkGraphicsPipelineCreateInfo pipelineInfo = {};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         pipelineInfo.pStages = stages.data();
-        pipelineInfo.stageCount = uint32_t(stages.size());
-        pipelineInfo.pVertexInputState = &vertexInput;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.stageCount = stages.size();
+        pipelineInfo.pVertexInputState = (meshPipeline || (desc.dynamicStates & RenderDynamicStateFlag::VERTEX_INPUT)) ? nullptr : &vertexInput;
+        pipelineInfo.pInputAssemblyState = meshPipeline ? nullptr : &inputAssembly;
         pipelineInfo.pViewportState = &viewportState;
         pipelineInfo.pRasterizationState = &rasterization;
         pipelineInfo.pMultisampleState = &multisampling;
@@ -1672,16 +2486,15 @@ namespace plume {
         return RenderPipelineProgram();
     }
 
-    VkRenderPass VulkanGraphicsPipeline::createRenderPass(VulkanDevice *device, const VkFormat *renderTargetFormat, uint32_t renderTargetCount, VkFormat depthTargetFormat, VkSampleCountFlagBits sampleCount) {
+    VkRenderPass VulkanGraphicsPipeline::createRenderPass(VulkanDevice *device, const VkFormat *renderTargetFormat, uint32_t renderTargetCount, VkFormat depthTargetFormat, VkSampleCountFlagBits sampleCount, uint32_t viewMask) {
         VkRenderPass renderPass = VK_NULL_HANDLE;
         VkSubpassDescription subpass = {};
         VkAttachmentReference depthReference = {};
         subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-        thread_local std::vector<VkAttachmentDescription> attachments;
-        thread_local std::vector<VkAttachmentReference> colorReferences;
-        attachments.clear();
-        colorReferences.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkAttachmentDescription> attachments;
+        RenderScratchArray<VkAttachmentReference> colorReferences;
         for (uint32_t i = 0; i < renderTargetCount; i++) {
             VkAttachmentReference reference = {};
             reference.attachment = uint32_t(attachments.size());
@@ -1727,6 +2540,17 @@ namespace plume {
         passInfo.pSubpasses = &subpass;
         passInfo.subpassCount = 1;
 
+        // The render pass must match the view mask of the framebuffers to be compatible with them.
+        VkRenderPassMultiviewCreateInfo multiviewInfo = {};
+        if (viewMask != 0) {
+            multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+            multiviewInfo.pViewMasks = &viewMask;
+            multiviewInfo.subpassCount = 1;
+            multiviewInfo.pCorrelationMasks = &viewMask;
+            multiviewInfo.correlationMaskCount = 1;
+            passInfo.pNext = &multiviewInfo;
+        }
+
         VkResult res = vkCreateRenderPass(device->vk, &passInfo, nullptr, &renderPass);
         if (res == VK_SUCCESS) {
             return renderPass;
@@ -1879,13 +2703,27 @@ namespace plume {
 
     // VulkanDescriptorSet
 
+    static void addPoolSize(RenderScratchArray<VkDescriptorPoolSize> &poolSizes, VkDescriptorType type, uint32_t count) {
+        for (VkDescriptorPoolSize &poolSize : poolSizes) {
+            if (poolSize.type == type) {
+                poolSize.descriptorCount += count;
+                return;
+            }
+        }
+
+        VkDescriptorPoolSize poolSize = {};
+        poolSize.type = type;
+        poolSize.descriptorCount = count;
+        poolSizes.emplace_back(poolSize);
+    }
+
     VulkanDescriptorSet::VulkanDescriptorSet(VulkanDevice *device, const RenderDescriptorSetDesc &desc) {
         assert(device != nullptr);
 
         this->device = device;
 
-        thread_local std::unordered_map<VkDescriptorType, uint32_t> typeCounts;
-        typeCounts.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkDescriptorPoolSize> poolSizes;
         
         uint32_t boundlessRangeSize = 0;
         uint32_t rangeCount = desc.descriptorRangesCount;
@@ -1896,18 +2734,18 @@ namespace plume {
             boundlessRangeSize = std::max(desc.boundlessRangeSize, 1U);
 
             const RenderDescriptorRange &lastDescriptorRange = desc.descriptorRanges[desc.descriptorRangesCount - 1];
-            typeCounts[toVk(lastDescriptorRange.type)] += boundlessRangeSize;
+            addPoolSize(poolSizes, toVk(lastDescriptorRange.type), boundlessRangeSize);
             rangeCount--;
         }
 
         for (uint32_t i = 0; i < rangeCount; i++) {
             const RenderDescriptorRange &descriptorRange = desc.descriptorRanges[i];
-            typeCounts[toVk(descriptorRange.type)] += descriptorRange.count;
+            addPoolSize(poolSizes, toVk(descriptorRange.type), descriptorRange.count);
         }
 
-        setLayout = new VulkanDescriptorSetLayout(device, desc);
+        setLayout = device->acquireDescriptorSetLayout(desc);
 
-        descriptorPool = createDescriptorPool(device, typeCounts, desc.lastRangeIsBoundless);
+        descriptorPool = createDescriptorPool(device, poolSizes.data(), poolSizes.size(), desc.lastRangeIsBoundless);
         if (descriptorPool == VK_NULL_HANDLE) {
             return;
         }
@@ -1938,7 +2776,9 @@ namespace plume {
             vkDestroyDescriptorPool(device->vk, descriptorPool, nullptr);
         }
 
-        delete setLayout;
+        if (setLayout != nullptr) {
+            device->releaseDescriptorSetLayout(setLayout);
+        }
     }
     
     void VulkanDescriptorSet::setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize, const RenderBufferStructuredView *bufferStructuredView, const RenderBufferFormattedView *bufferFormattedView) {
@@ -2036,23 +2876,13 @@ namespace plume {
         vkUpdateDescriptorSets(device->vk, 1, &writeDescriptor, 0, nullptr);
     }
 
-    VkDescriptorPool VulkanDescriptorSet::createDescriptorPool(VulkanDevice *device, const std::unordered_map<VkDescriptorType, uint32_t> &typeCounts, bool lastRangeIsBoundless) {
-        thread_local std::vector<VkDescriptorPoolSize> poolSizes;
-        poolSizes.clear();
-
+    VkDescriptorPool VulkanDescriptorSet::createDescriptorPool(VulkanDevice *device, const VkDescriptorPoolSize *poolSizes, uint32_t poolSizesCount, bool lastRangeIsBoundless) {
         VkDescriptorPool descriptorPool;
-        for (auto it : typeCounts) {
-            VkDescriptorPoolSize poolSize = {};
-            poolSize.type = it.first;
-            poolSize.descriptorCount = it.second;
-            poolSizes.emplace_back(poolSize);
-        }
-
         VkDescriptorPoolCreateInfo poolInfo = {};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.maxSets = 1;
-        poolInfo.pPoolSizes = !poolSizes.empty() ? poolSizes.data() : nullptr;
-        poolInfo.poolSizeCount = uint32_t(poolSizes.size());
+        poolInfo.pPoolSizes = (poolSizesCount > 0) ? poolSizes : nullptr;
+        poolInfo.poolSizeCount = poolSizesCount;
 
         if (lastRangeIsBoundless) {
             poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
@@ -2252,8 +3082,8 @@ namespace plume {
     }
 
     bool VulkanSwapChain::present(uint32_t textureIndex, RenderCommandSemaphore **waitSemaphores, uint32_t waitSemaphoreCount) {
-        thread_local std::vector<VkSemaphore> waitSemaphoresVector;
-        waitSemaphoresVector.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkSemaphore> waitSemaphoresVector;
         for (uint32_t i = 0; i < waitSemaphoreCount; i++) {
             VulkanCommandSemaphore *interfaceSemaphore = (VulkanCommandSemaphore *)(waitSemaphores[i]);
             waitSemaphoresVector.emplace_back(interfaceSemaphore->vk);
@@ -2499,8 +3329,14 @@ namespace plume {
     VulkanFramebuffer::VulkanFramebuffer(VulkanDevice *device, const RenderFramebufferDesc &desc) {
         assert(device != nullptr);
 
+        assert((desc.layerCount > 0) && "Framebuffers must have at least one layer.");
+        assert((desc.layerCount <= device->capabilities.maxFramebufferLayers) && "Layer count exceeds the amount of layers supported by the device.");
+        assert(((desc.viewMask == 0) || (desc.layerCount == 1)) && "Layered framebuffers can't use multiview.");
+
         this->device = device;
         depthAttachmentReadOnly = desc.depthAttachmentReadOnly;
+        layerCount = desc.layerCount;
+        viewMask = desc.viewMask;
 
         VkResult res;
         std::vector<VkAttachmentDescription> attachments;
@@ -2511,20 +3347,37 @@ namespace plume {
             const VulkanTexture *colorAttachment;
             VkImageView colorAttachmentImageView;
             RenderFormat colorAttachmentFormat;
+            uint32_t colorAttachmentMipSlice = 0;
             if (desc.colorAttachmentViews && desc.colorAttachmentViews[i]) {
                 const VulkanTextureView* colorAttachmentView = static_cast<const VulkanTextureView *>(desc.colorAttachmentViews[i]);
                 colorAttachment = colorAttachmentView->texture;
                 colorAttachmentImageView = colorAttachmentView->vk;
                 colorAttachmentFormat = colorAttachmentView->desc.format;
+                colorAttachmentMipSlice = colorAttachmentView->desc.mipSlice;
             } else {
                 colorAttachment = static_cast<const VulkanTexture *>(desc.colorAttachments[i]);
                 colorAttachmentImageView = colorAttachment->imageView;
                 colorAttachmentFormat = colorAttachment->desc.format;
             }
             assert((colorAttachment->desc.flags & RenderTextureFlag::RENDER_TARGET) && "Color attachment must be a render target.");
+
+            if (colorAttachment->desc.dimension == RenderTextureDimension::TEXTURE_3D) {
+                colorAttachmentImageView = createSliceImageView(colorAttachment, colorAttachmentFormat, colorAttachmentMipSlice, desc.layerCount);
+                if (colorAttachmentImageView == VK_NULL_HANDLE) {
+                    return;
+                }
+            }
             colorAttachments.emplace_back(colorAttachment);
             imageViews.emplace_back(colorAttachmentImageView);
 
+            VkRenderingAttachmentInfoKHR renderingAttachment = {};
+            renderingAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+            renderingAttachment.imageView = colorAttachmentImageView;
+            renderingAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            renderingAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            renderingAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorRenderingAttachments.emplace_back(renderingAttachment);
+
             if (i == 0) {
                 width = uint32_t(colorAttachment->desc.width);
                 height = colorAttachment->desc.height;
@@ -2591,6 +3444,13 @@ namespace plume {
             attachment.initialLayout = depthReference.layout;
             attachment.finalLayout = depthReference.layout;
             attachments.emplace_back(attachment);
+
+            depthRenderingAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+            depthRenderingAttachment.imageView = depthAttachmentImageView;
+            depthRenderingAttachment.imageLayout = depthReference.layout;
+            depthRenderingAttachment.loadOp = attachment.loadOp;
+            depthRenderingAttachment.storeOp = attachment.storeOp;
+            depthRenderingStencil = RenderFormatIsStencil(depthAttachmentViewDesc.format);
         }
 
         VkSubpassDescription subpass = {};
@@ -2609,6 +3469,19 @@ namespace plume {
         passInfo.pSubpasses = &subpass;
         passInfo.subpassCount = 1;
 
+        // The views are correlated as they're expected to be rendered from nearby positions, like stereo eyes or the faces of a cubemap.
+        VkRenderPassMultiviewCreateInfo multiviewInfo = {};
+        if (desc.viewMask != 0) {
+            assert(device->capabilities.multiview && "Multiview is unsupported on this device.");
+            assert((uint32_t(numberOfSetBits(desc.viewMask)) <= device->capabilities.maxMultiviewViewCount) && "View mask exceeds the amount of views supported by the device.");
+            multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+            multiviewInfo.pViewMasks = &desc.viewMask;
+            multiviewInfo.subpassCount = 1;
+            multiviewInfo.pCorrelationMasks = &desc.viewMask;
+            multiviewInfo.correlationMaskCount = 1;
+            passInfo.pNext = &multiviewInfo;
+        }
+
         res = vkCreateRenderPass(device->vk, &passInfo, nullptr, &renderPass);
         if (res != VK_SUCCESS) {
             fprintf(stderr, "vkCreateRenderPass failed with error code 0x%X.\n", res);
@@ -2622,7 +3495,7 @@ namespace plume {
         fbInfo.attachmentCount = uint32_t(imageViews.size());
         fbInfo.width = width;
         fbInfo.height = height;
-        fbInfo.layers = 1;
+        fbInfo.layers = desc.layerCount;
 
         res = vkCreateFramebuffer(device->vk, &fbInfo, nullptr, &vk);
         if (res != VK_SUCCESS) {
@@ -2636,6 +3509,10 @@ namespace plume {
             vkDestroyFramebuffer(device->vk, vk, nullptr);
         }
 
+        for (VkImageView sliceImageView : sliceImageViews) {
+            vkDestroyImageView(device->vk, sliceImageView, nullptr);
+        }
+
         if (renderPass != VK_NULL_HANDLE) {
             vkDestroyRenderPass(device->vk, renderPass, nullptr);
         }
@@ -2649,6 +3526,35 @@ namespace plume {
         return height;
     }
 
+    VkImageView VulkanFramebuffer::createSliceImageView(const VulkanTexture *texture, RenderFormat format, uint32_t mipSlice, uint32_t layerCount) {
+        assert((layerCount <= std::max(texture->desc.depth >> mipSlice, 1U)) && "Layer count exceeds the depth of the attachment.");
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = texture->vk;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+        viewInfo.format = toVk(format);
+        viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.subresourceRange.aspectMask = toViewAspectFlags(texture->desc.flags);
+        viewInfo.subresourceRange.baseMipLevel = mipSlice;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = layerCount;
+
+        VkImageView imageView = VK_NULL_HANDLE;
+        VkResult res = vkCreateImageView(device->vk, &viewInfo, nullptr, &imageView);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateImageView failed with error code 0x%X.\n", res);
+            return VK_NULL_HANDLE;
+        }
+
+        sliceImageViews.emplace_back(imageView);
+        return imageView;
+    }
+
     bool VulkanFramebuffer::contains(const VulkanTexture *attachment) const {
         assert(attachment != nullptr);
 
@@ -2737,10 +3643,11 @@ namespace plume {
 
     // VulkanCommandList
 
-    VulkanCommandList::VulkanCommandList(VulkanCommandQueue *queue) {
+    VulkanCommandList::VulkanCommandList(VulkanCommandQueue *queue, const RenderCommandListDesc &desc) {
         assert(queue != nullptr);
 
         this->queue = queue;
+        this->desc = desc;
 
         VkCommandPoolCreateInfo poolInfo = {};
         poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -2767,6 +3674,12 @@ namespace plume {
     }
 
     VulkanCommandList::~VulkanCommandList() {
+        for (SplitBarrier &splitBarrier : splitBarriers) {
+            if (splitBarrier.event != VK_NULL_HANDLE) {
+                vkDestroyEvent(queue->device->vk, splitBarrier.event, nullptr);
+            }
+        }
+
         if (vk != VK_NULL_HANDLE) {
             vkFreeCommandBuffers(queue->device->vk, commandPool, 1, &vk);
         }
@@ -2778,10 +3691,16 @@ namespace plume {
 
     void VulkanCommandList::begin() {
         vkResetCommandBuffer(vk, 0);
+        splitBarrierCount = 0;
 
         VkCommandBufferBeginInfo beginInfo = {};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (!desc.reusable) {
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        }
+        else if (desc.simultaneousUse) {
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        }
 
         VkResult res = vkBeginCommandBuffer(vk, &beginInfo);
         if (res != VK_SUCCESS) {
@@ -2791,7 +3710,10 @@ namespace plume {
     }
 
     void VulkanCommandList::end() {
+        assert(std::none_of(splitBarriers.begin(), splitBarriers.end(), [](const SplitBarrier &splitBarrier) { return splitBarrier.active; }) && "Split barriers must end before the command list.");
+
         endActiveRenderPass();
+        flushBarriers();
 
         VkResult res = vkEndCommandBuffer(vk);
         if (res != VK_SUCCESS) {
@@ -2803,6 +3725,13 @@ namespace plume {
         activeComputePipelineLayout = nullptr;
         activeGraphicsPipelineLayout = nullptr;
         activeRaytracingPipelineLayout = nullptr;
+        dynamicStateCache.validStates = RenderDynamicStateFlag::NONE;
+        graphicsShaderObjectsBound = false;
+
+        for (uint32_t i = 0; i < 3; i++) {
+            std::fill(std::begin(boundDescriptorSets[i]), std::end(boundDescriptorSets[i]), VkDescriptorSet(VK_NULL_HANDLE));
+            boundLayoutKeys[i].clear();
+        }
     }
 
     void VulkanCommandList::barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
@@ -2815,63 +3744,197 @@ namespace plume {
 
         endActiveRenderPass();
 
+        // The barriers are only queued here and issued in a single batch by the next command that depends on them. Barriers in the same batch are
+        // unordered, so a barrier on a resource that's already queued is either merged into it or issued after the queued batch is flushed.
         const bool geometryEnabled = queue->device->capabilities.geometryShader;
+        const bool meshEnabled = queue->device->capabilities.meshShader;
         const bool rtEnabled = queue->device->capabilities.raytracing;
-        VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | toStageFlags(stages, geometryEnabled, rtEnabled);
-        thread_local std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers;
-        thread_local std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
-        bufferMemoryBarriers.clear();
-        imageMemoryBarriers.clear();
-
+        const VkPipelineStageFlags dstStageMask = toStageFlags(stages, geometryEnabled, meshEnabled, rtEnabled);
         for (uint32_t i = 0; i < bufferBarriersCount; i++) {
             const RenderBufferBarrier &bufferBarrier = bufferBarriers[i];
             VulkanBuffer *interfaceBuffer = static_cast<VulkanBuffer *>(bufferBarrier.buffer);
-            VkBufferMemoryBarrier bufferMemoryBarrier = {};
-            bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            bufferMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
-            bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
-            bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferMemoryBarrier.buffer = interfaceBuffer->vk;
-            bufferMemoryBarrier.offset = 0;
-            bufferMemoryBarrier.size = interfaceBuffer->desc.size;
-            bufferMemoryBarriers.emplace_back(bufferMemoryBarrier);
-            srcStageMask |= toStageFlags(interfaceBuffer->barrierStages, geometryEnabled, rtEnabled);
-            interfaceBuffer->barrierStages = stages;
+            const bool queueTransfer = (bufferBarrier.srcQueueType != bufferBarrier.dstQueueType);
+
+            // Reads that follow reads from the same stages don't need a barrier.
+            const bool readAfterRead = (interfaceBuffer->barrierAccess == RenderBufferAccess::READ) && (bufferBarrier.accessBits == RenderBufferAccess::READ);
+            if (!queueTransfer && readAfterRead && ((stages & ~interfaceBuffer->barrierStages) == 0)) {
+                continue;
+            }
+
+            std::vector<VkBufferMemoryBarrier> &pendingBufferBarriers = pendingBarriers.bufferMemoryBarriers;
+            auto pendingIt = std::find_if(pendingBufferBarriers.begin(), pendingBufferBarriers.end(), [interfaceBuffer](const VkBufferMemoryBarrier &pendingBarrier) { return pendingBarrier.buffer == interfaceBuffer->vk; });
+            bool pendingFound = (pendingIt != pendingBufferBarriers.end());
+            if (pendingFound && (queueTransfer || (pendingIt->srcQueueFamilyIndex != pendingIt->dstQueueFamilyIndex))) {
+                flushBarriers();
+                pendingFound = false;
+            }
+
+            // Buffer barriers always cover the whole buffer with the same access masks, so a queued barrier on the same buffer already covers this one.
+            VkBufferMemoryBarrier bufferMemoryBarrier = prepareBufferBarrier(stages, bufferBarrier, pendingBarriers.srcStageMask);
+            if (!pendingFound) {
+                pendingBufferBarriers.emplace_back(bufferMemoryBarrier);
+            }
+
+            pendingBarriers.dstStageMask |= dstStageMask;
         }
 
         for (uint32_t i = 0; i < textureBarriersCount; i++) {
             const RenderTextureBarrier &textureBarrier = textureBarriers[i];
             VulkanTexture *interfaceTexture = static_cast<VulkanTexture *>(textureBarrier.texture);
-            VkImageMemoryBarrier imageMemoryBarrier = {};
-            imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            imageMemoryBarrier.image = interfaceTexture->vk;
-            imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
-            imageMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
-            imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            imageMemoryBarrier.oldLayout = toImageLayout(interfaceTexture->textureLayout);
-            imageMemoryBarrier.newLayout = toImageLayout(textureBarrier.layout);
-            imageMemoryBarrier.subresourceRange.levelCount = interfaceTexture->desc.mipLevels;
-            imageMemoryBarrier.subresourceRange.layerCount = interfaceTexture->desc.arraySize;
-            imageMemoryBarrier.subresourceRange.aspectMask = toAspectFlags(interfaceTexture->desc.format, interfaceTexture->desc.flags);
-            imageMemoryBarriers.emplace_back(imageMemoryBarrier);
-            srcStageMask |= toStageFlags(interfaceTexture->barrierStages, geometryEnabled, rtEnabled);
-            interfaceTexture->textureLayout = textureBarrier.layout;
-            interfaceTexture->barrierStages = stages;
+            const bool queueTransfer = (textureBarrier.srcQueueType != textureBarrier.dstQueueType);
+
+            // Staying in the same read-only layout for the same stages doesn't need a barrier.
+            const bool readAfterRead = (interfaceTexture->textureLayout == textureBarrier.layout) && isReadOnlyLayout(textureBarrier.layout);
+            if (!queueTransfer && readAfterRead && ((stages & ~interfaceTexture->barrierStages) == 0)) {
+                continue;
+            }
+
+            std::vector<VkImageMemoryBarrier> &pendingImageBarriers = pendingBarriers.imageMemoryBarriers;
+            auto pendingIt = std::find_if(pendingImageBarriers.begin(), pendingImageBarriers.end(), [interfaceTexture](const VkImageMemoryBarrier &pendingBarrier) { return pendingBarrier.image == interfaceTexture->vk; });
+            bool pendingFound = (pendingIt != pendingImageBarriers.end());
+            if (pendingFound && (queueTransfer || (pendingIt->srcQueueFamilyIndex != pendingIt->dstQueueFamilyIndex))) {
+                flushBarriers();
+                pendingFound = false;
+            }
+
+            // A queued transition on the same texture keeps its old layout and goes straight to the new one instead.
+            VkImageMemoryBarrier imageMemoryBarrier = prepareTextureBarrier(stages, textureBarrier, pendingBarriers.srcStageMask);
+            if (pendingFound) {
+                pendingIt->newLayout = imageMemoryBarrier.newLayout;
+            }
+            else {
+                pendingImageBarriers.emplace_back(imageMemoryBarrier);
+            }
+
+            pendingBarriers.dstStageMask |= dstStageMask;
         }
-        
-        if (bufferMemoryBarriers.empty() && imageMemoryBarriers.empty()) {
-            return;
+    }
+
+    // Both the set and the wait of a split barrier must be given the same dependency, so it's rebuilt from the barriers stored when the split began.
+    static void fillSplitDependencyInfo(const VulkanCommandList::SplitBarrier &splitBarrier, RenderScratchArray<VkBufferMemoryBarrier2KHR> &bufferMemoryBarriers,
+        RenderScratchArray<VkImageMemoryBarrier2KHR> &imageMemoryBarriers, VkDependencyInfoKHR &dependencyInfo)
+    {
+        for (const VkBufferMemoryBarrier &srcBarrier : splitBarrier.bufferMemoryBarriers) {
+            VkBufferMemoryBarrier2KHR dstBarrier = {};
+            dstBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+            dstBarrier.srcStageMask = splitBarrier.srcStageMask;
+            dstBarrier.srcAccessMask = srcBarrier.srcAccessMask;
+            dstBarrier.dstStageMask = splitBarrier.dstStageMask;
+            dstBarrier.dstAccessMask = srcBarrier.dstAccessMask;
+            dstBarrier.srcQueueFamilyIndex = srcBarrier.srcQueueFamilyIndex;
+            dstBarrier.dstQueueFamilyIndex = srcBarrier.dstQueueFamilyIndex;
+            dstBarrier.buffer = srcBarrier.buffer;
+            dstBarrier.offset = srcBarrier.offset;
+            dstBarrier.size = srcBarrier.size;
+            bufferMemoryBarriers.emplace_back(dstBarrier);
+        }
+
+        for (const VkImageMemoryBarrier &srcBarrier : splitBarrier.imageMemoryBarriers) {
+            VkImageMemoryBarrier2KHR dstBarrier = {};
+            dstBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+            dstBarrier.srcStageMask = splitBarrier.srcStageMask;
+            dstBarrier.srcAccessMask = srcBarrier.srcAccessMask;
+            dstBarrier.dstStageMask = splitBarrier.dstStageMask;
+            dstBarrier.dstAccessMask = srcBarrier.dstAccessMask;
+            dstBarrier.oldLayout = srcBarrier.oldLayout;
+            dstBarrier.newLayout = srcBarrier.newLayout;
+            dstBarrier.srcQueueFamilyIndex = srcBarrier.srcQueueFamilyIndex;
+            dstBarrier.dstQueueFamilyIndex = srcBarrier.dstQueueFamilyIndex;
+            dstBarrier.image = srcBarrier.image;
+            dstBarrier.subresourceRange = srcBarrier.subresourceRange;
+            imageMemoryBarriers.emplace_back(dstBarrier);
+        }
+
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.pBufferMemoryBarriers = bufferMemoryBarriers.data();
+        dependencyInfo.bufferMemoryBarrierCount = bufferMemoryBarriers.size();
+        dependencyInfo.pImageMemoryBarriers = imageMemoryBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = imageMemoryBarriers.size();
+    }
+
+    uint32_t VulkanCommandList::beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) {
+        assert((bufferBarriersCount == 0) || (bufferBarriers != nullptr));
+        assert((textureBarriersCount == 0) || (textureBarriers != nullptr));
+
+        endActiveRenderPass();
+        flushBarriers();
+
+        if (splitBarrierCount == splitBarriers.size()) {
+            VkEventCreateInfo eventInfo = {};
+            eventInfo.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+            SplitBarrier &newSplitBarrier = splitBarriers.emplace_back();
+            VkResult res = vkCreateEvent(queue->device->vk, &eventInfo, nullptr, &newSplitBarrier.event);
+            if (res != VK_SUCCESS) {
+                fprintf(stderr, "vkCreateEvent failed with error code 0x%X.\n", res);
+            }
+        }
+
+        const uint32_t splitIndex = splitBarrierCount++;
+        SplitBarrier &splitBarrier = splitBarriers[splitIndex];
+        const bool geometryEnabled = queue->device->capabilities.geometryShader;
+        const bool meshEnabled = queue->device->capabilities.meshShader;
+        const bool rtEnabled = queue->device->capabilities.raytracing;
+        splitBarrier.srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        splitBarrier.dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | toStageFlags(stages, geometryEnabled, meshEnabled, rtEnabled);
+        splitBarrier.bufferMemoryBarriers.clear();
+        splitBarrier.imageMemoryBarriers.clear();
+        splitBarrier.active = true;
+
+        // Without synchronization2 the transitions themselves happen when the event is waited on, so only the stages that must finish before them are recorded now.
+        for (uint32_t i = 0; i < bufferBarriersCount; i++) {
+            assert((bufferBarriers[i].srcQueueType == bufferBarriers[i].dstQueueType) && "Queue ownership transfers can't be split.");
+            splitBarrier.bufferMemoryBarriers.emplace_back(prepareBufferBarrier(stages, bufferBarriers[i], splitBarrier.srcStageMask));
         }
 
-        vkCmdPipelineBarrier(vk, srcStageMask, dstStageMask, 0, 0, nullptr, uint32_t(bufferMemoryBarriers.size()), bufferMemoryBarriers.data(), uint32_t(imageMemoryBarriers.size()), imageMemoryBarriers.data());
+        for (uint32_t i = 0; i < textureBarriersCount; i++) {
+            assert((textureBarriers[i].srcQueueType == textureBarriers[i].dstQueueType) && "Queue ownership transfers can't be split.");
+            splitBarrier.imageMemoryBarriers.emplace_back(prepareTextureBarrier(stages, textureBarriers[i], splitBarrier.srcStageMask));
+        }
+
+        if (queue->device->synchronization2Supported) {
+            RenderScratchScope scratchScope;
+            RenderScratchArray<VkBufferMemoryBarrier2KHR> bufferMemoryBarriers;
+            RenderScratchArray<VkImageMemoryBarrier2KHR> imageMemoryBarriers;
+            VkDependencyInfoKHR dependencyInfo = {};
+            fillSplitDependencyInfo(splitBarrier, bufferMemoryBarriers, imageMemoryBarriers, dependencyInfo);
+            vkCmdSetEvent2KHR(vk, splitBarrier.event, &dependencyInfo);
+        }
+        else {
+            vkCmdSetEvent(vk, splitBarrier.event, splitBarrier.srcStageMask);
+        }
+
+        return splitIndex;
+    }
+
+    void VulkanCommandList::endSplitBarriers(uint32_t splitIndex) {
+        assert((splitIndex < splitBarrierCount) && splitBarriers[splitIndex].active && "Split barriers must have begun in the same command list.");
+
+        endActiveRenderPass();
+        flushBarriers();
+
+        // The event is reset after the wait so the next submission of the command list doesn't see the signal from this one.
+        SplitBarrier &splitBarrier = splitBarriers[splitIndex];
+        if (queue->device->synchronization2Supported) {
+            RenderScratchScope scratchScope;
+            RenderScratchArray<VkBufferMemoryBarrier2KHR> bufferMemoryBarriers;
+            RenderScratchArray<VkImageMemoryBarrier2KHR> imageMemoryBarriers;
+            VkDependencyInfoKHR dependencyInfo = {};
+            fillSplitDependencyInfo(splitBarrier, bufferMemoryBarriers, imageMemoryBarriers, dependencyInfo);
+            vkCmdWaitEvents2KHR(vk, 1, &splitBarrier.event, &dependencyInfo);
+            vkCmdResetEvent2KHR(vk, splitBarrier.event, splitBarrier.dstStageMask);
+        }
+        else {
+            vkCmdWaitEvents(vk, 1, &splitBarrier.event, splitBarrier.srcStageMask, splitBarrier.dstStageMask, 0, nullptr, uint32_t(splitBarrier.bufferMemoryBarriers.size()), splitBarrier.bufferMemoryBarriers.data(), uint32_t(splitBarrier.imageMemoryBarriers.size()), splitBarrier.imageMemoryBarriers.data());
+            vkCmdResetEvent(vk, splitBarrier.event, splitBarrier.dstStageMask);
+        }
+        splitBarrier.active = false;
     }
 
     void VulkanCommandList::dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) {
         assert(activeComputePipelineLayout != nullptr);
 
+        flushBarriers();
         vkCmdDispatch(vk, threadGroupCountX, threadGroupCountY, threadGroupCountZ);
     }
 
@@ -2906,6 +3969,7 @@ namespace plume {
         callableSbt.deviceAddress = (callable.size > 0) ? (tableAddress + callable.offset + callable.startIndex * callable.stride) : 0;
         callableSbt.size = callable.size;
         callableSbt.stride = callable.stride;
+        flushBarriers();
         vkCmdTraceRaysKHR(vk, &rayGenSbt, &missSbt, &hitSbt, &callableSbt, width, height, depth);
     }
 
@@ -2923,6 +3987,25 @@ namespace plume {
         vkCmdDrawIndexed(vk, indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
     }
 
+    void VulkanCommandList::drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        assert(queue->device->capabilities.meshShader && "Mesh shaders are unsupported on this device.");
+        assert(activeGraphicsPipelineLayout != nullptr);
+        checkActiveRenderPass();
+
+        vkCmdDrawMeshTasksEXT(vk, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void VulkanCommandList::drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount, uint32_t stride) {
+        const VulkanBuffer *interfaceBuffer = static_cast<const VulkanBuffer *>(argumentBuffer.ref);
+        assert(queue->device->capabilities.meshShader && "Mesh shaders are unsupported on this device.");
+        assert(interfaceBuffer != nullptr);
+        assert((interfaceBuffer->desc.flags & RenderBufferFlag::INDIRECT) && "Buffer must allow being used as an indirect argument buffer.");
+        assert(activeGraphicsPipelineLayout != nullptr);
+        checkActiveRenderPass();
+
+        vkCmdDrawMeshTasksIndirectEXT(vk, interfaceBuffer->vk, argumentBuffer.offset, drawCount, stride);
+    }
+
     void VulkanCommandList::setPipeline(const RenderPipeline *pipeline) {
         assert(pipeline != nullptr);
 
@@ -2936,6 +4019,10 @@ namespace plume {
         case VulkanPipeline::Type::Graphics: {
             const VulkanGraphicsPipeline *graphicsPipeline = static_cast<const VulkanGraphicsPipeline *>(interfacePipeline);
             vkCmdBindPipeline(vk, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline->vk);
+
+            // Binding a pipeline with static state invalidates the values that were set dynamically.
+            dynamicStateCache.validStates &= graphicsPipeline->dynamicStates;
+            graphicsShaderObjectsBound = false;
             break;
         }
         case VulkanPipeline::Type::Raytracing: {
@@ -2978,7 +4065,7 @@ namespace plume {
         assert(rangeIndex < activeGraphicsPipelineLayout->pushConstantRanges.size());
 
         const VkPushConstantRange &range = activeGraphicsPipelineLayout->pushConstantRanges[rangeIndex];
-        vkCmdPushConstants(vk, activeGraphicsPipelineLayout->vk, range.stageFlags & VK_SHADER_STAGE_ALL_GRAPHICS, range.offset + offset, size == 0 ? range.size : size, data);
+        vkCmdPushConstants(vk, activeGraphicsPipelineLayout->vk, range.stageFlags & (VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT), range.offset + offset, size == 0 ? range.size : size, data);
     }
 
     void VulkanCommandList::setGraphicsDescriptorSet(RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
@@ -3019,13 +4106,14 @@ namespace plume {
 
     void VulkanCommandList::setVertexBuffers(uint32_t startSlot, const RenderVertexBufferView *views, uint32_t viewCount, const RenderInputSlot *inputSlots) {
         if ((views != nullptr) && (viewCount > 0)) {
-            // Input slots aren't actually used by Vulkan as the stride is baked into the pipeline, but we validate it for the sake of consistency with D3D12.
+            // Input slots are only used by Vulkan when the device supports dynamic strides. Otherwise the stride is baked into the pipeline, but we validate it for the sake of consistency with D3D12.
             assert(inputSlots != nullptr);
 
-            thread_local std::vector<VkBuffer> bufferVector;
-            thread_local std::vector<VkDeviceSize> offsetVector;
-            bufferVector.clear();
-            offsetVector.clear();
+            const bool dynamicStrides = (queue->device->capabilities.dynamicStates & RenderDynamicStateFlag::VERTEX_BUFFER_STRIDE);
+            RenderScratchScope scratchScope;
+            RenderScratchArray<VkBuffer> bufferVector;
+            RenderScratchArray<VkDeviceSize> offsetVector;
+            RenderScratchArray<VkDeviceSize> strideVector;
             for (uint32_t i = 0; i < viewCount; i++) {
                 const VulkanBuffer *interfaceBuffer = static_cast<const VulkanBuffer *>(views[i].buffer.ref);
                 if ((interfaceBuffer == nullptr) && !queue->device->nullDescriptorSupported) {
@@ -3034,71 +4122,430 @@ namespace plume {
 
                 bufferVector.emplace_back((interfaceBuffer != nullptr) ? interfaceBuffer->vk : VK_NULL_HANDLE);
                 offsetVector.emplace_back(views[i].buffer.offset);
+
+                if (dynamicStrides) {
+                    bool slotFound = false;
+                    for (uint32_t j = 0; j < viewCount; j++) {
+                        if (inputSlots[j].index == (startSlot + i)) {
+                            strideVector.emplace_back(inputSlots[j].stride);
+                            slotFound = true;
+                            break;
+                        }
+                    }
+
+                    assert(slotFound && "Input slots must contain a slot with the same index as the view.");
+                    if (!slotFound) {
+                        strideVector.emplace_back(0);
+                    }
+                }
+            }
+
+            if (dynamicStrides) {
+                vkCmdBindVertexBuffers2EXT(vk, startSlot, viewCount, bufferVector.data(), offsetVector.data(), nullptr, strideVector.data());
+            }
+            else {
+                vkCmdBindVertexBuffers(vk, startSlot, viewCount, bufferVector.data(), offsetVector.data());
+            }
+        }
+    }
+
+    void VulkanCommandList::setViewports(const RenderViewport *viewports, uint32_t count) {
+        if (count > 1) {
+            RenderScratchScope scratchScope;
+            RenderScratchArray<VkViewport> viewportVector;
+
+            for (uint32_t i = 0; i < count; i++) {
+                viewportVector.emplace_back(VkViewport{ viewports[i].x, viewports[i].y, viewports[i].width, viewports[i].height, viewports[i].minDepth, viewports[i].maxDepth });
+            }
+
+            if (!viewportVector.empty()) {
+                if (graphicsShaderObjectsBound) {
+                    vkCmdSetViewportWithCountEXT(vk, uint32_t(viewportVector.size()), viewportVector.data());
+                }
+                else {
+                    vkCmdSetViewport(vk, 0, uint32_t(viewportVector.size()), viewportVector.data());
+                }
+            }
+        }
+        else {
+            // Single element fast path.
+            VkViewport viewport = VkViewport{ viewports[0].x, viewports[0].y, viewports[0].width, viewports[0].height, viewports[0].minDepth, viewports[0].maxDepth };
+            if (graphicsShaderObjectsBound) {
+                vkCmdSetViewportWithCountEXT(vk, 1, &viewport);
+            }
+            else {
+                vkCmdSetViewport(vk, 0, 1, &viewport);
+            }
+        }
+    }
+
+    void VulkanCommandList::setScissors(const RenderRect *scissorRects, uint32_t count) {
+        if (count > 1) {
+            RenderScratchScope scratchScope;
+            RenderScratchArray<VkRect2D> scissorVector;
+
+            for (uint32_t i = 0; i < count; i++) {
+                scissorVector.emplace_back(VkRect2D{ VkOffset2D{ scissorRects[i].left, scissorRects[i].top }, VkExtent2D{ uint32_t(scissorRects[i].right - scissorRects[i].left), uint32_t(scissorRects[i].bottom - scissorRects[i].top) } });
+            }
+
+            if (!scissorVector.empty()) {
+                if (graphicsShaderObjectsBound) {
+                    vkCmdSetScissorWithCountEXT(vk, uint32_t(scissorVector.size()), scissorVector.data());
+                }
+                else {
+                    vkCmdSetScissor(vk, 0, uint32_t(scissorVector.size()), scissorVector.data());
+                }
             }
+        }
+        else {
+            // Single element fast path.
+            VkRect2D scissor = VkRect2D{ VkOffset2D{ scissorRects[0].left, scissorRects[0].top }, VkExtent2D{ uint32_t(scissorRects[0].right - scissorRects[0].left), uint32_t(scissorRects[0].bottom - scissorRects[0].top) } };
+            if (graphicsShaderObjectsBound) {
+                vkCmdSetScissorWithCountEXT(vk, 1, &scissor);
+            }
+            else {
+                vkCmdSetScissor(vk, 0, 1, &scissor);
+            }
+        }
+    }
+
+    void VulkanCommandList::setFramebuffer(const RenderFramebuffer *framebuffer) {
+        endActiveRenderPass();
+
+        if (framebuffer != nullptr) {
+            const VulkanFramebuffer *interfaceFramebuffer = static_cast<const VulkanFramebuffer *>(framebuffer);
+            targetFramebuffer = interfaceFramebuffer;
+        }
+        else {
+            targetFramebuffer = nullptr;
+        }
+    }
+
+    void VulkanCommandList::setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) {
+        vkCmdSetDepthBias(vk, depthBias, depthBiasClamp, slopeScaledDepthBias);
+    }
+
+    void VulkanCommandList::setCullMode(RenderCullMode cullMode) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::CULL_MODE) && "Dynamic cull mode is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::CULL_MODE) || (dynamicStateCache.cullMode != cullMode)) {
+            vkCmdSetCullModeEXT(vk, toVk(cullMode));
+            dynamicStateCache.cullMode = cullMode;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::CULL_MODE;
+        }
+    }
+
+    void VulkanCommandList::setFrontFace(RenderFrontFace frontFace) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::FRONT_FACE) && "Dynamic front face is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::FRONT_FACE) || (dynamicStateCache.frontFace != frontFace)) {
+            vkCmdSetFrontFaceEXT(vk, toVk(frontFace));
+            dynamicStateCache.frontFace = frontFace;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::FRONT_FACE;
+        }
+    }
+
+    void VulkanCommandList::setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY) && "Dynamic primitive topology is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY) || (dynamicStateCache.primitiveTopology != primitiveTopology)) {
+            vkCmdSetPrimitiveTopologyEXT(vk, toVk(primitiveTopology));
+            dynamicStateCache.primitiveTopology = primitiveTopology;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY;
+        }
+    }
+
+    void VulkanCommandList::setDepthEnabled(bool depthEnabled) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::DEPTH_ENABLED) && "Dynamic depth test is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::DEPTH_ENABLED) || (dynamicStateCache.depthEnabled != depthEnabled)) {
+            vkCmdSetDepthTestEnableEXT(vk, depthEnabled);
+            dynamicStateCache.depthEnabled = depthEnabled;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::DEPTH_ENABLED;
+        }
+    }
+
+    void VulkanCommandList::setDepthWriteEnabled(bool depthWriteEnabled) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::DEPTH_WRITE_ENABLED) && "Dynamic depth write is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::DEPTH_WRITE_ENABLED) || (dynamicStateCache.depthWriteEnabled != depthWriteEnabled)) {
+            vkCmdSetDepthWriteEnableEXT(vk, depthWriteEnabled);
+            dynamicStateCache.depthWriteEnabled = depthWriteEnabled;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::DEPTH_WRITE_ENABLED;
+        }
+    }
+
+    void VulkanCommandList::setDepthFunction(RenderComparisonFunction depthFunction) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::DEPTH_FUNCTION) && "Dynamic depth function is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::DEPTH_FUNCTION) || (dynamicStateCache.depthFunction != depthFunction)) {
+            vkCmdSetDepthCompareOpEXT(vk, toVk(depthFunction));
+            dynamicStateCache.depthFunction = depthFunction;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::DEPTH_FUNCTION;
+        }
+    }
+
+    void VulkanCommandList::setStencilEnabled(bool stencilEnabled) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::STENCIL_ENABLED) && "Dynamic stencil test is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::STENCIL_ENABLED) || (dynamicStateCache.stencilEnabled != stencilEnabled)) {
+            vkCmdSetStencilTestEnableEXT(vk, stencilEnabled);
+            dynamicStateCache.stencilEnabled = stencilEnabled;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::STENCIL_ENABLED;
+        }
+    }
+
+    void VulkanCommandList::setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::STENCIL_FACES) && "Dynamic stencil operations are unsupported on this device.");
+
+        const bool cacheValid = (dynamicStateCache.validStates & RenderDynamicStateFlag::STENCIL_FACES);
+        if (!cacheValid || (dynamicStateCache.stencilFrontFace != stencilFrontFace)) {
+            vkCmdSetStencilOpEXT(vk, VK_STENCIL_FACE_FRONT_BIT, toVk(stencilFrontFace.failOp), toVk(stencilFrontFace.passOp), toVk(stencilFrontFace.depthFailOp), toVk(stencilFrontFace.compareFunction));
+            dynamicStateCache.stencilFrontFace = stencilFrontFace;
+        }
+
+        if (!cacheValid || (dynamicStateCache.stencilBackFace != stencilBackFace)) {
+            vkCmdSetStencilOpEXT(vk, VK_STENCIL_FACE_BACK_BIT, toVk(stencilBackFace.failOp), toVk(stencilBackFace.passOp), toVk(stencilBackFace.depthFailOp), toVk(stencilBackFace.compareFunction));
+            dynamicStateCache.stencilBackFace = stencilBackFace;
+        }
+
+        dynamicStateCache.validStates |= RenderDynamicStateFlag::STENCIL_FACES;
+    }
+
+    void VulkanCommandList::setStencilReference(uint32_t stencilReference) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::STENCIL_REFERENCE) && "Dynamic stencil reference is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::STENCIL_REFERENCE) || (dynamicStateCache.stencilReference != stencilReference)) {
+            vkCmdSetStencilReference(vk, VK_STENCIL_FACE_FRONT_AND_BACK, stencilReference);
+            dynamicStateCache.stencilReference = stencilReference;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::STENCIL_REFERENCE;
+        }
+    }
+
+    void VulkanCommandList::setDepthBiasEnabled(bool depthBiasEnabled) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::DEPTH_BIAS_ENABLED) && "Dynamic depth bias toggling is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::DEPTH_BIAS_ENABLED) || (dynamicStateCache.depthBiasEnabled != depthBiasEnabled)) {
+            vkCmdSetDepthBiasEnableEXT(vk, depthBiasEnabled);
+            dynamicStateCache.depthBiasEnabled = depthBiasEnabled;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::DEPTH_BIAS_ENABLED;
+        }
+    }
+
+    void VulkanCommandList::setDepthClipEnabled(bool depthClipEnabled) {
+        assert(isDynamicStateSupported(RenderDynamicStateFlag::DEPTH_CLIP_ENABLED) && "Dynamic depth clip is unsupported on this device.");
+
+        if (!(dynamicStateCache.validStates & RenderDynamicStateFlag::DEPTH_CLIP_ENABLED) || (dynamicStateCache.depthClipEnabled != depthClipEnabled)) {
+            vkCmdSetDepthClampEnableEXT(vk, !depthClipEnabled);
+            dynamicStateCache.depthClipEnabled = depthClipEnabled;
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::DEPTH_CLIP_ENABLED;
+        }
+    }
+
+    bool VulkanCommandList::setVertexInput(const RenderInputSlot *inputSlots, uint32_t inputSlotsCount, const RenderInputElement *inputElements, uint32_t inputElementsCount) {
+        if (!isDynamicStateSupported(RenderDynamicStateFlag::VERTEX_INPUT)) {
+            assert(false && "Dynamic vertex input is unsupported on this device.");
+            return false;
+        }
+        assert((inputSlotsCount == 0) || (inputSlots != nullptr));
+        assert((inputElementsCount == 0) || (inputElements != nullptr));
+
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkVertexInputBindingDescription2EXT> vertexBindings;
+        RenderScratchArray<VkVertexInputAttributeDescription2EXT> vertexAttributes;
+
+        for (uint32_t i = 0; i < inputSlotsCount; i++) {
+            const RenderInputSlot &inputSlot = inputSlots[i];
+            VkVertexInputBindingDescription2EXT binding = {};
+            binding.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+            binding.binding = inputSlot.index;
+            binding.stride = inputSlot.stride;
+            binding.inputRate = toVk(inputSlot.classification);
+            binding.divisor = 1;
+            vertexBindings.emplace_back(binding);
+        }
+
+        for (uint32_t i = 0; i < inputElementsCount; i++) {
+            const RenderInputElement &inputElement = inputElements[i];
+            VkVertexInputAttributeDescription2EXT attribute = {};
+            attribute.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+            attribute.location = inputElement.location;
+            attribute.binding = inputElement.slotIndex;
+            attribute.format = toVk(inputElement.format);
+            attribute.offset = inputElement.alignedByteOffset;
+            vertexAttributes.emplace_back(attribute);
+        }
+
+        auto bindingsEqual = [](const VkVertexInputBindingDescription2EXT &a, const VkVertexInputBindingDescription2EXT &b) {
+            return (a.binding == b.binding) && (a.stride == b.stride) && (a.inputRate == b.inputRate) && (a.divisor == b.divisor);
+        };
+
+        auto attributesEqual = [](const VkVertexInputAttributeDescription2EXT &a, const VkVertexInputAttributeDescription2EXT &b) {
+            return (a.location == b.location) && (a.binding == b.binding) && (a.format == b.format) && (a.offset == b.offset);
+        };
+
+        const bool cacheValid = (dynamicStateCache.validStates & RenderDynamicStateFlag::VERTEX_INPUT);
+        const std::vector<VkVertexInputBindingDescription2EXT> &cachedBindings = dynamicStateCache.vertexBindings;
+        const std::vector<VkVertexInputAttributeDescription2EXT> &cachedAttributes = dynamicStateCache.vertexAttributes;
+        const bool bindingsChanged = (cachedBindings.size() != vertexBindings.size()) || !std::equal(vertexBindings.begin(), vertexBindings.end(), cachedBindings.begin(), bindingsEqual);
+        const bool attributesChanged = (cachedAttributes.size() != vertexAttributes.size()) || !std::equal(vertexAttributes.begin(), vertexAttributes.end(), cachedAttributes.begin(), attributesEqual);
+        if (!cacheValid || bindingsChanged || attributesChanged) {
+            vkCmdSetVertexInputEXT(vk, uint32_t(vertexBindings.size()), vertexBindings.data(), uint32_t(vertexAttributes.size()), vertexAttributes.data());
+            dynamicStateCache.vertexBindings.assign(vertexBindings.begin(), vertexBindings.end());
+            dynamicStateCache.vertexAttributes.assign(vertexAttributes.begin(), vertexAttributes.end());
+            dynamicStateCache.validStates |= RenderDynamicStateFlag::VERTEX_INPUT;
+        }
+
+        return true;
+    }
+
+    void VulkanCommandList::setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) {
+        assert(queue->device->capabilities.shaderObjects && "Shader objects are unsupported on this device.");
+        assert((geometryShader == nullptr) || queue->device->enabledFeatures.geometryShader);
+
+        // Every graphics stage enabled on the device must be bound, so the unused stages are bound to null shaders.
+        const VkPhysicalDeviceFeatures &enabledFeatures = queue->device->enabledFeatures;
+        VkShaderStageFlagBits stages[7];
+        VkShaderEXT shaders[7];
+        uint32_t stageCount = 0;
+        auto addStage = [&](VkShaderStageFlagBits stage, const RenderShaderObject *shaderObject) {
+            const VulkanShaderObject *interfaceShaderObject = static_cast<const VulkanShaderObject *>(shaderObject);
+            assert((interfaceShaderObject == nullptr) || (interfaceShaderObject->stage == stage));
+            stages[stageCount] = stage;
+            shaders[stageCount] = (interfaceShaderObject != nullptr) ? interfaceShaderObject->vk : VK_NULL_HANDLE;
+            stageCount++;
+        };
+
+        addStage(VK_SHADER_STAGE_VERTEX_BIT, vertexShader);
+        addStage(VK_SHADER_STAGE_FRAGMENT_BIT, pixelShader);
+
+        if (enabledFeatures.geometryShader) {
+            addStage(VK_SHADER_STAGE_GEOMETRY_BIT, geometryShader);
+        }
+
+        if (enabledFeatures.tessellationShader) {
+            addStage(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, nullptr);
+            addStage(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, nullptr);
+        }
 
-            vkCmdBindVertexBuffers(vk, startSlot, viewCount, bufferVector.data(), offsetVector.data());
+        if (queue->device->capabilities.meshShader) {
+            addStage(VK_SHADER_STAGE_TASK_BIT_EXT, nullptr);
+            addStage(VK_SHADER_STAGE_MESH_BIT_EXT, nullptr);
         }
+
+        vkCmdBindShadersEXT(vk, stageCount, stages, shaders);
+        graphicsShaderObjectsBound = true;
+    }
+
+    void VulkanCommandList::setComputeShaderObject(const RenderShaderObject *computeShader) {
+        assert(queue->device->capabilities.shaderObjects && "Shader objects are unsupported on this device.");
+        assert(computeShader != nullptr);
+
+        const VulkanShaderObject *interfaceShaderObject = static_cast<const VulkanShaderObject *>(computeShader);
+        assert(interfaceShaderObject->stage == VK_SHADER_STAGE_COMPUTE_BIT);
+
+        const VkShaderStageFlagBits stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        vkCmdBindShadersEXT(vk, 1, &stage, &interfaceShaderObject->vk);
     }
 
-    void VulkanCommandList::setViewports(const RenderViewport *viewports, uint32_t count) {
-        if (count > 1) {
-            thread_local std::vector<VkViewport> viewportVector;
-            viewportVector.clear();
+    void VulkanCommandList::setShaderObjectState(const RenderGraphicsPipelineDesc &desc) {
+        assert(queue->device->capabilities.shaderObjects && "Shader objects are unsupported on this device.");
+        assert(desc.renderTargetCount <= RenderGraphicsPipelineDesc::MaxRenderTargets);
+
+        // Mirrors the state VulkanGraphicsPipeline builds from the same description.
+        const VkPhysicalDeviceFeatures &enabledFeatures = queue->device->enabledFeatures;
+        const bool primitiveRestartEnabled = (desc.primitiveTopology == RenderPrimitiveTopology::LINE_STRIP) || (desc.primitiveTopology == RenderPrimitiveTopology::TRIANGLE_STRIP);
+        vkCmdSetRasterizerDiscardEnableEXT(vk, VK_FALSE);
+        vkCmdSetPolygonModeEXT(vk, VK_POLYGON_MODE_FILL);
+        vkCmdSetLineWidth(vk, 1.0f);
+        vkCmdSetPrimitiveRestartEnableEXT(vk, primitiveRestartEnabled);
+        setPrimitiveTopology(desc.primitiveTopology);
+        setCullMode(desc.cullMode);
+        setFrontFace(desc.frontFace);
+        setVertexInput(desc.inputSlots, desc.inputSlotsCount, desc.inputElements, desc.inputElementsCount);
+
+        if (enabledFeatures.depthClamp) {
+            setDepthClipEnabled(desc.depthClipEnabled);
+        }
 
-            for (uint32_t i = 0; i < count; i++) {
-                viewportVector.emplace_back(VkViewport{ viewports[i].x, viewports[i].y, viewports[i].width, viewports[i].height, viewports[i].minDepth, viewports[i].maxDepth });
-            }
+        const bool staticDepthBias = (desc.depthBias != 0) || (desc.depthBiasClamp != 0.0f) || (desc.slopeScaledDepthBias != 0.0f);
+        setDepthBiasEnabled(desc.dynamicDepthBiasEnabled || staticDepthBias);
+        if (!desc.dynamicDepthBiasEnabled && staticDepthBias) {
+            vkCmdSetDepthBias(vk, float(desc.depthBias), desc.depthBiasClamp, desc.slopeScaledDepthBias);
+        }
 
-            if (!viewportVector.empty()) {
-                vkCmdSetViewport(vk, 0, uint32_t(viewportVector.size()), viewportVector.data());
-            }
+        setDepthEnabled(desc.depthEnabled);
+        setDepthWriteEnabled(desc.depthWriteEnabled);
+        setDepthFunction(desc.depthFunction);
+        if (enabledFeatures.depthBounds) {
+            vkCmdSetDepthBoundsTestEnableEXT(vk, VK_FALSE);
         }
-        else {
-            // Single element fast path.
-            VkViewport viewport = VkViewport{ viewports[0].x, viewports[0].y, viewports[0].width, viewports[0].height, viewports[0].minDepth, viewports[0].maxDepth };
-            vkCmdSetViewport(vk, 0, 1, &viewport);
+
+        setStencilEnabled(desc.stencilEnabled);
+        if (desc.stencilEnabled) {
+            setStencilFaces(desc.stencilFrontFace, desc.stencilBackFace);
+            setStencilReference(desc.stencilReference);
+            vkCmdSetStencilCompareMask(vk, VK_STENCIL_FACE_FRONT_AND_BACK, desc.stencilReadMask);
+            vkCmdSetStencilWriteMask(vk, VK_STENCIL_FACE_FRONT_AND_BACK, desc.stencilWriteMask);
         }
-    }
 
-    void VulkanCommandList::setScissors(const RenderRect *scissorRects, uint32_t count) {
-        if (count > 1) {
-            thread_local std::vector<VkRect2D> scissorVector;
-            scissorVector.clear();
+        // The sample mask covers the maximum amount of samples a pixel can have.
+        const VkSampleCountFlagBits sampleCount = VkSampleCountFlagBits(desc.multisampling.sampleCount);
+        const VkSampleMask sampleMask[2] = { 0xFFFFFFFFU, 0xFFFFFFFFU };
+        vkCmdSetRasterizationSamplesEXT(vk, sampleCount);
+        vkCmdSetSampleMaskEXT(vk, sampleCount, sampleMask);
+        vkCmdSetAlphaToCoverageEnableEXT(vk, desc.alphaToCoverageEnabled);
+        if (enabledFeatures.alphaToOne) {
+            vkCmdSetAlphaToOneEnableEXT(vk, VK_FALSE);
+        }
 
-            for (uint32_t i = 0; i < count; i++) {
-                scissorVector.emplace_back(VkRect2D{ VkOffset2D{ scissorRects[i].left, scissorRects[i].top }, VkExtent2D{ uint32_t(scissorRects[i].right - scissorRects[i].left), uint32_t(scissorRects[i].bottom - scissorRects[i].top) } });
+        if (queue->device->capabilities.sampleLocations) {
+            vkCmdSetSampleLocationsEnableEXT(vk, desc.multisampling.sampleLocationsEnabled);
+            if (desc.multisampling.sampleLocationsEnabled) {
+                VkSampleLocationEXT sampleLocations[RenderMultisampling::MaxSampleLocations];
+                VkSampleLocationsInfoEXT sampleLocationsInfo = {};
+                fillSampleLocations(queue->device, desc.multisampling, sampleLocations, sampleLocationsInfo);
+                vkCmdSetSampleLocationsEXT(vk, &sampleLocationsInfo);
             }
+        }
 
-            if (!scissorVector.empty()) {
-                vkCmdSetScissor(vk, 0, uint32_t(scissorVector.size()), scissorVector.data());
+        if (enabledFeatures.logicOp) {
+            vkCmdSetLogicOpEnableEXT(vk, desc.logicOpEnabled);
+            if (desc.logicOpEnabled) {
+                vkCmdSetLogicOpEXT(vk, toVk(desc.logicOp));
             }
         }
-        else {
-            // Single element fast path.
-            VkRect2D scissor = VkRect2D{ VkOffset2D{ scissorRects[0].left, scissorRects[0].top }, VkExtent2D{ uint32_t(scissorRects[0].right - scissorRects[0].left), uint32_t(scissorRects[0].bottom - scissorRects[0].top) } };
-            vkCmdSetScissor(vk, 0, 1, &scissor);
-        }
-    }
 
-    void VulkanCommandList::setFramebuffer(const RenderFramebuffer *framebuffer) {
-        endActiveRenderPass();
+        if (desc.renderTargetCount > 0) {
+            VkBool32 blendEnables[RenderGraphicsPipelineDesc::MaxRenderTargets] = {};
+            VkColorComponentFlags writeMasks[RenderGraphicsPipelineDesc::MaxRenderTargets] = {};
+            for (uint32_t i = 0; i < desc.renderTargetCount; i++) {
+                const RenderBlendDesc &blendDesc = desc.renderTargetBlend[i];
+                blendEnables[i] = blendDesc.blendEnabled;
+                writeMasks[i] = blendDesc.renderTargetWriteMask;
+
+                // The equation is only required for the attachments with blending enabled.
+                if (blendDesc.blendEnabled) {
+                    VkColorBlendEquationEXT equation = {};
+                    equation.srcColorBlendFactor = toVk(blendDesc.srcBlend);
+                    equation.dstColorBlendFactor = toVk(blendDesc.dstBlend);
+                    equation.colorBlendOp = toVk(blendDesc.blendOp);
+                    equation.srcAlphaBlendFactor = toVk(blendDesc.srcBlendAlpha);
+                    equation.dstAlphaBlendFactor = toVk(blendDesc.dstBlendAlpha);
+                    equation.alphaBlendOp = toVk(blendDesc.blendOpAlpha);
+                    vkCmdSetColorBlendEquationEXT(vk, i, 1, &equation);
+                }
+            }
 
-        if (framebuffer != nullptr) {
-            const VulkanFramebuffer *interfaceFramebuffer = static_cast<const VulkanFramebuffer *>(framebuffer);
-            targetFramebuffer = interfaceFramebuffer;
-        }
-        else {
-            targetFramebuffer = nullptr;
+            const float blendConstants[4] = {};
+            vkCmdSetColorBlendEnableEXT(vk, 0, desc.renderTargetCount, blendEnables);
+            vkCmdSetColorWriteMaskEXT(vk, 0, desc.renderTargetCount, writeMasks);
+            vkCmdSetBlendConstants(vk, blendConstants);
         }
     }
 
-    void VulkanCommandList::setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) {
-        vkCmdSetDepthBias(vk, depthBias, depthBiasClamp, slopeScaledDepthBias);
-    }
-
-    static void clearCommonRectVector(uint32_t width, uint32_t height, const RenderRect *clearRects, uint32_t clearRectsCount, std::vector<VkClearRect> &rectVector) {
-        rectVector.clear();
-
+    // Clears every layer of a layered framebuffer. Multiview clears the views in the view mask instead and requires a single layer.
+    static void clearCommonRectVector(uint32_t width, uint32_t height, uint32_t layerCount, const RenderRect *clearRects, uint32_t clearRectsCount, RenderScratchArray<VkClearRect> &rectVector) {
         if (clearRectsCount > 0) {
             for (uint32_t i = 0; i < clearRectsCount; i++) {
                 VkClearRect clearRect;
@@ -3107,7 +4554,7 @@ namespace plume {
                 clearRect.rect.extent.width = clearRects[i].right - clearRects[i].left;
                 clearRect.rect.extent.height = clearRects[i].bottom - clearRects[i].top;
                 clearRect.baseArrayLayer = 0;
-                clearRect.layerCount = 1;
+                clearRect.layerCount = layerCount;
                 rectVector.emplace_back(clearRect);
             }
         }
@@ -3118,7 +4565,7 @@ namespace plume {
             clearRect.rect.extent.width = width;
             clearRect.rect.extent.height = height;
             clearRect.baseArrayLayer = 0;
-            clearRect.layerCount = 1;
+            clearRect.layerCount = layerCount;
             rectVector.emplace_back(clearRect);
         }
     }
@@ -3130,8 +4577,10 @@ namespace plume {
 
         checkActiveRenderPass();
 
-        thread_local std::vector<VkClearRect> rectVector;
-        clearCommonRectVector(targetFramebuffer->getWidth(), targetFramebuffer->getHeight(), clearRects, clearRectsCount, rectVector);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkClearRect> rectVector;
+        const uint32_t clearLayerCount = (targetFramebuffer->viewMask != 0) ? 1 : targetFramebuffer->layerCount;
+        clearCommonRectVector(targetFramebuffer->getWidth(), targetFramebuffer->getHeight(), clearLayerCount, clearRects, clearRectsCount, rectVector);
 
         VkClearAttachment attachment = {};
         auto &rgba = attachment.clearValue.color.float32;
@@ -3150,8 +4599,10 @@ namespace plume {
 
         checkActiveRenderPass();
 
-        thread_local std::vector<VkClearRect> rectVector;
-        clearCommonRectVector(targetFramebuffer->getWidth(), targetFramebuffer->getHeight(), clearRects, clearRectsCount, rectVector);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkClearRect> rectVector;
+        const uint32_t clearLayerCount = (targetFramebuffer->viewMask != 0) ? 1 : targetFramebuffer->layerCount;
+        clearCommonRectVector(targetFramebuffer->getWidth(), targetFramebuffer->getHeight(), clearLayerCount, clearRects, clearRectsCount, rectVector);
 
         VkClearAttachment attachment = {};
         attachment.clearValue.depthStencil.depth = depthValue;
@@ -3169,6 +4620,7 @@ namespace plume {
 
     void VulkanCommandList::copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) {
         endActiveRenderPass();
+        flushBarriers();
 
         assert(dstBuffer.ref != nullptr);
         assert(srcBuffer.ref != nullptr);
@@ -3184,6 +4636,7 @@ namespace plume {
 
     void VulkanCommandList::copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX, uint32_t dstY, uint32_t dstZ, const RenderBox *srcBox) {
         endActiveRenderPass();
+        flushBarriers();
         
         assert(dstLocation.type != RenderTextureCopyType::UNKNOWN);
         assert(srcLocation.type != RenderTextureCopyType::UNKNOWN);
@@ -3197,10 +4650,11 @@ namespace plume {
             assert(srcBuffer != nullptr);
 
             const uint32_t blockWidth = RenderFormatBlockWidth(dstTexture->desc.format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(dstTexture->desc.format);
             VkBufferImageCopy imageCopy = {};
             imageCopy.bufferOffset = srcLocation.placedFootprint.offset;
             imageCopy.bufferRowLength = ((srcLocation.placedFootprint.rowWidth + blockWidth - 1) / blockWidth) * blockWidth;
-            imageCopy.bufferImageHeight = ((srcLocation.placedFootprint.height + blockWidth - 1) / blockWidth) * blockWidth;
+            imageCopy.bufferImageHeight = ((srcLocation.placedFootprint.height + blockHeight - 1) / blockHeight) * blockHeight;
             imageCopy.imageSubresource.aspectMask = toAspectFlags(dstTexture->desc.format, dstTexture->desc.flags);
             imageCopy.imageSubresource.baseArrayLayer = dstLocation.subresource.arrayIndex;
             imageCopy.imageSubresource.layerCount = 1;
@@ -3213,6 +4667,38 @@ namespace plume {
             imageCopy.imageExtent.depth = srcLocation.placedFootprint.depth;
             vkCmdCopyBufferToImage(vk, srcBuffer->vk, dstTexture->vk, toImageLayout(dstTexture->textureLayout), 1, &imageCopy);
         }
+        else if ((dstLocation.type == RenderTextureCopyType::PLACED_FOOTPRINT) && (srcLocation.type == RenderTextureCopyType::SUBRESOURCE)) {
+            assert(dstBuffer != nullptr);
+            assert(srcTexture != nullptr);
+
+            const uint32_t blockWidth = RenderFormatBlockWidth(srcTexture->desc.format);
+            const uint32_t blockHeight = RenderFormatBlockHeight(srcTexture->desc.format);
+            VkBufferImageCopy imageCopy = {};
+            imageCopy.bufferOffset = dstLocation.placedFootprint.offset;
+            imageCopy.bufferRowLength = ((dstLocation.placedFootprint.rowWidth + blockWidth - 1) / blockWidth) * blockWidth;
+            imageCopy.bufferImageHeight = ((dstLocation.placedFootprint.height + blockHeight - 1) / blockHeight) * blockHeight;
+            imageCopy.imageSubresource.aspectMask = toAspectFlags(srcTexture->desc.format, srcTexture->desc.flags);
+            imageCopy.imageSubresource.baseArrayLayer = srcLocation.subresource.arrayIndex;
+            imageCopy.imageSubresource.layerCount = 1;
+            imageCopy.imageSubresource.mipLevel = srcLocation.subresource.mipLevel;
+
+            // The destination coordinates are ignored as the footprint in the buffer always starts at its offset.
+            if (srcBox != nullptr) {
+                imageCopy.imageOffset.x = srcBox->left;
+                imageCopy.imageOffset.y = srcBox->top;
+                imageCopy.imageOffset.z = srcBox->front;
+                imageCopy.imageExtent.width = srcBox->right - srcBox->left;
+                imageCopy.imageExtent.height = srcBox->bottom - srcBox->top;
+                imageCopy.imageExtent.depth = srcBox->back - srcBox->front;
+            }
+            else {
+                imageCopy.imageExtent.width = dstLocation.placedFootprint.width;
+                imageCopy.imageExtent.height = dstLocation.placedFootprint.height;
+                imageCopy.imageExtent.depth = dstLocation.placedFootprint.depth;
+            }
+
+            vkCmdCopyImageToBuffer(vk, srcTexture->vk, toImageLayout(srcTexture->textureLayout), dstBuffer->vk, 1, &imageCopy);
+        }
         else {
             VkImageCopy imageCopy = {};
             imageCopy.srcSubresource.aspectMask = toAspectFlags(srcTexture->desc.format, srcTexture->desc.flags);
@@ -3250,6 +4736,7 @@ namespace plume {
 
     void VulkanCommandList::copyBuffer(const RenderBuffer *dstBuffer, const RenderBuffer *srcBuffer) {
         endActiveRenderPass();
+        flushBarriers();
 
         assert(dstBuffer != nullptr);
         assert(srcBuffer != nullptr);
@@ -3265,12 +4752,13 @@ namespace plume {
 
     void VulkanCommandList::copyTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) {
         endActiveRenderPass();
+        flushBarriers();
 
         assert(dstTexture != nullptr);
         assert(srcTexture != nullptr);
 
-        thread_local std::vector<VkImageCopy> imageCopies;
-        imageCopies.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkImageCopy> imageCopies;
 
         const VulkanTexture *dst = static_cast<const VulkanTexture *>(dstTexture);
         const VulkanTexture *src = static_cast<const VulkanTexture *>(srcTexture);
@@ -3308,8 +4796,8 @@ namespace plume {
         assert(srcTexture != nullptr);
         assert(resolveMode == RenderResolveMode::AVERAGE && "Vulkan only supports AVERAGE resolve mode.");
 
-        thread_local std::vector<VkImageResolve> imageResolves;
-        imageResolves.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkImageResolve> imageResolves;
 
         const VulkanTexture *dst = static_cast<const VulkanTexture *>(dstTexture);
         const VulkanTexture *src = static_cast<const VulkanTexture *>(srcTexture);
@@ -3346,6 +4834,7 @@ namespace plume {
             imageResolves.emplace_back(imageResolve);
         }
 
+        flushBarriers();
         vkCmdResolveImage(vk, src->vk, srcLayout, dst->vk, dstLayout, uint32_t(imageResolves.size()), imageResolves.data());
     }
     
@@ -3380,6 +4869,7 @@ namespace plume {
         buildRangeInfo.transformOffset = 0;
 
         VkAccelerationStructureBuildRangeInfoKHR *buildRangeInfoPtr = &buildRangeInfo;
+        flushBarriers();
         vkCmdBuildAccelerationStructuresKHR(vk, 1, &buildGeometryInfo, &buildRangeInfoPtr);
     }
 
@@ -3429,6 +4919,7 @@ namespace plume {
         buildRangeInfo.transformOffset = 0;
 
         VkAccelerationStructureBuildRangeInfoKHR *buildRangeInfoPtr = &buildRangeInfo;
+        flushBarriers();
         vkCmdBuildAccelerationStructuresKHR(vk, 1, &buildGeometryInfo, &buildRangeInfoPtr);
     }
 
@@ -3447,29 +4938,82 @@ namespace plume {
         assert(queryPool != nullptr);
 
         const VulkanQueryPool *interfaceQueryPool = static_cast<const VulkanQueryPool *>(queryPool);
+        flushBarriers();
         vkCmdWriteTimestamp(vk, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, interfaceQueryPool->vk, queryIndex);
     }
 
+    bool VulkanCommandList::isDynamicStateSupported(RenderDynamicStateFlags state) const {
+        return queue->device->capabilities.shaderObjects || (queue->device->capabilities.dynamicStates & state);
+    }
+
     void VulkanCommandList::checkActiveRenderPass() {
         assert(targetFramebuffer != nullptr);
         
+        // Shader objects can only draw with dynamic rendering, so the active pass is restarted when switching between them and pipelines.
+        if ((activeRenderPass != VK_NULL_HANDLE) && (activeDynamicRendering != graphicsShaderObjectsBound)) {
+            endActiveRenderPass();
+        }
+
         if (activeRenderPass == VK_NULL_HANDLE) {
-            VkRenderPassBeginInfo beginInfo = {};
-            beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            beginInfo.renderPass = targetFramebuffer->renderPass;
-            beginInfo.framebuffer = targetFramebuffer->vk;
-            beginInfo.renderArea.extent.width = targetFramebuffer->width;
-            beginInfo.renderArea.extent.height = targetFramebuffer->height;
-            vkCmdBeginRenderPass(vk, &beginInfo, VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE);
+            flushBarriers();
+
+            if (graphicsShaderObjectsBound) {
+                const bool depthAttachmentPresent = (targetFramebuffer->depthAttachment != nullptr);
+                VkRenderingInfoKHR renderingInfo = {};
+                renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+                renderingInfo.renderArea.extent.width = targetFramebuffer->width;
+                renderingInfo.renderArea.extent.height = targetFramebuffer->height;
+                renderingInfo.layerCount = targetFramebuffer->layerCount;
+                renderingInfo.viewMask = targetFramebuffer->viewMask;
+                renderingInfo.colorAttachmentCount = uint32_t(targetFramebuffer->colorRenderingAttachments.size());
+                renderingInfo.pColorAttachments = targetFramebuffer->colorRenderingAttachments.data();
+                renderingInfo.pDepthAttachment = depthAttachmentPresent ? &targetFramebuffer->depthRenderingAttachment : nullptr;
+                renderingInfo.pStencilAttachment = (depthAttachmentPresent && targetFramebuffer->depthRenderingStencil) ? &targetFramebuffer->depthRenderingAttachment : nullptr;
+                vkCmdBeginRenderingKHR(vk, &renderingInfo);
+            }
+            else {
+                VkRenderPassBeginInfo beginInfo = {};
+                beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                beginInfo.renderPass = targetFramebuffer->renderPass;
+                beginInfo.framebuffer = targetFramebuffer->vk;
+                beginInfo.renderArea.extent.width = targetFramebuffer->width;
+                beginInfo.renderArea.extent.height = targetFramebuffer->height;
+                vkCmdBeginRenderPass(vk, &beginInfo, VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE);
+            }
+
             activeRenderPass = targetFramebuffer->renderPass;
+            activeDynamicRendering = graphicsShaderObjectsBound;
         }
     }
 
     void VulkanCommandList::endActiveRenderPass() {
         if (activeRenderPass != VK_NULL_HANDLE) {
-            vkCmdEndRenderPass(vk);
+            if (activeDynamicRendering) {
+                vkCmdEndRenderingKHR(vk);
+            }
+            else {
+                vkCmdEndRenderPass(vk);
+            }
+
             activeRenderPass = VK_NULL_HANDLE;
+            activeDynamicRendering = false;
+        }
+    }
+
+    void VulkanCommandList::flushBarriers() {
+        if (pendingBarriers.bufferMemoryBarriers.empty() && pendingBarriers.imageMemoryBarriers.empty()) {
+            return;
         }
+
+        assert((activeRenderPass == VK_NULL_HANDLE) && "Barriers can't be issued during a render pass.");
+
+        std::vector<VkBufferMemoryBarrier> &bufferMemoryBarriers = pendingBarriers.bufferMemoryBarriers;
+        std::vector<VkImageMemoryBarrier> &imageMemoryBarriers = pendingBarriers.imageMemoryBarriers;
+        vkCmdPipelineBarrier(vk, pendingBarriers.srcStageMask, pendingBarriers.dstStageMask, 0, 0, nullptr, uint32_t(bufferMemoryBarriers.size()), bufferMemoryBarriers.data(), uint32_t(imageMemoryBarriers.size()), imageMemoryBarriers.data());
+        pendingBarriers.srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        pendingBarriers.dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        bufferMemoryBarriers.clear();
+        imageMemoryBarriers.clear();
     }
 
     void VulkanCommandList::setDescriptorSet(VkPipelineBindPoint bindPoint, const VulkanPipelineLayout *pipelineLayout, const RenderDescriptorSet *descriptorSet, uint32_t setIndex) {
@@ -3478,7 +5022,112 @@ namespace plume {
         assert(setIndex < pipelineLayout->descriptorSetLayouts.size());
 
         const VulkanDescriptorSet *interfaceSet = static_cast<const VulkanDescriptorSet *>(descriptorSet);
+        uint32_t bindPointIndex;
+        switch (bindPoint) {
+        case VK_PIPELINE_BIND_POINT_GRAPHICS:
+            bindPointIndex = 0;
+            break;
+        case VK_PIPELINE_BIND_POINT_COMPUTE:
+            bindPointIndex = 1;
+            break;
+        default:
+            bindPointIndex = 2;
+            break;
+        }
+
+        VkDescriptorSet *boundSets = boundDescriptorSets[bindPointIndex];
+        VulkanLayoutKey &boundLayoutKey = boundLayoutKeys[bindPointIndex];
+
+        // Skip the bind if the set is still bound with a compatible layout.
+        if ((setIndex < MaxCachedDescriptorSets) && (boundSets[setIndex] == interfaceSet->vk) && pipelineLayout->isCompatibleForSet(boundLayoutKey, setIndex)) {
+            return;
+        }
+
         vkCmdBindDescriptorSets(vk, bindPoint, pipelineLayout->vk, setIndex, 1, &interfaceSet->vk, 0, nullptr);
+
+        // Binding with a layout that isn't compatible with the one the other sets were bound with disturbs them.
+        for (uint32_t i = 0; i < MaxCachedDescriptorSets; i++) {
+            if ((i != setIndex) && (boundSets[i] != VK_NULL_HANDLE) && !pipelineLayout->isCompatibleForSet(boundLayoutKey, i)) {
+                boundSets[i] = VK_NULL_HANDLE;
+            }
+        }
+
+        if (setIndex < MaxCachedDescriptorSets) {
+            boundSets[setIndex] = interfaceSet->vk;
+        }
+
+        boundLayoutKey = pipelineLayout->cacheKey;
+    }
+
+    // Adds the stages the buffer was last used with to the source stages and tracks the new ones.
+    VkBufferMemoryBarrier VulkanCommandList::prepareBufferBarrier(RenderBarrierStages stages, const RenderBufferBarrier &bufferBarrier, VkPipelineStageFlags &srcStageMask) {
+        const bool geometryEnabled = queue->device->capabilities.geometryShader;
+        const bool meshEnabled = queue->device->capabilities.meshShader;
+        const bool rtEnabled = queue->device->capabilities.raytracing;
+        const uint32_t familyIndex = queue->device->queueFamilyIndices[toFamilyIndex(queue->type)];
+        VulkanBuffer *interfaceBuffer = static_cast<VulkanBuffer *>(bufferBarrier.buffer);
+        VkBufferMemoryBarrier bufferMemoryBarrier = {};
+        bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
+        bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
+        toQueueFamilyTransfer(queue->device, bufferBarrier.srcQueueType, bufferBarrier.dstQueueType, bufferMemoryBarrier.srcQueueFamilyIndex, bufferMemoryBarrier.dstQueueFamilyIndex);
+        bufferMemoryBarrier.buffer = interfaceBuffer->vk;
+        bufferMemoryBarrier.offset = 0;
+        bufferMemoryBarrier.size = interfaceBuffer->desc.size;
+
+        // Accesses on the other side of an ownership transfer are made available or visible by the barrier recorded on the other queue.
+        if (bufferMemoryBarrier.srcQueueFamilyIndex != bufferMemoryBarrier.dstQueueFamilyIndex) {
+            assert(((bufferMemoryBarrier.srcQueueFamilyIndex == familyIndex) || (bufferMemoryBarrier.dstQueueFamilyIndex == familyIndex)) && "Ownership transfers must be recorded on the source or destination queue.");
+            if (bufferMemoryBarrier.srcQueueFamilyIndex == familyIndex) {
+                bufferMemoryBarrier.dstAccessMask = 0;
+            }
+            else {
+                bufferMemoryBarrier.srcAccessMask = 0;
+            }
+        }
+
+        srcStageMask |= toStageFlags(interfaceBuffer->barrierStages, geometryEnabled, meshEnabled, rtEnabled);
+        interfaceBuffer->barrierStages = stages;
+        interfaceBuffer->barrierAccess = bufferBarrier.accessBits;
+        return bufferMemoryBarrier;
+    }
+
+    // Adds the stages the texture was last used with to the source stages and tracks the new stages and layout.
+    VkImageMemoryBarrier VulkanCommandList::prepareTextureBarrier(RenderBarrierStages stages, const RenderTextureBarrier &textureBarrier, VkPipelineStageFlags &srcStageMask) {
+        const bool geometryEnabled = queue->device->capabilities.geometryShader;
+        const bool meshEnabled = queue->device->capabilities.meshShader;
+        const bool rtEnabled = queue->device->capabilities.raytracing;
+        const uint32_t familyIndex = queue->device->queueFamilyIndices[toFamilyIndex(queue->type)];
+        VulkanTexture *interfaceTexture = static_cast<VulkanTexture *>(textureBarrier.texture);
+        VkImageMemoryBarrier imageMemoryBarrier = {};
+        imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageMemoryBarrier.image = interfaceTexture->vk;
+        imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
+        imageMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT; // TODO
+        toQueueFamilyTransfer(queue->device, textureBarrier.srcQueueType, textureBarrier.dstQueueType, imageMemoryBarrier.srcQueueFamilyIndex, imageMemoryBarrier.dstQueueFamilyIndex);
+        imageMemoryBarrier.oldLayout = toImageLayout(interfaceTexture->textureLayout);
+        imageMemoryBarrier.newLayout = toImageLayout(textureBarrier.layout);
+        imageMemoryBarrier.subresourceRange.levelCount = interfaceTexture->desc.mipLevels;
+        imageMemoryBarrier.subresourceRange.layerCount = interfaceTexture->desc.arraySize;
+        imageMemoryBarrier.subresourceRange.aspectMask = toAspectFlags(interfaceTexture->desc.format, interfaceTexture->desc.flags);
+
+        // The release and the acquire of an ownership transfer must specify the same layout transition, so both take the old layout from the barrier.
+        if (imageMemoryBarrier.srcQueueFamilyIndex != imageMemoryBarrier.dstQueueFamilyIndex) {
+            assert(((imageMemoryBarrier.srcQueueFamilyIndex == familyIndex) || (imageMemoryBarrier.dstQueueFamilyIndex == familyIndex)) && "Ownership transfers must be recorded on the source or destination queue.");
+            imageMemoryBarrier.oldLayout = toImageLayout(textureBarrier.srcLayout);
+            if (imageMemoryBarrier.srcQueueFamilyIndex == familyIndex) {
+                assert((textureBarrier.srcLayout == interfaceTexture->textureLayout) && "The layout before an ownership transfer must match the texture's current layout.");
+                imageMemoryBarrier.dstAccessMask = 0;
+            }
+            else {
+                imageMemoryBarrier.srcAccessMask = 0;
+            }
+        }
+
+        srcStageMask |= toStageFlags(interfaceTexture->barrierStages, geometryEnabled, meshEnabled, rtEnabled);
+        interfaceTexture->textureLayout = textureBarrier.layout;
+        interfaceTexture->barrierStages = stages;
+        return imageMemoryBarrier;
     }
 
     // VulkanCommandFence
@@ -3506,8 +5155,36 @@ namespace plume {
 
     // VulkanCommandSemaphore
 
-    VulkanCommandSemaphore::VulkanCommandSemaphore(VulkanDevice *device) {
+    VulkanCommandSemaphore::VulkanCommandSemaphore(VulkanDevice *device, RenderExternalHandleType exportHandleType) {
+        assert(device != nullptr);
+
+        this->device = device;
+        this->exportHandleType = exportHandleType;
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkExportSemaphoreCreateInfo exportInfo = {};
+        if (exportHandleType != RenderExternalHandleType::NONE) {
+            assert(device->capabilities.externalSemaphore && "External semaphores are unsupported on this device.");
+            assert((exportHandleType == RenderExternalHandleType::OPAQUE) && "Semaphores only support opaque handles.");
+            exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+            exportInfo.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+            semaphoreInfo.pNext = &exportInfo;
+        }
+
+        VkResult res = vkCreateSemaphore(device->vk, &semaphoreInfo, nullptr, &vk);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateSemaphore failed with error code 0x%X.\n", res);
+            return;
+        }
+    }
+
+    VulkanCommandSemaphore::VulkanCommandSemaphore(VulkanDevice *device, RenderExternalHandleType handleType, RenderExternalHandle handle) {
         assert(device != nullptr);
+        assert(device->capabilities.externalSemaphore && "External semaphores are unsupported on this device.");
+        assert((handleType == RenderExternalHandleType::OPAQUE) && "Semaphores only support opaque handles.");
+        assert(isImportableFd(handle) && "Handle must be a valid file descriptor.");
 
         this->device = device;
 
@@ -3519,6 +5196,18 @@ namespace plume {
             fprintf(stderr, "vkCreateSemaphore failed with error code 0x%X.\n", res);
             return;
         }
+
+        VkImportSemaphoreFdInfoKHR importInfo = {};
+        importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
+        importInfo.semaphore = vk;
+        importInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+        importInfo.fd = int(handle);
+
+        res = vkImportSemaphoreFdKHR(device->vk, &importInfo);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkImportSemaphoreFdKHR failed with error code 0x%X.\n", res);
+            return;
+        }
     }
 
     VulkanCommandSemaphore::~VulkanCommandSemaphore() {
@@ -3527,6 +5216,24 @@ namespace plume {
         }
     }
 
+    RenderExternalHandle VulkanCommandSemaphore::exportHandle() {
+        assert((exportHandleType != RenderExternalHandleType::NONE) && "Semaphore must have been created with an export handle type.");
+
+        VkSemaphoreGetFdInfoKHR getFdInfo = {};
+        getFdInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+        getFdInfo.semaphore = vk;
+        getFdInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+
+        int fd = -1;
+        VkResult res = vkGetSemaphoreFdKHR(device->vk, &getFdInfo, &fd);
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkGetSemaphoreFdKHR failed with error code 0x%X.\n", res);
+            return RenderExternalHandleInvalid;
+        }
+
+        return RenderExternalHandle(fd);
+    }
+
     // VulkanCommandQueue
 
     VulkanCommandQueue::VulkanCommandQueue(VulkanDevice *device, RenderCommandListType type) {
@@ -3544,8 +5251,8 @@ namespace plume {
         device->queueFamilies[familyIndex].remove(this);
     }
 
-    std::unique_ptr<RenderCommandList> VulkanCommandQueue::createCommandList() {
-        return std::make_unique<VulkanCommandList>(this);
+    std::unique_ptr<RenderCommandList> VulkanCommandQueue::createCommandList(const RenderCommandListDesc &desc) {
+        return std::make_unique<VulkanCommandList>(this, desc);
     }
 
     std::unique_ptr<RenderSwapChain> VulkanCommandQueue::createSwapChain(RenderWindow renderWindow, uint32_t bufferCount, RenderFormat format, uint32_t maxFrameLatency) {
@@ -3556,12 +5263,10 @@ namespace plume {
         assert(commandLists != nullptr);
         assert(commandListCount > 0);
 
-        thread_local std::vector<VkSemaphore> waitSemaphoreVector;
-        thread_local std::vector<VkSemaphore> signalSemaphoreVector;
-        thread_local std::vector<VkCommandBuffer> commandBuffers;
-        waitSemaphoreVector.clear();
-        signalSemaphoreVector.clear();
-        commandBuffers.clear();
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkSemaphore> waitSemaphoreVector;
+        RenderScratchArray<VkSemaphore> signalSemaphoreVector;
+        RenderScratchArray<VkCommandBuffer> commandBuffers;
 
         for (uint32_t i = 0; i < waitSemaphoreCount; i++) {
             VulkanCommandSemaphore *interfaceSemaphore = static_cast<VulkanCommandSemaphore *>(waitSemaphores[i]);
@@ -3880,6 +5585,83 @@ namespace plume {
             featuresChain = &accelerationStructureFeatures;
         }
 
+        VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures = {};
+        const bool extendedDynamicStateFound = supportedOptionalExtensions.find(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (extendedDynamicStateFound) {
+            extendedDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+            extendedDynamicStateFeatures.pNext = featuresChain;
+            featuresChain = &extendedDynamicStateFeatures;
+        }
+
+        VkPhysicalDeviceExtendedDynamicState2FeaturesEXT extendedDynamicState2Features = {};
+        const bool extendedDynamicState2Found = supportedOptionalExtensions.find(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (extendedDynamicState2Found) {
+            extendedDynamicState2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+            extendedDynamicState2Features.pNext = featuresChain;
+            featuresChain = &extendedDynamicState2Features;
+        }
+
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features = {};
+        const bool extendedDynamicState3Found = supportedOptionalExtensions.find(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (extendedDynamicState3Found) {
+            extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+            extendedDynamicState3Features.pNext = featuresChain;
+            featuresChain = &extendedDynamicState3Features;
+        }
+
+        VkPhysicalDeviceVertexInputDynamicStateFeaturesEXT vertexInputDynamicStateFeatures = {};
+        const bool vertexInputDynamicStateFound = supportedOptionalExtensions.find(VK_EXT_VERTEX_INPUT_DYNAMIC_STATE_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (vertexInputDynamicStateFound) {
+            vertexInputDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_INPUT_DYNAMIC_STATE_FEATURES_EXT;
+            vertexInputDynamicStateFeatures.pNext = featuresChain;
+            featuresChain = &vertexInputDynamicStateFeatures;
+        }
+
+        VkPhysicalDeviceMultiviewFeatures multiviewFeatures = {};
+        multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+        multiviewFeatures.pNext = featuresChain;
+        featuresChain = &multiviewFeatures;
+
+        VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {};
+        const bool meshShaderFound = supportedOptionalExtensions.find(VK_EXT_MESH_SHADER_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (meshShaderFound) {
+            meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+            meshShaderFeatures.pNext = featuresChain;
+            featuresChain = &meshShaderFeatures;
+        }
+
+        VkPhysicalDeviceTextureCompressionASTCHDRFeaturesEXT astcHdrFeatures = {};
+        const bool astcHdrFound = supportedOptionalExtensions.find(VK_EXT_TEXTURE_COMPRESSION_ASTC_HDR_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (astcHdrFound) {
+            astcHdrFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TEXTURE_COMPRESSION_ASTC_HDR_FEATURES_EXT;
+            astcHdrFeatures.pNext = featuresChain;
+            featuresChain = &astcHdrFeatures;
+        }
+
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {};
+        const bool dynamicRenderingFound = supportedOptionalExtensions.find(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (dynamicRenderingFound) {
+            dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+            dynamicRenderingFeatures.pNext = featuresChain;
+            featuresChain = &dynamicRenderingFeatures;
+        }
+
+        VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features = {};
+        const bool synchronization2Found = supportedOptionalExtensions.find(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (synchronization2Found) {
+            synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+            synchronization2Features.pNext = featuresChain;
+            featuresChain = &synchronization2Features;
+        }
+
+        VkPhysicalDeviceShaderObjectFeaturesEXT shaderObjectFeatures = {};
+        const bool shaderObjectFound = supportedOptionalExtensions.find(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (shaderObjectFound) {
+            shaderObjectFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+            shaderObjectFeatures.pNext = featuresChain;
+            featuresChain = &shaderObjectFeatures;
+        }
+
         VkPhysicalDeviceFeatures2 deviceFeatures = {};
         deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
         deviceFeatures.pNext = featuresChain;
@@ -3905,6 +5687,25 @@ namespace plume {
             vkGetPhysicalDeviceProperties2(physicalDevice, &deviceProperties2);
         }
 
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT externalMemoryHostProperties = {};
+        const bool externalMemoryHostFound = supportedOptionalExtensions.find(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        if (externalMemoryHostFound) {
+            externalMemoryHostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+            VkPhysicalDeviceProperties2 deviceProperties2 = {};
+            deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            deviceProperties2.pNext = &externalMemoryHostProperties;
+            vkGetPhysicalDeviceProperties2(physicalDevice, &deviceProperties2);
+        }
+
+        VkPhysicalDeviceMultiviewProperties multiviewProperties = {};
+        multiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+
+        VkPhysicalDeviceProperties2 multiviewDeviceProperties2 = {};
+        multiviewDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        multiviewDeviceProperties2.pNext = &multiviewProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &multiviewDeviceProperties2);
+
         // Build the device creation chain.
         void *createDeviceChain = nullptr;
         const bool rayTracingSupported = rayTracingPipelineFeatures.rayTracingPipeline && accelerationStructureFeatures.accelerationStructure;
@@ -3954,6 +5755,74 @@ namespace plume {
             createDeviceChain = &portabilityFeatures;
         }
 
+        const bool extendedDynamicStateSupported = extendedDynamicStateFeatures.extendedDynamicState;
+        if (extendedDynamicStateSupported) {
+            extendedDynamicStateFeatures.pNext = createDeviceChain;
+            createDeviceChain = &extendedDynamicStateFeatures;
+        }
+
+        const bool extendedDynamicState2Supported = extendedDynamicState2Features.extendedDynamicState2;
+        if (extendedDynamicState2Supported) {
+            extendedDynamicState2Features.pNext = createDeviceChain;
+            createDeviceChain = &extendedDynamicState2Features;
+        }
+
+        const bool vertexInputDynamicStateSupported = vertexInputDynamicStateFeatures.vertexInputDynamicState;
+        if (vertexInputDynamicStateSupported) {
+            vertexInputDynamicStateFeatures.pNext = createDeviceChain;
+            createDeviceChain = &vertexInputDynamicStateFeatures;
+        }
+
+        const bool multiviewSupported = multiviewFeatures.multiview;
+        if (multiviewSupported) {
+            multiviewFeatures.pNext = createDeviceChain;
+            createDeviceChain = &multiviewFeatures;
+        }
+
+        // Only the task and mesh stages are enabled along with multiview, as the rest of the features depend on other features that aren't enabled.
+        const bool meshShaderSupported = meshShaderFeatures.taskShader && meshShaderFeatures.meshShader;
+        if (meshShaderSupported) {
+            const VkBool32 multiviewMeshShader = multiviewSupported ? meshShaderFeatures.multiviewMeshShader : VK_FALSE;
+            meshShaderFeatures = {};
+            meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+            meshShaderFeatures.taskShader = VK_TRUE;
+            meshShaderFeatures.meshShader = VK_TRUE;
+            meshShaderFeatures.multiviewMeshShader = multiviewMeshShader;
+            meshShaderFeatures.pNext = createDeviceChain;
+            createDeviceChain = &meshShaderFeatures;
+        }
+
+        const bool astcHdrSupported = astcHdrFeatures.textureCompressionASTC_HDR;
+        if (astcHdrSupported) {
+            astcHdrFeatures.pNext = createDeviceChain;
+            createDeviceChain = &astcHdrFeatures;
+        }
+
+        // Shader objects draw with dynamic rendering, so the feature is only enabled along with them.
+        const bool shaderObjectSupported = shaderObjectFeatures.shaderObject && dynamicRenderingFeatures.dynamicRendering;
+        if (shaderObjectSupported) {
+            dynamicRenderingFeatures.pNext = createDeviceChain;
+            createDeviceChain = &dynamicRenderingFeatures;
+            shaderObjectFeatures.pNext = createDeviceChain;
+            createDeviceChain = &shaderObjectFeatures;
+        }
+
+        synchronization2Supported = synchronization2Features.synchronization2;
+        if (synchronization2Supported) {
+            synchronization2Features.pNext = createDeviceChain;
+            createDeviceChain = &synchronization2Features;
+        }
+
+        // Only the dynamic depth clamp is enabled out of all the states the extension provides.
+        const bool dynamicDepthClampSupported = extendedDynamicState3Features.extendedDynamicState3DepthClampEnable && deviceFeatures.features.depthClamp;
+        if (dynamicDepthClampSupported) {
+            extendedDynamicState3Features = {};
+            extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+            extendedDynamicState3Features.extendedDynamicState3DepthClampEnable = VK_TRUE;
+            extendedDynamicState3Features.pNext = createDeviceChain;
+            createDeviceChain = &extendedDynamicState3Features;
+        }
+
         // Retrieve the information for the queue families.
         uint32_t queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
@@ -4039,6 +5908,8 @@ namespace plume {
             return;
         }
 
+        enabledFeatures = deviceFeatures.features;
+
         for (uint32_t i = 0; i < queueFamilyCount; i++) {
             for (uint32_t j = 0; j < queueFamilies[i].queues.size(); j++) {
                 vkGetDeviceQueue(vk, i, j, &queueFamilies[i].queues[j].vk);
@@ -4105,6 +5976,7 @@ namespace plume {
 
         // Fill capabilities.
         capabilities.geometryShader = deviceFeatures.features.geometryShader;
+        capabilities.meshShader = meshShaderSupported;
         capabilities.raytracing = rayTracingSupported;
         capabilities.raytracingStateUpdate = false;
         capabilities.sampleLocations = (sampleLocationProperties.sampleLocationSampleCounts != 0);
@@ -4131,6 +6003,56 @@ namespace plume {
         capabilities.triangleFan = true;
 #   endif
 
+        // Stencil reference is dynamic in core Vulkan. The rest of the states depend on the extended dynamic state extensions.
+        capabilities.dynamicStates = RenderDynamicStateFlag::STENCIL_REFERENCE;
+        if (extendedDynamicStateSupported) {
+            capabilities.dynamicStates |= RenderDynamicStateFlag::CULL_MODE | RenderDynamicStateFlag::FRONT_FACE | RenderDynamicStateFlag::PRIMITIVE_TOPOLOGY | RenderDynamicStateFlag::DEPTH_ENABLED |
+                RenderDynamicStateFlag::DEPTH_WRITE_ENABLED | RenderDynamicStateFlag::DEPTH_FUNCTION | RenderDynamicStateFlag::STENCIL_ENABLED | RenderDynamicStateFlag::STENCIL_FACES |
+                RenderDynamicStateFlag::VERTEX_BUFFER_STRIDE;
+        }
+
+        if (extendedDynamicState2Supported) {
+            capabilities.dynamicStates |= RenderDynamicStateFlag::DEPTH_BIAS_ENABLED;
+        }
+
+        if (dynamicDepthClampSupported) {
+            capabilities.dynamicStates |= RenderDynamicStateFlag::DEPTH_CLIP_ENABLED;
+        }
+
+        if (vertexInputDynamicStateSupported) {
+            capabilities.dynamicStates |= RenderDynamicStateFlag::VERTEX_INPUT;
+        }
+
+        capabilities.shaderObjects = shaderObjectSupported;
+        capabilities.specConstants = true;
+        capabilities.reusableCommandLists = true;
+        capabilities.hostMemoryImport = externalMemoryHostFound;
+        capabilities.hostMemoryImportAlignment = externalMemoryHostFound ? externalMemoryHostProperties.minImportedHostPointerAlignment : 0;
+        capabilities.externalMemory = supportedOptionalExtensions.find(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        capabilities.externalMemoryDmaBuf = capabilities.externalMemory && (supportedOptionalExtensions.find(VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME) != supportedOptionalExtensions.end());
+        capabilities.externalSemaphore = supportedOptionalExtensions.find(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        capabilities.textureCompressionBC = deviceFeatures.features.textureCompressionBC;
+        capabilities.textureCompressionETC2 = deviceFeatures.features.textureCompressionETC2;
+        capabilities.textureCompressionASTC = deviceFeatures.features.textureCompressionASTC_LDR;
+        capabilities.textureCompressionASTCHDR = astcHdrSupported;
+        capabilities.multiview = multiviewSupported;
+        capabilities.maxMultiviewViewCount = multiviewSupported ? multiviewProperties.maxMultiviewViewCount : 0;
+        capabilities.layerOutputFromVertex = supportedOptionalExtensions.find(VK_EXT_SHADER_VIEWPORT_INDEX_LAYER_EXTENSION_NAME) != supportedOptionalExtensions.end();
+        capabilities.maxFramebufferLayers = physicalDeviceProperties.limits.maxFramebufferLayers;
+
+        // Cache the support for all formats.
+        formatSupport.resize(size_t(RenderFormat::MAX));
+        for (uint32_t i = uint32_t(RenderFormat::UNKNOWN) + 1; i < uint32_t(RenderFormat::MAX); i++) {
+            // The float ASTC formats can't be queried unless the extension that introduces them is enabled.
+            const VkFormat vkFormat = toVk(RenderFormat(i));
+            const bool astcHdrFormat = (vkFormat >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK_EXT) && (vkFormat <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK_EXT);
+            if (astcHdrFormat && !astcHdrSupported) {
+                continue;
+            }
+
+            formatSupport[i] = toFormatSupport(physicalDevice, RenderFormat(i));
+        }
+
         // Fill Vulkan-only capabilities.
         loadStoreOpNoneSupported = supportedOptionalExtensions.find(VK_EXT_LOAD_STORE_OP_NONE_EXTENSION_NAME) != supportedOptionalExtensions.end();
 
@@ -4151,6 +6073,102 @@ namespace plume {
         return std::make_unique<VulkanShader>(this, data, size, entryPointName, format);
     }
 
+    std::vector<std::unique_ptr<RenderShaderObject>> VulkanDevice::createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked) {
+        assert(capabilities.shaderObjects && "Shader objects are unsupported on this device.");
+        assert(descs != nullptr);
+        assert(descsCount > 0);
+
+        RenderScratchScope scratchScope;
+        RenderScratchArray<VkShaderCreateInfoEXT> shaderInfos(descsCount);
+        RenderScratchArray<VkDescriptorSetLayout> setLayouts;
+        RenderScratchArray<VkSpecializationInfo> specInfos;
+        RenderScratchArray<VkSpecializationMapEntry> specEntries;
+        RenderScratchArray<uint32_t> specData;
+
+        // Reserve all the storage first so the pointers stored in the create infos remain valid.
+        uint32_t setLayoutsCount = 0;
+        uint32_t specConstantsCount = 0;
+        for (uint32_t i = 0; i < descsCount; i++) {
+            if (descs[i].pipelineLayout != nullptr) {
+                setLayoutsCount += uint32_t(static_cast<const VulkanPipelineLayout *>(descs[i].pipelineLayout)->descriptorSetLayouts.size());
+            }
+
+            specConstantsCount += descs[i].specConstantsCount;
+        }
+
+        setLayouts.reserve(setLayoutsCount);
+        specInfos.resize(descsCount);
+        specEntries.resize(specConstantsCount);
+        specData.resize(specConstantsCount);
+
+        uint32_t specConstantsOffset = 0;
+        for (uint32_t i = 0; i < descsCount; i++) {
+            const RenderShaderObjectDesc &desc = descs[i];
+            assert(desc.data != nullptr);
+            assert(desc.size > 0);
+            assert(desc.format == RenderShaderFormat::SPIRV);
+
+            VkShaderCreateInfoEXT shaderInfo = {};
+            shaderInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+            shaderInfo.flags = linked ? VK_SHADER_CREATE_LINK_STAGE_BIT_EXT : 0;
+            shaderInfo.stage = toShaderStage(desc.stage);
+            shaderInfo.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+            shaderInfo.codeSize = desc.size;
+            shaderInfo.pCode = desc.data;
+            shaderInfo.pName = (desc.entryPointName != nullptr) ? desc.entryPointName : "main";
+
+            if (shaderInfo.stage == VK_SHADER_STAGE_VERTEX_BIT) {
+                shaderInfo.nextStage = VK_SHADER_STAGE_FRAGMENT_BIT | (enabledFeatures.geometryShader ? VK_SHADER_STAGE_GEOMETRY_BIT : 0);
+            }
+            else if (shaderInfo.stage == VK_SHADER_STAGE_GEOMETRY_BIT) {
+                shaderInfo.nextStage = VK_SHADER_STAGE_FRAGMENT_BIT;
+            }
+
+            if (desc.pipelineLayout != nullptr) {
+                const VulkanPipelineLayout *pipelineLayout = static_cast<const VulkanPipelineLayout *>(desc.pipelineLayout);
+                shaderInfo.setLayoutCount = uint32_t(pipelineLayout->descriptorSetLayouts.size());
+                shaderInfo.pSetLayouts = setLayouts.data() + setLayouts.size();
+                for (const VulkanDescriptorSetLayout *setLayout : pipelineLayout->descriptorSetLayouts) {
+                    setLayouts.emplace_back(setLayout->vk);
+                }
+
+                shaderInfo.pushConstantRangeCount = uint32_t(pipelineLayout->pushConstantRanges.size());
+                shaderInfo.pPushConstantRanges = pipelineLayout->pushConstantRanges.data();
+            }
+
+            if (desc.specConstantsCount > 0) {
+                fillSpecInfo(desc.specConstants, desc.specConstantsCount, specInfos[i], &specEntries[specConstantsOffset], &specData[specConstantsOffset]);
+                shaderInfo.pSpecializationInfo = &specInfos[i];
+                specConstantsOffset += desc.specConstantsCount;
+            }
+
+            shaderInfos.emplace_back(shaderInfo);
+        }
+
+        std::vector<VkShaderEXT> shaders(descsCount, VK_NULL_HANDLE);
+        std::vector<std::unique_ptr<RenderShaderObject>> shaderObjects;
+        VkResult res = vkCreateShadersEXT(vk, descsCount, shaderInfos.data(), nullptr, shaders.data());
+        if (res != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateShadersEXT failed with error code 0x%X.\n", res);
+
+            // Creation can fail partway through, so the shaders that were created must be destroyed.
+            for (VkShaderEXT shader : shaders) {
+                if (shader != VK_NULL_HANDLE) {
+                    vkDestroyShaderEXT(vk, shader, nullptr);
+                }
+            }
+
+            return shaderObjects;
+        }
+
+        shaderObjects.reserve(descsCount);
+        for (uint32_t i = 0; i < descsCount; i++) {
+            shaderObjects.emplace_back(std::make_unique<VulkanShaderObject>(this, shaders[i], shaderInfos[i].stage));
+        }
+
+        return shaderObjects;
+    }
+
     std::unique_ptr<RenderSampler> VulkanDevice::createSampler(const RenderSamplerDesc &desc) {
         return std::make_unique<VulkanSampler>(this, desc);
     }
@@ -4175,10 +6193,41 @@ namespace plume {
         return std::make_unique<VulkanBuffer>(this, nullptr, desc);
     }
 
+    std::unique_ptr<RenderBuffer> VulkanDevice::createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) {
+        return std::make_unique<VulkanBuffer>(this, hostPointer, size, flags);
+    }
+
     std::unique_ptr<RenderTexture> VulkanDevice::createTexture(const RenderTextureDesc &desc) {
         return std::make_unique<VulkanTexture>(this, nullptr, desc);
     }
 
+    std::unique_ptr<RenderBuffer> VulkanDevice::createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableFd(handle)) {
+            fprintf(stderr, "Unable to import buffer memory from an invalid file descriptor.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<VulkanBuffer>(this, desc, handleType, handle);
+    }
+
+    std::unique_ptr<RenderTexture> VulkanDevice::createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableFd(handle)) {
+            fprintf(stderr, "Unable to import texture memory from an invalid file descriptor.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<VulkanTexture>(this, desc, handleType, handle);
+    }
+
+    std::unique_ptr<RenderCommandSemaphore> VulkanDevice::createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) {
+        if (!isImportableFd(handle)) {
+            fprintf(stderr, "Unable to import semaphore from an invalid file descriptor.\n");
+            return nullptr;
+        }
+
+        return std::make_unique<VulkanCommandSemaphore>(this, handleType, handle);
+    }
+
     std::unique_ptr<RenderAccelerationStructure> VulkanDevice::createAccelerationStructure(const RenderAccelerationStructureDesc &desc) {
         return std::make_unique<VulkanAccelerationStructure>(this, desc);
     }
@@ -4195,8 +6244,8 @@ namespace plume {
         return std::make_unique<VulkanCommandFence>(this);
     }
 
-    std::unique_ptr<RenderCommandSemaphore> VulkanDevice::createCommandSemaphore() {
-        return std::make_unique<VulkanCommandSemaphore>(this);
+    std::unique_ptr<RenderCommandSemaphore> VulkanDevice::createCommandSemaphore(RenderExternalHandleType exportHandleType) {
+        return std::make_unique<VulkanCommandSemaphore>(this, exportHandleType);
     }
 
     std::unique_ptr<RenderFramebuffer> VulkanDevice::createFramebuffer(const RenderFramebufferDesc &desc) {
@@ -4212,7 +6261,8 @@ namespace plume {
         assert(meshCount > 0);
 
         uint32_t primitiveCount = 0;
-        thread_local std::vector<uint32_t> geometryPrimitiveCounts;
+        RenderScratchScope scratchScope;
+        RenderScratchArray<uint32_t> geometryPrimitiveCounts;
         geometryPrimitiveCounts.resize(meshCount);
 
         buildInfo.buildData.resize(sizeof(VkAccelerationStructureGeometryKHR) * meshCount);
@@ -4343,9 +6393,9 @@ namespace plume {
         assert((raytracingPipeline->descriptorSetCount <= descriptorSetCount) && "There must be enough descriptor sets available for the pipeline.");
 
         const uint32_t handleSize = rtPipelineProperties.shaderGroupHandleSize;
-        thread_local std::vector<uint8_t> groupHandles;
-        groupHandles.clear();
-        groupHandles.resize(raytracingPipeline->groupCount * handleSize, 0);
+        RenderScratchScope scratchScope;
+        RenderScratchArray<uint8_t> groupHandles;
+        groupHandles.resize(raytracingPipeline->groupCount * handleSize);
         VkResult res = vkGetRayTracingShaderGroupHandlesKHR(vk, raytracingPipeline->vk, 0, raytracingPipeline->groupCount, groupHandles.size(), groupHandles.data());
         if (res != VK_SUCCESS) {
             fprintf(stderr, "vkGetRayTracingShaderGroupHandlesKHR failed with error code 0x%X.\n", res);
@@ -4412,6 +6462,80 @@ namespace plume {
         }
     }
 
+    RenderFormatSupport VulkanDevice::getFormatSupport(RenderFormat format) const {
+        assert(uint32_t(format) < formatSupport.size());
+        if (format == RenderFormat::UNKNOWN) {
+            return RenderFormatSupport();
+        }
+
+        return formatSupport[uint32_t(format)];
+    }
+
+    VulkanDescriptorSetLayout *VulkanDevice::acquireDescriptorSetLayout(const RenderDescriptorSetDesc &desc) {
+        thread_local VulkanLayoutKey key;
+        VulkanDescriptorSetLayout::computeKey(desc, key);
+
+        const std::scoped_lock lock(layoutCacheMutex);
+        auto it = descriptorSetLayoutCache.find(key);
+        if (it != descriptorSetLayoutCache.end()) {
+            it->second->refCount++;
+            return it->second;
+        }
+
+        // Layouts that failed to be created are left out of the cache so the next request tries again. Their key stays empty.
+        VulkanDescriptorSetLayout *setLayout = new VulkanDescriptorSetLayout(this, desc);
+        if (setLayout->vk != VK_NULL_HANDLE) {
+            setLayout->cacheKey = key;
+            descriptorSetLayoutCache.emplace(key, setLayout);
+        }
+
+        setLayout->refCount++;
+        return setLayout;
+    }
+
+    void VulkanDevice::releaseDescriptorSetLayout(VulkanDescriptorSetLayout *setLayout) {
+        assert(setLayout != nullptr);
+
+        const std::scoped_lock lock(layoutCacheMutex);
+        assert(setLayout->refCount > 0);
+        setLayout->refCount--;
+        if (setLayout->refCount == 0) {
+            if (!setLayout->cacheKey.empty()) {
+                descriptorSetLayoutCache.erase(setLayout->cacheKey);
+            }
+
+            delete setLayout;
+        }
+    }
+
+    VkPipelineLayout VulkanDevice::acquirePipelineLayout(const VulkanLayoutKey &key, const VkPipelineLayoutCreateInfo &layoutInfo) {
+        const std::scoped_lock lock(layoutCacheMutex);
+        CachedPipelineLayout &cachedLayout = pipelineLayoutCache[key];
+        if (cachedLayout.vk == VK_NULL_HANDLE) {
+            VkResult res = vkCreatePipelineLayout(vk, &layoutInfo, nullptr, &cachedLayout.vk);
+            if (res != VK_SUCCESS) {
+                fprintf(stderr, "vkCreatePipelineLayout failed with error code 0x%X.\n", res);
+                pipelineLayoutCache.erase(key);
+                return VK_NULL_HANDLE;
+            }
+        }
+
+        cachedLayout.refCount++;
+        return cachedLayout.vk;
+    }
+
+    void VulkanDevice::releasePipelineLayout(const VulkanLayoutKey &key) {
+        const std::scoped_lock lock(layoutCacheMutex);
+        auto it = pipelineLayoutCache.find(key);
+        assert(it != pipelineLayoutCache.end());
+        assert(it->second.refCount > 0);
+        it->second.refCount--;
+        if (it->second.refCount == 0) {
+            vkDestroyPipelineLayout(vk, it->second.vk, nullptr);
+            pipelineLayoutCache.erase(it);
+        }
+    }
+
     void VulkanDevice::release() {
         if (allocator != VK_NULL_HANDLE) {
             vmaDestroyAllocator(allocator);
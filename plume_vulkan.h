@@ -9,6 +9,7 @@
 
 #include "plume_render_interface.h"
 
+#include <atomic>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -48,26 +49,33 @@ namespace plume {
     struct VulkanPool;
     struct VulkanQueue;
 
-    struct VulkanBuffer : RenderBuffer {
+    struct VulkanBuffer final : RenderBuffer {
         VkBuffer vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
         VulkanPool *pool = nullptr;
         VmaAllocation allocation = VK_NULL_HANDLE;
         VmaAllocationInfo allocationInfo = {};
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void *hostPointer = nullptr;
         RenderBufferDesc desc;
         RenderBarrierStages barrierStages = RenderBarrierStage::NONE;
+        RenderBufferAccessBits barrierAccess = RenderBufferAccess::NONE;
 
         VulkanBuffer() = default;
         VulkanBuffer(VulkanDevice *device, VulkanPool *pool, const RenderBufferDesc &desc);
+        VulkanBuffer(VulkanDevice *device, void *hostPointer, uint64_t size, RenderBufferFlags flags);
+        VulkanBuffer(VulkanDevice *device, const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~VulkanBuffer() override;
-        void *map(uint32_t subresource, const RenderRange *readRange) override;
-        void unmap(uint32_t subresource, const RenderRange *writtenRange) override;
+        void createExternal(RenderExternalHandleType handleType, int importFd);
+        void *map(uint32_t subresource = 0, const RenderRange *readRange = nullptr) override;
+        void unmap(uint32_t subresource = 0, const RenderRange *writtenRange = nullptr) override;
         std::unique_ptr<RenderBufferFormattedView> createBufferFormattedView(RenderFormat format) override;
         void setName(const std::string &name) override;
         uint64_t getDeviceAddress() const override;
+        RenderExternalHandle exportMemory() override;
     };
 
-    struct VulkanBufferFormattedView : RenderBufferFormattedView {
+    struct VulkanBufferFormattedView final : RenderBufferFormattedView {
         VkBufferView vk = VK_NULL_HANDLE;
         VulkanBuffer *buffer = nullptr;
 
@@ -75,7 +83,7 @@ namespace plume {
         ~VulkanBufferFormattedView() override;
     };
 
-    struct VulkanTexture : RenderTexture {
+    struct VulkanTexture final : RenderTexture {
         VkImage vk = VK_NULL_HANDLE;
         VkImageView imageView = VK_NULL_HANDLE;
         VkFormat imageFormat = VK_FORMAT_UNDEFINED;
@@ -84,6 +92,7 @@ namespace plume {
         VulkanPool *pool = nullptr;
         VmaAllocation allocation = VK_NULL_HANDLE;
         VmaAllocationInfo allocationInfo = {};
+        VkDeviceMemory memory = VK_NULL_HANDLE;
         RenderTextureLayout textureLayout = RenderTextureLayout::UNKNOWN;
         RenderBarrierStages barrierStages = RenderBarrierStage::NONE;
         bool ownership = false;
@@ -92,14 +101,17 @@ namespace plume {
         VulkanTexture() = default;
         VulkanTexture(VulkanDevice *device, VulkanPool *pool, const RenderTextureDesc &desc);
         VulkanTexture(VulkanDevice *device, VkImage image);
+        VulkanTexture(VulkanDevice *device, const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~VulkanTexture() override;
+        bool createExternal(const VkImageCreateInfo &imageInfo, RenderExternalHandleType handleType, int importFd);
         void createImageView(VkFormat format);
         std::unique_ptr<RenderTextureView> createTextureView(const RenderTextureViewDesc &desc) const override;
         void setName(const std::string &name) override;
+        RenderExternalHandle exportMemory() override;
         void fillSubresourceRange();
     };
 
-    struct VulkanTextureView : RenderTextureView {
+    struct VulkanTextureView final : RenderTextureView {
         VkImageView vk = VK_NULL_HANDLE;
         const VulkanTexture *texture = nullptr;
         RenderTextureViewDesc desc;
@@ -108,7 +120,7 @@ namespace plume {
         ~VulkanTextureView() override;
     };
 
-    struct VulkanAccelerationStructure : RenderAccelerationStructure {
+    struct VulkanAccelerationStructure final : RenderAccelerationStructure {
         VkAccelerationStructureKHR vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
         RenderAccelerationStructureType type = RenderAccelerationStructureType::UNKNOWN;
@@ -117,28 +129,42 @@ namespace plume {
         ~VulkanAccelerationStructure() override;
     };
 
+    // Key built out of every value of a layout description that affects the layout created from it.
+    typedef std::vector<uint64_t> VulkanLayoutKey;
+
+    struct VulkanLayoutKeyHash {
+        size_t operator()(const VulkanLayoutKey &key) const;
+    };
+
+    // Shared by every pipeline layout and descriptor set created from an identical description. Only created through the device's layout cache.
     struct VulkanDescriptorSetLayout {
         VkDescriptorSetLayout vk = VK_NULL_HANDLE;
         std::vector<VkDescriptorSetLayoutBinding> setBindings;
         std::vector<uint32_t> descriptorIndexBases;
         std::vector<uint32_t> descriptorBindingIndices;
         VulkanDevice *device = nullptr;
+        VulkanLayoutKey cacheKey;
+        uint32_t refCount = 0;
 
         VulkanDescriptorSetLayout(VulkanDevice *device, const RenderDescriptorSetDesc &descriptorSetDesc);
         ~VulkanDescriptorSetLayout();
+        static void computeKey(const RenderDescriptorSetDesc &descriptorSetDesc, VulkanLayoutKey &key);
     };
 
-    struct VulkanPipelineLayout : RenderPipelineLayout {
+    struct VulkanPipelineLayout final : RenderPipelineLayout {
+        // Shared by every pipeline layout created from an identical description.
         VkPipelineLayout vk = VK_NULL_HANDLE;
         std::vector<VkPushConstantRange> pushConstantRanges;
         std::vector<VulkanDescriptorSetLayout *> descriptorSetLayouts;
         VulkanDevice *device = nullptr;
+        VulkanLayoutKey cacheKey;
 
         VulkanPipelineLayout(VulkanDevice *device, const RenderPipelineLayoutDesc &desc);
         ~VulkanPipelineLayout() override;
+        bool isCompatibleForSet(const VulkanLayoutKey &otherKey, uint32_t setIndex) const;
     };
 
-    struct VulkanShader : RenderShader {
+    struct VulkanShader final : RenderShader {
         VkShaderModule vk = VK_NULL_HANDLE;
         std::string entryPointName;
         VulkanDevice *device = nullptr;
@@ -149,9 +175,20 @@ namespace plume {
         virtual void setName(const std::string &name) override;
     };
 
-    struct VulkanSampler : RenderSampler {
+    struct VulkanShaderObject final : RenderShaderObject {
+        VkShaderEXT vk = VK_NULL_HANDLE;
+        VkShaderStageFlagBits stage = VkShaderStageFlagBits(0);
+        VulkanDevice *device = nullptr;
+
+        VulkanShaderObject(VulkanDevice *device, VkShaderEXT vk, VkShaderStageFlagBits stage);
+        ~VulkanShaderObject() override;
+        virtual void setName(const std::string &name) override;
+    };
+
+    struct VulkanSampler final : RenderSampler {
         VkSampler vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
+        uint64_t id = 0;
 
         VulkanSampler(VulkanDevice *device, const RenderSamplerDesc &desc);
         ~VulkanSampler();
@@ -172,7 +209,7 @@ namespace plume {
         virtual ~VulkanPipeline() override;
     };
 
-    struct VulkanComputePipeline : VulkanPipeline {
+    struct VulkanComputePipeline final : VulkanPipeline {
         VkPipeline vk = VK_NULL_HANDLE;
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
 
@@ -182,18 +219,19 @@ namespace plume {
         RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct VulkanGraphicsPipeline : VulkanPipeline {
+    struct VulkanGraphicsPipeline final : VulkanPipeline {
         VkPipeline vk = VK_NULL_HANDLE;
         VkRenderPass renderPass = VK_NULL_HANDLE;
+        RenderDynamicStateFlags dynamicStates = RenderDynamicStateFlag::NONE;
 
         VulkanGraphicsPipeline(VulkanDevice *device, const RenderGraphicsPipelineDesc &desc);
         ~VulkanGraphicsPipeline() override;
         void setName(const std::string &name) override;
         RenderPipelineProgram getProgram(const std::string &name) const override;
-        static VkRenderPass createRenderPass(VulkanDevice *device, const VkFormat *renderTargetFormat, uint32_t renderTargetCount, VkFormat depthTargetFormat, VkSampleCountFlagBits sampleCount);
+        static VkRenderPass createRenderPass(VulkanDevice *device, const VkFormat *renderTargetFormat, uint32_t renderTargetCount, VkFormat depthTargetFormat, VkSampleCountFlagBits sampleCount, uint32_t viewMask);
     };
 
-    struct VulkanRaytracingPipeline : VulkanPipeline {
+    struct VulkanRaytracingPipeline final : VulkanPipeline {
         VkPipeline vk = VK_NULL_HANDLE;
         std::unordered_map<std::string, RenderPipelineProgram> nameProgramMap;
         uint32_t groupCount = 0;
@@ -205,7 +243,7 @@ namespace plume {
         RenderPipelineProgram getProgram(const std::string &name) const override;
     };
 
-    struct VulkanDescriptorSet : RenderDescriptorSet {
+    struct VulkanDescriptorSet final : RenderDescriptorSet {
         VkDescriptorSet vk = VK_NULL_HANDLE;
         VulkanDescriptorSetLayout *setLayout = nullptr;
         VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
@@ -213,15 +251,15 @@ namespace plume {
 
         VulkanDescriptorSet(VulkanDevice *device, const RenderDescriptorSetDesc &desc);
         ~VulkanDescriptorSet() override;
-        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize, const RenderBufferStructuredView *bufferStructuredView, const RenderBufferFormattedView *bufferFormattedView) override;
-        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView) override;
+        void setBuffer(uint32_t descriptorIndex, const RenderBuffer *buffer, uint64_t bufferSize = 0, const RenderBufferStructuredView *bufferStructuredView = nullptr, const RenderBufferFormattedView *bufferFormattedView = nullptr) override;
+        void setTexture(uint32_t descriptorIndex, const RenderTexture *texture, RenderTextureLayout textureLayout, const RenderTextureView *textureView = nullptr) override;
         void setSampler(uint32_t descriptorIndex, const RenderSampler *sampler) override;
         void setAccelerationStructure(uint32_t descriptorIndex, const RenderAccelerationStructure *accelerationStructure) override;
         void setDescriptor(uint32_t descriptorIndex, const VkDescriptorBufferInfo *bufferInfo, const VkDescriptorImageInfo *imageInfo, const VkBufferView *texelBufferView, void *pNext);
-        static VkDescriptorPool createDescriptorPool(VulkanDevice *device, const std::unordered_map<VkDescriptorType, uint32_t> &typeCounts, bool lastRangeIsBoundless);
+        static VkDescriptorPool createDescriptorPool(VulkanDevice *device, const VkDescriptorPoolSize *poolSizes, uint32_t poolSizesCount, bool lastRangeIsBoundless);
     };
 
-    struct VulkanSwapChain : RenderSwapChain {
+    struct VulkanSwapChain final : RenderSwapChain {
         VkSwapchainKHR vk = VK_NULL_HANDLE;
         VulkanCommandQueue *commandQueue = nullptr;
         VkSurfaceKHR surface = VK_NULL_HANDLE;
@@ -265,25 +303,34 @@ namespace plume {
         void releaseImageViews();
     };
 
-    struct VulkanFramebuffer : RenderFramebuffer {
+    struct VulkanFramebuffer final : RenderFramebuffer {
         VulkanDevice *device = nullptr;
         VkFramebuffer vk = VK_NULL_HANDLE;
         VkRenderPass renderPass = VK_NULL_HANDLE;
         std::vector<const VulkanTexture *> colorAttachments;
         const VulkanTexture *depthAttachment = nullptr;
         std::unique_ptr<VulkanTextureView> depthAttachmentView = nullptr;
+        std::vector<VkImageView> sliceImageViews;
         bool depthAttachmentReadOnly = false;
         uint32_t width = 0;
         uint32_t height = 0;
+        uint32_t layerCount = 1;
+        uint32_t viewMask = 0;
+
+        // Attachments used to begin dynamic rendering instead of the render pass when drawing with shader objects.
+        std::vector<VkRenderingAttachmentInfoKHR> colorRenderingAttachments;
+        VkRenderingAttachmentInfoKHR depthRenderingAttachment = {};
+        bool depthRenderingStencil = false;
 
         VulkanFramebuffer(VulkanDevice *device, const RenderFramebufferDesc &desc);
         ~VulkanFramebuffer() override;
         uint32_t getWidth() const override;
         uint32_t getHeight() const override;
         bool contains(const VulkanTexture *attachment) const;
+        VkImageView createSliceImageView(const VulkanTexture *texture, RenderFormat format, uint32_t mipSlice, uint32_t layerCount);
     };
 
-    struct VulkanQueryPool : RenderQueryPool {
+    struct VulkanQueryPool final : RenderQueryPool {
         VulkanDevice *device = nullptr;
         std::vector<uint64_t> results;
         VkQueryPool vk = VK_NULL_HANDLE;
@@ -295,25 +342,85 @@ namespace plume {
         virtual uint32_t getCount() const override;
     };
 
-    struct VulkanCommandList : RenderCommandList {
+    struct VulkanCommandList final : RenderCommandList {
+        using RenderCommandList::barriers;
+        using RenderCommandList::setViewports;
+        using RenderCommandList::setScissors;
+
         VkCommandBuffer vk = VK_NULL_HANDLE;
         VkCommandPool commandPool = VK_NULL_HANDLE;
         VulkanCommandQueue *queue = nullptr;
+        RenderCommandListDesc desc;
         const VulkanFramebuffer *targetFramebuffer = nullptr;
         const VulkanPipelineLayout *activeComputePipelineLayout = nullptr;
         const VulkanPipelineLayout *activeGraphicsPipelineLayout = nullptr;
         const VulkanPipelineLayout *activeRaytracingPipelineLayout = nullptr;
         VkRenderPass activeRenderPass = VK_NULL_HANDLE;
+        bool activeDynamicRendering = false;
+        bool graphicsShaderObjectsBound = false;
+
+        // Descriptor sets bound for each bind point (graphics, compute and raytracing) and the key of the layout used by the last bind.
+        // Every set still tracked is compatible with that layout, so binding the same set again is skipped when the new layout is too.
+        // The key is copied so the layout object can be destroyed while the command list is recording.
+        static constexpr uint32_t MaxCachedDescriptorSets = 8;
+        VkDescriptorSet boundDescriptorSets[3][MaxCachedDescriptorSets] = {};
+        VulkanLayoutKey boundLayoutKeys[3];
+
+        // Last values set for each dynamic state. Only the states in the valid mask are known to be current.
+        struct {
+            RenderDynamicStateFlags validStates = RenderDynamicStateFlag::NONE;
+            RenderCullMode cullMode = RenderCullMode::NONE;
+            RenderFrontFace frontFace = RenderFrontFace::CLOCKWISE;
+            RenderPrimitiveTopology primitiveTopology = RenderPrimitiveTopology::UNKNOWN;
+            bool depthEnabled = false;
+            bool depthWriteEnabled = false;
+            RenderComparisonFunction depthFunction = RenderComparisonFunction::NEVER;
+            bool stencilEnabled = false;
+            RenderStencilFaceDesc stencilFrontFace;
+            RenderStencilFaceDesc stencilBackFace;
+            uint32_t stencilReference = 0;
+            bool depthBiasEnabled = false;
+            bool depthClipEnabled = false;
+            std::vector<VkVertexInputBindingDescription2EXT> vertexBindings;
+            std::vector<VkVertexInputAttributeDescription2EXT> vertexAttributes;
+        } dynamicStateCache;
+
+        // Split barriers begun during the recording. Their events are kept for the next recordings, as the end of each split resets its event.
+        // With synchronization2 the whole dependency is given to the event when it's set, so the transitions can run before the split ends.
+        // Without it only the execution dependency is split, and the layout transitions and cache operations still happen when it ends.
+        struct SplitBarrier {
+            VkEvent event = VK_NULL_HANDLE;
+            VkPipelineStageFlags srcStageMask = 0;
+            VkPipelineStageFlags dstStageMask = 0;
+            std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers;
+            std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
+            bool active = false;
+        };
 
-        VulkanCommandList(VulkanCommandQueue *queue);
+        std::vector<SplitBarrier> splitBarriers;
+        uint32_t splitBarrierCount = 0;
+
+        // Barriers queued since the last command that depends on them. They're merged per resource and issued together by flushBarriers().
+        struct {
+            VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers;
+            std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
+        } pendingBarriers;
+
+        VulkanCommandList(VulkanCommandQueue *queue, const RenderCommandListDesc &desc);
         ~VulkanCommandList() override;
         void begin() override;
         void end() override;
         void barriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        uint32_t beginSplitBarriers(RenderBarrierStages stages, const RenderBufferBarrier *bufferBarriers, uint32_t bufferBarriersCount, const RenderTextureBarrier *textureBarriers, uint32_t textureBarriersCount) override;
+        void endSplitBarriers(uint32_t splitIndex) override;
         void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) override;
         void traceRays(uint32_t width, uint32_t height, uint32_t depth, RenderBufferReference shaderBindingTable, const RenderShaderBindingGroupsInfo &shaderBindingGroupsInfo) override;
         void drawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) override;
         void drawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+        void drawMeshTasks(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void drawMeshTasksIndirect(RenderBufferReference argumentBuffer, uint32_t drawCount = 1, uint32_t stride = 12) override;
         void setPipeline(const RenderPipeline *pipeline) override;
         void setComputePipelineLayout(const RenderPipelineLayout *pipelineLayout) override;
         void setComputePushConstants(uint32_t rangeIndex, const void *data, uint32_t offset = 0, uint32_t size = 0) override;
@@ -331,25 +438,44 @@ namespace plume {
         void setScissors(const RenderRect *scissorRects, uint32_t count) override;
         void setFramebuffer(const RenderFramebuffer *framebuffer) override;
         void setDepthBias(float depthBias, float depthBiasClamp, float slopeScaledDepthBias) override;
-        void clearColor(uint32_t attachmentIndex, RenderColor colorValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
-        void clearDepthStencil(bool clearDepth, bool clearStencil, float depthValue, uint32_t stencilValue, const RenderRect *clearRects, uint32_t clearRectsCount) override;
+        void setCullMode(RenderCullMode cullMode) override;
+        void setFrontFace(RenderFrontFace frontFace) override;
+        void setPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) override;
+        void setDepthEnabled(bool depthEnabled) override;
+        void setDepthWriteEnabled(bool depthWriteEnabled) override;
+        void setDepthFunction(RenderComparisonFunction depthFunction) override;
+        void setStencilEnabled(bool stencilEnabled) override;
+        void setStencilFaces(const RenderStencilFaceDesc &stencilFrontFace, const RenderStencilFaceDesc &stencilBackFace) override;
+        void setStencilReference(uint32_t stencilReference) override;
+        void setDepthBiasEnabled(bool depthBiasEnabled) override;
+        void setDepthClipEnabled(bool depthClipEnabled) override;
+        bool setVertexInput(const RenderInputSlot *inputSlots, uint32_t inputSlotsCount, const RenderInputElement *inputElements, uint32_t inputElementsCount) override;
+        void setGraphicsShaderObjects(const RenderShaderObject *vertexShader, const RenderShaderObject *geometryShader, const RenderShaderObject *pixelShader) override;
+        void setComputeShaderObject(const RenderShaderObject *computeShader) override;
+        void setShaderObjectState(const RenderGraphicsPipelineDesc &desc) override;
+        void clearColor(uint32_t attachmentIndex = 0, RenderColor colorValue = RenderColor(), const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
+        void clearDepthStencil(bool clearDepth = true, bool clearStencil = true, float depthValue = 1.0f, uint32_t stencilValue = 0, const RenderRect *clearRects = nullptr, uint32_t clearRectsCount = 0) override;
         void copyBufferRegion(RenderBufferReference dstBuffer, RenderBufferReference srcBuffer, uint64_t size) override;
-        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX, uint32_t dstY, uint32_t dstZ, const RenderBox *srcBox) override;
+        void copyTextureRegion(const RenderTextureCopyLocation &dstLocation, const RenderTextureCopyLocation &srcLocation, uint32_t dstX = 0, uint32_t dstY = 0, uint32_t dstZ = 0, const RenderBox *srcBox = nullptr) override;
         void copyBuffer(const RenderBuffer *dstBuffer, const RenderBuffer *srcBuffer) override;
         void copyTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
         void resolveTexture(const RenderTexture *dstTexture, const RenderTexture *srcTexture) override;
-        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect, RenderResolveMode resolveMode) override;
+        void resolveTextureRegion(const RenderTexture *dstTexture, uint32_t dstX, uint32_t dstY, const RenderTexture *srcTexture, const RenderRect *srcRect = nullptr, RenderResolveMode resolveMode = RenderResolveMode::AVERAGE) override;
         void buildBottomLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, const RenderBottomLevelASBuildInfo &buildInfo) override;
         void buildTopLevelAS(const RenderAccelerationStructure *dstAccelerationStructure, RenderBufferReference scratchBuffer, RenderBufferReference instancesBuffer, const RenderTopLevelASBuildInfo &buildInfo) override;
         void discardTexture(const RenderTexture* texture) override;
         void resetQueryPool(const RenderQueryPool *queryPool, uint32_t queryFirstIndex, uint32_t queryCount) override;
         void writeTimestamp(const RenderQueryPool *queryPool, uint32_t queryIndex) override;
+        bool isDynamicStateSupported(RenderDynamicStateFlags state) const;
         void checkActiveRenderPass();
         void endActiveRenderPass();
+        void flushBarriers();
         void setDescriptorSet(VkPipelineBindPoint bindPoint, const VulkanPipelineLayout *pipelineLayout, const RenderDescriptorSet *descriptorSet, uint32_t setIndex);
+        VkBufferMemoryBarrier prepareBufferBarrier(RenderBarrierStages stages, const RenderBufferBarrier &bufferBarrier, VkPipelineStageFlags &srcStageMask);
+        VkImageMemoryBarrier prepareTextureBarrier(RenderBarrierStages stages, const RenderTextureBarrier &textureBarrier, VkPipelineStageFlags &srcStageMask);
     };
 
-    struct VulkanCommandFence : RenderCommandFence {
+    struct VulkanCommandFence final : RenderCommandFence {
         VkFence vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
 
@@ -357,15 +483,21 @@ namespace plume {
         ~VulkanCommandFence() override;
     };
 
-    struct VulkanCommandSemaphore : RenderCommandSemaphore {
+    struct VulkanCommandSemaphore final : RenderCommandSemaphore {
         VkSemaphore vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
+        RenderExternalHandleType exportHandleType = RenderExternalHandleType::NONE;
 
-        VulkanCommandSemaphore(VulkanDevice *device);
+        VulkanCommandSemaphore(VulkanDevice *device, RenderExternalHandleType exportHandleType);
+        VulkanCommandSemaphore(VulkanDevice *device, RenderExternalHandleType handleType, RenderExternalHandle handle);
         ~VulkanCommandSemaphore() override;
+        RenderExternalHandle exportHandle() override;
     };
 
-    struct VulkanCommandQueue : RenderCommandQueue {
+    struct VulkanCommandQueue final : RenderCommandQueue {
+        using RenderCommandQueue::createCommandList;
+        using RenderCommandQueue::executeCommandLists;
+
         VulkanQueue *queue = nullptr;
         VulkanDevice *device = nullptr;
         uint32_t familyIndex = 0;
@@ -375,13 +507,13 @@ namespace plume {
 
         VulkanCommandQueue(VulkanDevice *device, RenderCommandListType type);
         ~VulkanCommandQueue() override;
-        std::unique_ptr<RenderCommandList> createCommandList() override;
+        std::unique_ptr<RenderCommandList> createCommandList(const RenderCommandListDesc &desc) override;
         std::unique_ptr<RenderSwapChain> createSwapChain(RenderWindow renderWindow, uint32_t bufferCount, RenderFormat format, uint32_t maxFrameLatency) override;
-        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores, uint32_t waitSemaphoreCount, RenderCommandSemaphore **signalSemaphores, uint32_t signalSemaphoreCount, RenderCommandFence *signalFence) override;
+        void executeCommandLists(const RenderCommandList **commandLists, uint32_t commandListCount, RenderCommandSemaphore **waitSemaphores = nullptr, uint32_t waitSemaphoreCount = 0, RenderCommandSemaphore **signalSemaphores = nullptr, uint32_t signalSemaphoreCount = 0, RenderCommandFence *signalFence = nullptr) override;
         void waitForCommandFence(RenderCommandFence *fence) override;
     };
 
-    struct VulkanPool : RenderPool {
+    struct VulkanPool final : RenderPool {
         VmaPool vk = VK_NULL_HANDLE;
         VulkanDevice *device = nullptr;
 
@@ -404,11 +536,15 @@ namespace plume {
         void remove(VulkanCommandQueue *virtualQueue);
     };
 
-    struct VulkanDevice : RenderDevice {
+    struct VulkanDevice final : RenderDevice {
+        using RenderDevice::createBufferFromHostMemory;
+        using RenderDevice::createCommandSemaphore;
+
         VkDevice vk = VK_NULL_HANDLE;
         VulkanInterface *renderInterface = nullptr;
         VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
         VkPhysicalDeviceProperties physicalDeviceProperties = {};
+        VkPhysicalDeviceFeatures enabledFeatures = {};
         VmaAllocator allocator = VK_NULL_HANDLE;
         uint32_t queueFamilyIndices[3] = {};
         std::vector<VulkanQueueFamily> queueFamilies;
@@ -416,41 +552,66 @@ namespace plume {
         RenderDeviceDescription description;
         VkPhysicalDeviceRayTracingPipelinePropertiesKHR rtPipelineProperties = {};
         VkPhysicalDeviceSampleLocationsPropertiesEXT sampleLocationProperties = {};
+        std::vector<RenderFormatSupport> formatSupport;
         std::unique_ptr<RenderBuffer> nullBuffer;
         bool loadStoreOpNoneSupported = false;
         bool nullDescriptorSupported = false;
+        bool synchronization2Supported = false;
+
+        // Layouts are hash-consed so identical descriptions share the same handles and stay compatible across pipelines.
+        struct CachedPipelineLayout {
+            VkPipelineLayout vk = VK_NULL_HANDLE;
+            uint32_t refCount = 0;
+        };
+
+        std::mutex layoutCacheMutex;
+        std::unordered_map<VulkanLayoutKey, VulkanDescriptorSetLayout *, VulkanLayoutKeyHash> descriptorSetLayoutCache;
+        std::unordered_map<VulkanLayoutKey, CachedPipelineLayout, VulkanLayoutKeyHash> pipelineLayoutCache;
+
+        // Identifies immutable samplers in layout keys. Never reused, unlike the address of a destroyed sampler.
+        std::atomic<uint64_t> samplerIdCounter = 0;
 
         VulkanDevice(VulkanInterface *renderInterface, const std::string &preferredDeviceName);
         ~VulkanDevice() override;
         std::unique_ptr<RenderDescriptorSet> createDescriptorSet(const RenderDescriptorSetDesc &desc) override;
         std::unique_ptr<RenderShader> createShader(const void *data, uint64_t size, const char *entryPointName, RenderShaderFormat format) override;
+        std::vector<std::unique_ptr<RenderShaderObject>> createShaderObjects(const RenderShaderObjectDesc *descs, uint32_t descsCount, bool linked = false) override;
         std::unique_ptr<RenderSampler> createSampler(const RenderSamplerDesc &desc) override;
         std::unique_ptr<RenderPipeline> createComputePipeline(const RenderComputePipelineDesc &desc) override;
         std::unique_ptr<RenderPipeline> createGraphicsPipeline(const RenderGraphicsPipelineDesc &desc) override;
-        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline) override;
+        std::unique_ptr<RenderPipeline> createRaytracingPipeline(const RenderRaytracingPipelineDesc &desc, const RenderPipeline *previousPipeline = nullptr) override;
         std::unique_ptr<RenderCommandQueue> createCommandQueue(RenderCommandListType type) override;
         std::unique_ptr<RenderBuffer> createBuffer(const RenderBufferDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromHostMemory(void *hostPointer, uint64_t size, RenderBufferFlags flags) override;
         std::unique_ptr<RenderTexture> createTexture(const RenderTextureDesc &desc) override;
+        std::unique_ptr<RenderBuffer> createBufferFromExternalMemory(const RenderBufferDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderTexture> createTextureFromExternalMemory(const RenderTextureDesc &desc, RenderExternalHandleType handleType, RenderExternalHandle handle) override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphoreFromExternalHandle(RenderExternalHandleType handleType, RenderExternalHandle handle) override;
         std::unique_ptr<RenderAccelerationStructure> createAccelerationStructure(const RenderAccelerationStructureDesc &desc) override;
         std::unique_ptr<RenderPool> createPool(const RenderPoolDesc &desc) override;
         std::unique_ptr<RenderPipelineLayout> createPipelineLayout(const RenderPipelineLayoutDesc &desc) override;
         std::unique_ptr<RenderCommandFence> createCommandFence() override;
-        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore() override;
+        std::unique_ptr<RenderCommandSemaphore> createCommandSemaphore(RenderExternalHandleType exportHandleType) override;
         std::unique_ptr<RenderFramebuffer> createFramebuffer(const RenderFramebufferDesc &desc) override;
         std::unique_ptr<RenderQueryPool> createQueryPool(uint32_t queryCount) override;
-        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild, bool preferFastTrace) override;
-        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild, bool preferFastTrace) override;
+        void setBottomLevelASBuildInfo(RenderBottomLevelASBuildInfo &buildInfo, const RenderBottomLevelASMesh *meshes, uint32_t meshCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
+        void setTopLevelASBuildInfo(RenderTopLevelASBuildInfo &buildInfo, const RenderTopLevelASInstance *instances, uint32_t instanceCount, bool preferFastBuild = true, bool preferFastTrace = false) override;
         void setShaderBindingTableInfo(RenderShaderBindingTableInfo &tableInfo, const RenderShaderBindingGroups &groups, const RenderPipeline *pipeline, RenderDescriptorSet **descriptorSets, uint32_t descriptorSetCount) override;
         const RenderDeviceCapabilities &getCapabilities() const override;
         const RenderDeviceDescription &getDescription() const override;
         RenderSampleCounts getSampleCountsSupported(RenderFormat format) const override;
+        RenderFormatSupport getFormatSupport(RenderFormat format) const override;
+        VulkanDescriptorSetLayout *acquireDescriptorSetLayout(const RenderDescriptorSetDesc &desc);
+        void releaseDescriptorSetLayout(VulkanDescriptorSetLayout *setLayout);
+        VkPipelineLayout acquirePipelineLayout(const VulkanLayoutKey &key, const VkPipelineLayoutCreateInfo &layoutInfo);
+        void releasePipelineLayout(const VulkanLayoutKey &key);
         void release();
         bool isValid() const;
         bool beginCapture() override;
         bool endCapture() override;
     };
 
-    struct VulkanInterface : RenderInterface {
+    struct VulkanInterface final : RenderInterface {
         VkInstance instance = VK_NULL_HANDLE;
         VkApplicationInfo appInfo = {};
         RenderInterfaceCapabilities capabilities;
@@ -463,9 +624,27 @@ namespace plume {
 #   endif
 
         ~VulkanInterface() override;
-        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName) override;
+        std::unique_ptr<RenderDevice> createDevice(const std::string &preferredDeviceName = "") override;
         const RenderInterfaceCapabilities &getCapabilities() const override;
         const std::vector<std::string> &getDeviceNames() const override;
         bool isValid() const;
     };
+
+#if defined(PLUME_SINGLE_BACKEND_VULKAN)
+    // Only this backend is built, so applications can cast to the final types below to let the compiler resolve and inline the calls.
+    typedef VulkanBuffer RenderBackendBuffer;
+    typedef VulkanDescriptorSet RenderBackendDescriptorSet;
+    typedef VulkanSwapChain RenderBackendSwapChain;
+    typedef VulkanFramebuffer RenderBackendFramebuffer;
+    typedef VulkanQueryPool RenderBackendQueryPool;
+    typedef VulkanCommandList RenderBackendCommandList;
+    typedef VulkanCommandFence RenderBackendCommandFence;
+    typedef VulkanCommandSemaphore RenderBackendCommandSemaphore;
+    typedef VulkanCommandQueue RenderBackendCommandQueue;
+    typedef VulkanPool RenderBackendPool;
+    typedef VulkanPipelineLayout RenderBackendPipelineLayout;
+    typedef VulkanSampler RenderBackendSampler;
+    typedef VulkanDevice RenderBackendDevice;
+    typedef VulkanInterface RenderBackendInterface;
+#endif
 };